@@ -0,0 +1,390 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelAccumulator.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelAccumulator.h"
+
+#include "vtkCollection.h"
+#include "vtkFrameBufferObject.h"
+#include "vtkMultiChannelRenderTargetPool.h"
+#include "vtkMultiChannelSceneMonitor.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGL.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowChannel.h"
+#include "vtkRendererCollection.h"
+#include "vtkTextureObject.h"
+
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelAccumulator, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelAccumulator);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelAccumulatorInternals
+{
+public:
+  // Average of the frames of each channel, RGBA, and the size of the
+  // region it holds
+  struct Average
+  {
+    Average() : Target(0) { this->Size[0] = this->Size[1] = 0; }
+
+    vtkTextureObject* Target;
+    int Size[2];
+  };
+
+  std::vector<Average> Averages;
+
+  vtkFrameBufferObject* FrameBuffer;
+
+  void ReleaseAverages(vtkMultiChannelRenderTargetPool* pool, unsigned int first)
+    {
+    for (unsigned int i = first; i < this->Averages.size(); i++)
+      {
+      if (this->Averages[i].Target)
+        {
+        pool->Release(this->Averages[i].Target);
+        }
+      }
+    this->Averages.resize(first);
+    }
+
+  // Draw the given part of a target over the viewport, texel for pixel
+  static void DrawTarget(vtkTextureObject* target, int width, int height)
+    {
+    double s = static_cast<double>(width) / target->GetWidth();
+    double t = static_cast<double>(height) / target->GetHeight();
+
+    glBindTexture(GL_TEXTURE_2D, target->GetHandle());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glBegin(GL_QUADS);
+    glTexCoord2d(0, 0);
+    glVertex2d(-1, -1);
+    glTexCoord2d(s, 0);
+    glVertex2d(1, -1);
+    glTexCoord2d(s, t);
+    glVertex2d(1, 1);
+    glTexCoord2d(0, t);
+    glVertex2d(-1, 1);
+    glEnd();
+    }
+
+  // Radical inverse of index in the given base, in [0,1)
+  static double Halton(int index, int base)
+    {
+    double result = 0.0;
+    double f = 1.0 / base;
+    for (int i = index; i > 0; i /= base)
+      {
+      result += f * (i % base);
+      f /= base;
+      }
+    return result;
+    }
+
+  static void SetJitter(vtkCollection* channels, double x, double y)
+    {
+    for (int i = 0; i < channels->GetNumberOfItems(); i++)
+      {
+      vtkRenderWindowChannel* channel = vtkRenderWindowChannel::SafeDownCast(channels->GetItemAsObject(i));
+      channel->SetJitter(x, y);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelAccumulator::vtkMultiChannelAccumulator()
+{
+  this->Enabled = 1;
+  this->MaximumNumberOfFrames = 64;
+
+  this->SceneMonitor = vtkMultiChannelSceneMonitor::New();
+  this->RenderTargetPool = NULL;
+
+  this->Accumulating = 0;
+  this->Suspended = 0;
+  this->NumberOfAccumulatedFrames = 0;
+
+  this->Internals = new vtkMultiChannelAccumulatorInternals;
+  this->Internals->FrameBuffer = vtkFrameBufferObject::New();
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelAccumulator::~vtkMultiChannelAccumulator()
+{
+  this->SceneMonitor->Delete();
+  this->SetRenderTargetPool(NULL);
+
+  this->Internals->FrameBuffer->Delete();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelAccumulator::SetRenderTargetPool(vtkMultiChannelRenderTargetPool* pool)
+{
+  if (this->RenderTargetPool == pool)
+    {
+    return;
+    }
+
+  if (this->RenderTargetPool)
+    {
+    this->Internals->ReleaseAverages(this->RenderTargetPool, 0);
+    this->RenderTargetPool->UnRegister(this);
+    }
+
+  this->RenderTargetPool = pool;
+  if (this->RenderTargetPool)
+    {
+    this->RenderTargetPool->Register(this);
+    }
+
+  this->NumberOfAccumulatedFrames = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelAccumulator::BeginFrame(vtkRendererCollection* renderers, vtkCollection* channels)
+{
+  int changed = this->SceneMonitor->Update(renderers, channels);
+  if (changed)
+    {
+    this->Suspended = 0;
+    }
+
+  // Released sums are not taken up again until the scene changes
+  if (!this->Enabled || changed || this->Suspended)
+    {
+    if (this->Accumulating)
+      {
+      vtkMultiChannelAccumulatorInternals::SetJitter(channels, 0.0, 0.0);
+      }
+    this->Accumulating = 0;
+    this->NumberOfAccumulatedFrames = 0;
+
+    return 1;
+    }
+
+  this->Accumulating = 1;
+
+  // Hold the average
+  if (this->NumberOfAccumulatedFrames >= this->MaximumNumberOfFrames)
+    {
+    return 0;
+    }
+
+  // The first frame is not shifted, so the view does not jump when the
+  // camera stops
+  int sample = this->NumberOfAccumulatedFrames;
+  double x = sample ? vtkMultiChannelAccumulatorInternals::Halton(sample, 2) - 0.5 : 0.0;
+  double y = sample ? vtkMultiChannelAccumulatorInternals::Halton(sample, 3) - 0.5 : 0.0;
+  vtkMultiChannelAccumulatorInternals::SetJitter(channels, x, y);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelAccumulator::EndFrame(vtkRenderWindow* window, vtkCollection* channels)
+{
+  if (!this->Accumulating || !window)
+    {
+    return;
+    }
+
+  vtkMultiChannelRenderTargetPool* pool = this->RenderTargetPool;
+  if (!pool)
+    {
+    vtkErrorMacro(<< "No render target pool set.");
+    return;
+    }
+
+  if (!vtkFrameBufferObject::IsSupported(window))
+    {
+    vtkErrorMacro(<< "Frame buffer objects are not supported.  Turning accumulation off.");
+    this->EnabledOff();
+    return;
+    }
+
+  vtkMultiChannelAccumulatorInternals* internals = this->Internals;
+
+  int holding = this->NumberOfAccumulatedFrames >= this->MaximumNumberOfFrames;
+
+  // Each frame is blended into the average with its share of it,
+  // average = frame / n + average * (1 - 1 / n)
+  float weight = 1.0f / (this->NumberOfAccumulatedFrames + 1);
+
+  int* size = window->GetSize();
+  int numberOfChannels = channels->GetNumberOfItems();
+  if (static_cast<int>(internals->Averages.size()) > numberOfChannels)
+    {
+    internals->ReleaseAverages(pool, numberOfChannels);
+    }
+  internals->Averages.resize(numberOfChannels);
+
+  internals->FrameBuffer->SetContext(window);
+  internals->FrameBuffer->SetDepthBufferNeeded(false);
+
+  glPushAttrib(GL_ALL_ATTRIB_BITS);
+  glMatrixMode(GL_PROJECTION);
+  glPushMatrix();
+  glLoadIdentity();
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glLoadIdentity();
+
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_LIGHTING);
+  glDisable(GL_ALPHA_TEST);
+  glDisable(GL_SCISSOR_TEST);
+  glEnable(GL_TEXTURE_2D);
+  glReadBuffer(GL_BACK);
+
+  for (int i = 0; i < numberOfChannels; i++)
+    {
+    vtkRenderWindowChannel* channel = vtkRenderWindowChannel::SafeDownCast(channels->GetItemAsObject(i));
+
+    int region[4];
+    channel->GetPixelRegion(size, region);
+    if (region[2] <= 0 || region[3] <= 0)
+      {
+      continue;
+      }
+
+    vtkMultiChannelAccumulatorInternals::Average& average = internals->Averages[i];
+    int resized = average.Size[0] != region[2] || average.Size[1] != region[3];
+
+    if (!holding)
+      {
+      if (!average.Target || resized)
+        {
+        if (average.Target)
+          {
+          pool->Release(average.Target);
+          }
+        average.Target = pool->AcquireFloatColorTarget(region[2], region[3]);
+        average.Size[0] = region[2];
+        average.Size[1] = region[3];
+        if (!average.Target)
+          {
+          vtkErrorMacro(<< "Floating point targets are not supported.  Turning accumulation off.");
+          this->EnabledOff();
+          break;
+          }
+        }
+
+      vtkTextureObject* frame = pool->AcquireColorTarget(region[2], region[3], 3);
+      if (!frame)
+        {
+        continue;
+        }
+
+      glBindTexture(GL_TEXTURE_2D, frame->GetHandle());
+      glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, region[0], region[1], region[2], region[3]);
+
+      internals->FrameBuffer->SetColorBuffer(0, average.Target);
+      internals->FrameBuffer->StartNonOrtho(average.Target->GetWidth(), average.Target->GetHeight(), false);
+      glViewport(0, 0, region[2], region[3]);
+
+      // The first frame replaces what the target held before
+      if (this->NumberOfAccumulatedFrames == 0 || resized)
+        {
+        glDisable(GL_BLEND);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+        }
+      else
+        {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glColor4f(weight, weight, weight, weight);
+        }
+      vtkMultiChannelAccumulatorInternals::DrawTarget(frame, region[2], region[3]);
+
+      internals->FrameBuffer->UnBind();
+      pool->Release(frame);
+      }
+    else if (!average.Target || resized)
+      {
+      continue;
+      }
+
+    // Show the average in place of the frame
+    glViewport(region[0], region[1], region[2], region[3]);
+    glDisable(GL_BLEND);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    vtkMultiChannelAccumulatorInternals::DrawTarget(average.Target, region[2], region[3]);
+    }
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glMatrixMode(GL_PROJECTION);
+  glPopMatrix();
+  glMatrixMode(GL_MODELVIEW);
+  glPopMatrix();
+  glPopAttrib();
+
+  if (!holding && this->Enabled)
+    {
+    this->NumberOfAccumulatedFrames++;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelAccumulator::Reset()
+{
+  this->SceneMonitor->Reset();
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelAccumulator::GetChannelMemory(int i)
+{
+  if (i < 0 || i >= static_cast<int>(this->Internals->Averages.size()) ||
+      !this->Internals->Averages[i].Target)
+    {
+    return 0;
+    }
+
+  // Four float components
+  vtkTextureObject* target = this->Internals->Averages[i].Target;
+  return 16.0 * target->GetWidth() * target->GetHeight();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelAccumulator::ReleaseMemory()
+{
+  if (this->RenderTargetPool)
+    {
+    this->Internals->ReleaseAverages(this->RenderTargetPool, 0);
+    }
+
+  this->Suspended = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelAccumulator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Enabled: " << this->Enabled << "\n";
+  os << indent << "Maximum Number Of Frames: " << this->MaximumNumberOfFrames << "\n";
+  os << indent << "Number Of Accumulated Frames: " << this->NumberOfAccumulatedFrames << "\n";
+  os << indent << "Suspended: " << this->Suspended << "\n";
+  os << indent << "Render Target Pool: " << this->RenderTargetPool << "\n";
+  os << indent << "Scene Monitor:\n";
+  this->SceneMonitor->PrintSelf(os,indent.GetNextIndent());
+}
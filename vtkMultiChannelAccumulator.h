@@ -0,0 +1,134 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelAccumulator.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelAccumulator
+// .SECTION Description
+// vtkMultiChannelAccumulator antialiases still views progressively.
+// While its vtkMultiChannelSceneMonitor sees no change, each frame
+// renders every channel shifted by a different fraction of a pixel.  The
+// frames are averaged on the graphics card in a floating point target
+// per channel, taken from the helper's vtkMultiChannelRenderTargetPool,
+// and the average is shown instead of the frame.  Once
+// MaximumNumberOfFrames frames are averaged, the channels are no longer
+// rendered and the average is shown as is.  Any change starts over with
+// the next frame, which is rendered as usual, so interaction costs
+// nothing extra.  Accumulation turns itself off if frame buffer objects
+// or floating point textures are not supported.
+//
+// ReleaseMemory() returns the averages to the pool and suspends
+// accumulation until the scene next changes, so that a still scene is
+// then rendered as usual rather than accumulated again.
+//
+// Set on a vtkMultiChannelRenderWindowHelper, which sets its pool and
+// calls BeginFrame() before rendering the channels and EndFrame() after.
+
+// .SECTION see also
+// vtkMultiChannelSceneMonitor vtkMultiChannelRenderWindowHelper
+// vtkMultiChannelRenderTargetPool vtkRenderWindowChannel
+
+#ifndef __vtkMultiChannelAccumulator_h
+#define __vtkMultiChannelAccumulator_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkCollection;
+class vtkMultiChannelAccumulatorInternals;
+class vtkMultiChannelRenderTargetPool;
+class vtkMultiChannelSceneMonitor;
+class vtkRenderWindow;
+class vtkRendererCollection;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelAccumulator : public vtkObject
+{
+public:
+  static vtkMultiChannelAccumulator *New();
+  vtkTypeRevisionMacro(vtkMultiChannelAccumulator,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Turn accumulation on or off
+  vtkSetMacro(Enabled,int);
+  vtkGetMacro(Enabled,int);
+  vtkBooleanMacro(Enabled,int);
+
+  // Description:
+  // Number of frames added up before the average is held
+  vtkSetClampMacro(MaximumNumberOfFrames,int,1,4096);
+  vtkGetMacro(MaximumNumberOfFrames,int);
+
+  // Description:
+  // Tells when the scene has changed
+  vtkGetObjectMacro(SceneMonitor,vtkMultiChannelSceneMonitor);
+
+  // Description:
+  // Pool the averages are taken from.  Set by the helper.  Changing it
+  // returns the averages to the old pool and starts over.
+  void SetRenderTargetPool(vtkMultiChannelRenderTargetPool*);
+  vtkGetObjectMacro(RenderTargetPool,vtkMultiChannelRenderTargetPool);
+
+  // Description:
+  // Called by the helper before rendering the channels.  Sets each
+  // channel's jitter for the frame.  Returns 0 if the channels need not
+  // be rendered, because the average is complete.
+  int BeginFrame(vtkRendererCollection*, vtkCollection* channels);
+
+  // Description:
+  // Called by the helper once the channels are rendered, with the
+  // window's context current.  Adds the frame to the average and draws
+  // the average in its place.
+  void EndFrame(vtkRenderWindow*, vtkCollection* channels);
+
+  // Description:
+  // Start over with the next frame
+  void Reset();
+
+  // Description:
+  // Memory in bytes held for the average of a channel's frames
+  double GetChannelMemory(int);
+
+  // Description:
+  // Return the averages to the pool, and render as usual until the
+  // scene changes
+  void ReleaseMemory();
+  vtkGetMacro(Suspended,int);
+
+  // Description:
+  // Number of frames in the average shown
+  vtkGetMacro(NumberOfAccumulatedFrames,int);
+
+protected:
+  vtkMultiChannelAccumulator();
+  ~vtkMultiChannelAccumulator();
+
+  int Enabled;
+  int MaximumNumberOfFrames;
+
+  vtkMultiChannelSceneMonitor* SceneMonitor;
+  vtkMultiChannelRenderTargetPool* RenderTargetPool;
+
+  int Accumulating;
+  int Suspended;
+  int NumberOfAccumulatedFrames;
+
+  vtkMultiChannelAccumulatorInternals* Internals;
+
+private:
+  vtkMultiChannelAccumulator(const vtkMultiChannelAccumulator&);  // Not implemented.
+  void operator=(const vtkMultiChannelAccumulator&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,345 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelCameraPath.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelCameraPath.h"
+
+#include "vtkCamera.h"
+#include "vtkMultiChannelRenderWindowHelper.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGL.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+#include "vtkTimerLog.h"
+#include "vtkWin32OpenGLMultiChannelRenderWindow.h"
+
+#include <stdio.h>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelCameraPath, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelCameraPath);
+
+// Identifies camera path files
+#define VTK_MULTICHANNEL_CAMERA_PATH_MAGIC    0x564d4350
+#define VTK_MULTICHANNEL_CAMERA_PATH_VERSION  1
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelCameraPathInternals
+{
+public:
+  struct Frame
+  {
+    double Time;
+
+    // Position, focal point, view up, view angle, parallel scale
+    float Camera[11];
+  };
+
+  std::vector<Frame> Frames;
+  std::vector<double> ReplayTimes;
+
+  FILE* File;
+  int NumberOfRecordedFrames;
+
+  static void GetCamera(vtkCamera* camera, float values[11])
+    {
+    double* position = camera->GetPosition();
+    double* focalPoint = camera->GetFocalPoint();
+    double* viewUp = camera->GetViewUp();
+    for (int i = 0; i < 3; i++)
+      {
+      values[i] = static_cast<float>(position[i]);
+      values[3 + i] = static_cast<float>(focalPoint[i]);
+      values[6 + i] = static_cast<float>(viewUp[i]);
+      }
+    values[9] = static_cast<float>(camera->GetViewAngle());
+    values[10] = static_cast<float>(camera->GetParallelScale());
+    }
+
+  static void SetCamera(vtkCamera* camera, const float values[11])
+    {
+    camera->SetPosition(values[0], values[1], values[2]);
+    camera->SetFocalPoint(values[3], values[4], values[5]);
+    camera->SetViewUp(values[6], values[7], values[8]);
+    camera->SetViewAngle(values[9]);
+    camera->SetParallelScale(values[10]);
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelCameraPath::vtkMultiChannelCameraPath()
+{
+  this->Recording = 0;
+  this->RecordingStartTime = 0;
+
+  this->TotalReplayTime = 0;
+  this->MaximumReplayFrameTime = 0;
+
+  this->Internals = new vtkMultiChannelCameraPathInternals;
+  this->Internals->File = NULL;
+  this->Internals->NumberOfRecordedFrames = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelCameraPath::~vtkMultiChannelCameraPath()
+{
+  this->StopRecording();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelCameraPath::StartRecording(const char* fileName)
+{
+  this->StopRecording();
+
+  this->Internals->File = fopen(fileName, "wb");
+  if (!this->Internals->File)
+    {
+    vtkErrorMacro(<< "Could not open " << fileName << " for writing.");
+    return 0;
+    }
+
+  // The number of frames is filled in when recording stops
+  int header[3] = { VTK_MULTICHANNEL_CAMERA_PATH_MAGIC, VTK_MULTICHANNEL_CAMERA_PATH_VERSION, 0 };
+  fwrite(header, sizeof(int), 3, this->Internals->File);
+
+  this->Internals->NumberOfRecordedFrames = 0;
+  this->RecordingStartTime = vtkTimerLog::GetUniversalTime();
+  this->Recording = 1;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelCameraPath::StopRecording()
+{
+  if (!this->Recording)
+    {
+    return;
+    }
+
+  fseek(this->Internals->File, 2 * sizeof(int), SEEK_SET);
+  fwrite(&this->Internals->NumberOfRecordedFrames, sizeof(int), 1, this->Internals->File);
+
+  if (ferror(this->Internals->File))
+    {
+    vtkErrorMacro(<< "Error writing the camera path.");
+    }
+
+  fclose(this->Internals->File);
+  this->Internals->File = NULL;
+
+  this->Recording = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelCameraPath::RecordFrame(vtkCamera* camera)
+{
+  if (!this->Recording || !camera)
+    {
+    return;
+    }
+
+  vtkMultiChannelCameraPathInternals::Frame frame;
+  frame.Time = vtkTimerLog::GetUniversalTime() - this->RecordingStartTime;
+  vtkMultiChannelCameraPathInternals::GetCamera(camera, frame.Camera);
+
+  fwrite(&frame.Time, sizeof(double), 1, this->Internals->File);
+  fwrite(frame.Camera, sizeof(float), 11, this->Internals->File);
+
+  this->Internals->NumberOfRecordedFrames++;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelCameraPath::Load(const char* fileName)
+{
+  this->Internals->Frames.clear();
+  this->Internals->ReplayTimes.clear();
+
+  FILE* file = fopen(fileName, "rb");
+  if (!file)
+    {
+    vtkErrorMacro(<< "Could not open " << fileName << ".");
+    return 0;
+    }
+
+  int header[3];
+  if (fread(header, sizeof(int), 3, file) != 3 ||
+      header[0] != VTK_MULTICHANNEL_CAMERA_PATH_MAGIC ||
+      header[1] != VTK_MULTICHANNEL_CAMERA_PATH_VERSION)
+    {
+    vtkErrorMacro(<< fileName << " is not a camera path.");
+    fclose(file);
+    return 0;
+    }
+
+  for (int i = 0; i < header[2]; i++)
+    {
+    vtkMultiChannelCameraPathInternals::Frame frame;
+    if (fread(&frame.Time, sizeof(double), 1, file) != 1 ||
+        fread(frame.Camera, sizeof(float), 11, file) != 11)
+      {
+      vtkWarningMacro(<< fileName << " is truncated.");
+      break;
+      }
+    this->Internals->Frames.push_back(frame);
+    }
+
+  fclose(file);
+
+  return this->GetNumberOfFrames();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelCameraPath::GetNumberOfFrames()
+{
+  return static_cast<int>(this->Internals->Frames.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelCameraPath::Replay(vtkRenderWindow* window)
+{
+  this->Internals->ReplayTimes.clear();
+  this->TotalReplayTime = 0;
+  this->MaximumReplayFrameTime = 0;
+
+  vtkRenderer* renderer = window ? window->GetRenderers()->GetFirstRenderer() : NULL;
+  if (!renderer)
+    {
+    vtkErrorMacro(<< "No renderer to replay with.");
+    return 0;
+    }
+
+  // Do not record what is replayed
+  this->StopRecording();
+
+  // Render each frame here and now, rather than on the render thread or
+  // the scheduler's next tick, and without the pacer's wait
+  vtkWin32OpenGLMultiChannelRenderWindow* multiChannelWindow =
+    vtkWin32OpenGLMultiChannelRenderWindow::SafeDownCast(window);
+  vtkMultiChannelRenderWindowHelper* helper = multiChannelWindow ? multiChannelWindow->GetHelper() : NULL;
+  if (helper)
+    {
+    helper->BeginDirectRendering();
+    }
+
+  vtkCamera* camera = renderer->GetActiveCamera();
+  float saved[11];
+  vtkMultiChannelCameraPathInternals::GetCamera(camera, saved);
+
+  for (int i = 0; i < this->GetNumberOfFrames(); i++)
+    {
+    vtkMultiChannelCameraPathInternals::SetCamera(camera, this->Internals->Frames[i].Camera);
+    renderer->ResetCameraClippingRange();
+
+    // Include the time for the GPU to finish the frame
+    double start = vtkTimerLog::GetUniversalTime();
+    window->Render();
+    window->MakeCurrent();
+    glFinish();
+    double time = vtkTimerLog::GetUniversalTime() - start;
+
+    this->Internals->ReplayTimes.push_back(time);
+    this->TotalReplayTime += time;
+    if (time > this->MaximumReplayFrameTime)
+      {
+      this->MaximumReplayFrameTime = time;
+      }
+    }
+
+  vtkMultiChannelCameraPathInternals::SetCamera(camera, saved);
+  renderer->ResetCameraClippingRange();
+
+  if (helper)
+    {
+    helper->EndDirectRendering();
+    }
+
+  return static_cast<int>(this->Internals->ReplayTimes.size());
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelCameraPath::GetRecordedFrameTime(int i)
+{
+  if (i <= 0 || i >= this->GetNumberOfFrames())
+    {
+    return 0;
+    }
+
+  return this->Internals->Frames[i].Time - this->Internals->Frames[i - 1].Time;
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelCameraPath::GetReplayFrameTime(int i)
+{
+  if (i < 0 || i >= static_cast<int>(this->Internals->ReplayTimes.size()))
+    {
+    return 0;
+    }
+
+  return this->Internals->ReplayTimes[i];
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelCameraPath::GetAverageReplayFrameTime()
+{
+  if (this->Internals->ReplayTimes.empty())
+    {
+    return 0;
+    }
+
+  return this->TotalReplayTime / this->Internals->ReplayTimes.size();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelCameraPath::WriteTimings(const char* fileName)
+{
+  FILE* file = fopen(fileName, "w");
+  if (!file)
+    {
+    vtkErrorMacro(<< "Could not open " << fileName << " for writing.");
+    return 0;
+    }
+
+  fprintf(file, "Frame,Recorded Frame Time,Replay Frame Time\n");
+  for (unsigned int i = 0; i < this->Internals->ReplayTimes.size(); i++)
+    {
+    fprintf(file, "%u,%f,%f\n", i, this->GetRecordedFrameTime(i), this->Internals->ReplayTimes[i]);
+    }
+
+  int ok = !ferror(file);
+  fclose(file);
+
+  if (!ok)
+    {
+    vtkErrorMacro(<< "Error writing " << fileName << ".");
+    }
+
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelCameraPath::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Recording: " << this->Recording << "\n";
+  os << indent << "Number Of Frames: " << this->GetNumberOfFrames() << "\n";
+  os << indent << "Total Replay Time: " << this->TotalReplayTime << "\n";
+  os << indent << "Average Replay Frame Time: " << this->GetAverageReplayFrameTime() << "\n";
+  os << indent << "Maximum Replay Frame Time: " << this->MaximumReplayFrameTime << "\n";
+}
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelCameraPath.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelCameraPath
+// .SECTION Description
+// vtkMultiChannelCameraPath records the camera of a live session, frame
+// by frame, and replays it to compare the performance of builds and
+// channel layouts on identical camera motion.
+//
+// Set on a vtkMultiChannelRenderWindowHelper, the camera of the first
+// renderer is recorded at the start of each frame between
+// StartRecording() and StopRecording().  Each frame is stored in binary,
+// in the recording machine's byte order, as the time in seconds since
+// recording started, followed by the camera's position, focal point,
+// view up, view angle and parallel scale as floats.
+//
+// Replay() renders the window once for each frame loaded, as fast as
+// it can, and keeps the time each render took.  Call it from the thread
+// that renders the window, or that started its render thread.  A
+// multi-channel window's render thread, render scheduler and frame
+// pacer are bypassed during the replay.  WriteTimings() writes the recorded and
+// replayed frame times as comma separated values.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkMultiChannelTracer
+
+#ifndef __vtkMultiChannelCameraPath_h
+#define __vtkMultiChannelCameraPath_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkCamera;
+class vtkMultiChannelCameraPathInternals;
+class vtkRenderWindow;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelCameraPath : public vtkObject
+{
+public:
+  static vtkMultiChannelCameraPath *New();
+  vtkTypeRevisionMacro(vtkMultiChannelCameraPath,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Record the camera to the given file
+  int StartRecording(const char* fileName);
+  void StopRecording();
+  vtkGetMacro(Recording,int);
+
+  // Description:
+  // Record one frame.  Called by the helper at the start of each frame.
+  void RecordFrame(vtkCamera*);
+
+  // Description:
+  // Load a recorded path.  Returns the number of frames.
+  int Load(const char* fileName);
+  int GetNumberOfFrames();
+
+  // Description:
+  // Render the window once for each frame loaded, with the first
+  // renderer's camera set as recorded.  The camera is restored after.
+  // Returns the number of frames rendered.
+  int Replay(vtkRenderWindow*);
+
+  // Description:
+  // Time between a recorded frame and the previous one, and the time
+  // taken to render it when replayed
+  double GetRecordedFrameTime(int);
+  double GetReplayFrameTime(int);
+
+  // Description:
+  // Statistics of the last replay
+  vtkGetMacro(TotalReplayTime,double);
+  vtkGetMacro(MaximumReplayFrameTime,double);
+  double GetAverageReplayFrameTime();
+
+  // Description:
+  // Write the frame times of the last replay
+  int WriteTimings(const char* fileName);
+
+protected:
+  vtkMultiChannelCameraPath();
+  ~vtkMultiChannelCameraPath();
+
+  int Recording;
+  double RecordingStartTime;
+
+  double TotalReplayTime;
+  double MaximumReplayFrameTime;
+
+  vtkMultiChannelCameraPathInternals* Internals;
+
+private:
+  vtkMultiChannelCameraPath(const vtkMultiChannelCameraPath&);  // Not implemented.
+  void operator=(const vtkMultiChannelCameraPath&);  // Not implemented.
+};
+
+#endif
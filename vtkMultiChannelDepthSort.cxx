@@ -0,0 +1,313 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelDepthSort.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelDepthSort.h"
+
+#include "vtkCamera.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelDepthSort, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelDepthSort);
+
+vtkCxxSetObjectMacro(vtkMultiChannelDepthSort, Camera, vtkCamera);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelDepthSortInternals
+{
+public:
+  // Cells are ordered by type, as mappers draw them, then farthest first
+  struct Key
+  {
+    int Group;
+    double Distance2;
+    vtkIdType CellId;
+
+    bool operator<(const Key& other) const
+    {
+      if (this->Group != other.Group)
+        {
+        return this->Group < other.Group;
+        }
+      return this->Distance2 > other.Distance2;
+    }
+  };
+
+  vtkPolyData* Input;
+  double ReferencePoint[3];
+
+  std::vector<Key> Keys;
+
+  // Start of each thread's part of the keys
+  std::vector<vtkIdType> Parts;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelDepthSort::vtkMultiChannelDepthSort()
+{
+  this->ReferencePoint[0] = this->ReferencePoint[1] = this->ReferencePoint[2] = 0.0;
+  this->Camera = NULL;
+  this->Tolerance = 0.0;
+  this->NumberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->SortedPosition[0] = this->SortedPosition[1] = this->SortedPosition[2] = 0.0;
+  this->HasSorted = 0;
+
+  this->SortTime = 0;
+  this->NumberOfSorts = 0;
+
+  this->Internals = new vtkMultiChannelDepthSortInternals;
+  this->Internals->Input = NULL;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelDepthSort::~vtkMultiChannelDepthSort()
+{
+  this->SetCamera(NULL);
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkMultiChannelDepthSort::GetMTime()
+{
+  unsigned long mTime = this->Superclass::GetMTime();
+
+  if (!this->Camera)
+    {
+    return mTime;
+    }
+
+  // Only a move, not a rotation, changes the order.  A camera that has
+  // moved from the sorted position was modified after the last sort.
+  double* position = this->Camera->GetPosition();
+  double distance2 = vtkMath::Distance2BetweenPoints(position, this->SortedPosition);
+  if (this->HasSorted && distance2 <= this->Tolerance * this->Tolerance)
+    {
+    return mTime;
+    }
+
+  unsigned long cameraTime = this->Camera->GetMTime();
+  return cameraTime > mTime ? cameraTime : mTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelDepthSort::ResetCounters()
+{
+  this->NumberOfSorts = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelDepthSort::RequestData(vtkInformation*,
+                                          vtkInformationVector** inputVector,
+                                          vtkInformationVector* outputVector)
+{
+  double start = vtkTimerLog::GetUniversalTime();
+
+  vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector);
+
+  vtkMultiChannelDepthSortInternals* internals = this->Internals;
+
+  if (this->Camera)
+    {
+    this->Camera->GetPosition(this->SortedPosition);
+    this->HasSorted = 1;
+    internals->ReferencePoint[0] = this->SortedPosition[0];
+    internals->ReferencePoint[1] = this->SortedPosition[1];
+    internals->ReferencePoint[2] = this->SortedPosition[2];
+    }
+  else
+    {
+    internals->ReferencePoint[0] = this->ReferencePoint[0];
+    internals->ReferencePoint[1] = this->ReferencePoint[1];
+    internals->ReferencePoint[2] = this->ReferencePoint[2];
+    }
+
+  vtkIdType numCells = input->GetNumberOfCells();
+
+  output->SetPoints(input->GetPoints());
+  output->GetPointData()->PassData(input->GetPointData());
+
+  if (numCells == 0 || !input->GetPoints())
+    {
+    return 1;
+    }
+
+  // Cell points are looked up by id from every thread
+  input->BuildCells();
+  internals->Input = input;
+  internals->Keys.resize(numCells);
+
+  int numberOfThreads = this->NumberOfThreads;
+  if (numCells < numberOfThreads * 1024)
+    {
+    numberOfThreads = 1;
+    }
+
+  internals->Parts.resize(numberOfThreads + 1);
+  for (int i = 0; i <= numberOfThreads; i++)
+    {
+    internals->Parts[i] = numCells * i / numberOfThreads;
+    }
+
+  if (numberOfThreads > 1)
+    {
+    vtkMultiThreader* threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(&vtkMultiChannelDepthSort::SortMain, this);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+  else
+    {
+    this->SortPart(0, 1);
+    }
+
+  // Merge the sorted parts pairwise
+  std::vector<vtkMultiChannelDepthSortInternals::Key>::iterator keys = internals->Keys.begin();
+  for (int step = 1; step < numberOfThreads; step *= 2)
+    {
+    for (int i = 0; i + step < numberOfThreads; i += 2 * step)
+      {
+      int last = i + 2 * step < numberOfThreads ? i + 2 * step : numberOfThreads;
+      std::inplace_merge(keys + internals->Parts[i], keys + internals->Parts[i + step],
+                         keys + internals->Parts[last]);
+      }
+    }
+
+  // Copy the cells out farthest first.  Cells are inserted in the order
+  // the output numbers them, verts to strips, so the ids match.
+  vtkCellData* inCD = input->GetCellData();
+  vtkCellData* outCD = output->GetCellData();
+  outCD->CopyAllocate(inCD, numCells);
+  output->Allocate(input, numCells);
+
+  vtkIdType npts;
+  vtkIdType* pts;
+  for (vtkIdType i = 0; i < numCells; i++)
+    {
+    vtkIdType cellId = internals->Keys[i].CellId;
+    input->GetCellPoints(cellId, npts, pts);
+    output->InsertNextCell(input->GetCellType(cellId), npts, pts);
+    outCD->CopyData(inCD, cellId, i);
+    }
+
+  output->Squeeze();
+
+  internals->Input = NULL;
+
+  this->SortTime = vtkTimerLog::GetUniversalTime() - start;
+  this->NumberOfSorts++;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelDepthSort::SortMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkMultiChannelDepthSort* self = static_cast<vtkMultiChannelDepthSort*>(info->UserData);
+  self->SortPart(info->ThreadID, info->NumberOfThreads);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelDepthSort::SortPart(int threadId, int)
+{
+  vtkMultiChannelDepthSortInternals* internals = this->Internals;
+
+  vtkPolyData* input = internals->Input;
+  vtkPoints* points = input->GetPoints();
+  const double* reference = internals->ReferencePoint;
+
+  vtkIdType begin = internals->Parts[threadId];
+  vtkIdType end = internals->Parts[threadId + 1];
+
+  vtkIdType npts;
+  vtkIdType* pts;
+  double point[3];
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    input->GetCellPoints(i, npts, pts);
+
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType j = 0; j < npts; j++)
+      {
+      points->GetPoint(pts[j], point);
+      center[0] += point[0];
+      center[1] += point[1];
+      center[2] += point[2];
+      }
+    if (npts > 0)
+      {
+      center[0] /= npts;
+      center[1] /= npts;
+      center[2] /= npts;
+      }
+
+    int group;
+    switch (input->GetCellType(i))
+      {
+      case VTK_VERTEX:
+      case VTK_POLY_VERTEX:
+        group = 0;
+        break;
+      case VTK_LINE:
+      case VTK_POLY_LINE:
+        group = 1;
+        break;
+      case VTK_TRIANGLE_STRIP:
+        group = 3;
+        break;
+      default:
+        group = 2;
+        break;
+      }
+
+    internals->Keys[i].Group = group;
+    internals->Keys[i].Distance2 = vtkMath::Distance2BetweenPoints(center, reference);
+    internals->Keys[i].CellId = i;
+    }
+
+  std::sort(internals->Keys.begin() + begin, internals->Keys.begin() + end);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelDepthSort::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Reference Point: (" << this->ReferencePoint[0] << ", "
+     << this->ReferencePoint[1] << ", " << this->ReferencePoint[2] << ")\n";
+  os << indent << "Camera: " << this->Camera << "\n";
+  os << indent << "Tolerance: " << this->Tolerance << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+  os << indent << "Sort Time: " << this->SortTime << "\n";
+  os << indent << "Number Of Sorts: " << this->NumberOfSorts << "\n";
+}
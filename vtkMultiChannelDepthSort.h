@@ -0,0 +1,125 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelDepthSort.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelDepthSort
+// .SECTION Description
+// vtkMultiChannelDepthSort sorts the cells of translucent polygonal
+// data back to front once for all channels.  vtkDepthSortPolyData sorts
+// along the camera's view direction, so it sorts again for every
+// channel and eye, as each rotates the camera.  This filter instead
+// sorts by the distance of each cell's center from a single reference
+// point, an order that is correct for any view direction from that
+// point.  For a dome the reference point is its center; for stereo it
+// is the midpoint between the eyes.
+//
+// If a camera is set, its position, which is the midpoint between the
+// eyes, is the reference point, and the camera's orientation is
+// ignored.  The data is sorted again only when the camera has moved
+// more than Tolerance since the last sort, so channels rendering from
+// the same position reuse the one order.  Otherwise the reference point
+// is set explicitly.
+//
+// Cell centers and distances are computed, and the cells sorted, in
+// NumberOfThreads parts that are then merged.  As with
+// vtkDepthSortPolyData, cells are only sorted among their own type, as
+// mappers draw vertices, lines, polygons and strips in turn, and the
+// output holds them in that order so that cell data stays with its
+// cell.  Point clouds should be given as one vertex cell per point.
+
+// .SECTION see also
+// vtkOpenGLMultiChannelRenderer vtkMultiChannelGeometryCache
+
+#ifndef __vtkMultiChannelDepthSort_h
+#define __vtkMultiChannelDepthSort_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkMultiThreader.h"   // For VTK_MAX_THREADS
+
+class vtkCamera;
+class vtkMultiChannelDepthSortInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelDepthSort : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkMultiChannelDepthSort *New();
+  vtkTypeRevisionMacro(vtkMultiChannelDepthSort,vtkPolyDataAlgorithm);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Point the cells are sorted by their distance from, when no camera
+  // is set
+  vtkSetVector3Macro(ReferencePoint,double);
+  vtkGetVector3Macro(ReferencePoint,double);
+
+  // Description:
+  // Camera whose position is the reference point
+  void SetCamera(vtkCamera*);
+  vtkGetObjectMacro(Camera,vtkCamera);
+
+  // Description:
+  // Distance the camera can move before the data is sorted again
+  vtkSetClampMacro(Tolerance,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(Tolerance,double);
+
+  // Description:
+  // Number of threads to sort with
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // Include the camera's position in the modified time
+  unsigned long GetMTime();
+
+  // Description:
+  // Seconds taken by the last sort, and the number of sorts since the
+  // counters were reset
+  vtkGetMacro(SortTime,double);
+  vtkGetMacro(NumberOfSorts,int);
+  void ResetCounters();
+
+protected:
+  vtkMultiChannelDepthSort();
+  ~vtkMultiChannelDepthSort();
+
+  double ReferencePoint[3];
+  vtkCamera* Camera;
+  double Tolerance;
+  int NumberOfThreads;
+
+  // Camera position of the last sort
+  double SortedPosition[3];
+  int HasSorted;
+
+  double SortTime;
+  int NumberOfSorts;
+
+  vtkMultiChannelDepthSortInternals* Internals;
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  // Description:
+  // Thread entry point.  Computes the distances of and sorts one part
+  // of the cells.
+  static VTK_THREAD_RETURN_TYPE SortMain(void*);
+  void SortPart(int threadId, int numberOfThreads);
+
+private:
+  vtkMultiChannelDepthSort(const vtkMultiChannelDepthSort&);  // Not implemented.
+  void operator=(const vtkMultiChannelDepthSort&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,275 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFramePacer.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelFramePacer.h"
+
+#include "vtkCommand.h"
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <math.h>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelFramePacer, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelFramePacer);
+
+// Time in seconds before the start time at which to stop sleeping and
+// spin, as sleeps can overshoot
+#define VTK_MULTICHANNEL_PACER_SPIN_TIME  0.002
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelFramePacerInternals
+{
+public:
+  // Exponentially weighted running mean and variance
+  struct Statistic
+  {
+    Statistic() : Mean(0), Variance(0), Count(0) {}
+
+    void Add(double value, double weight)
+      {
+      if (this->Count == 0)
+        {
+        this->Mean = value;
+        this->Variance = 0;
+        }
+      else
+        {
+        double difference = value - this->Mean;
+        double increment = weight * difference;
+        this->Mean += increment;
+        this->Variance = (1 - weight) * (this->Variance + difference * increment);
+        }
+      this->Count++;
+      }
+
+    double Mean;
+    double Variance;
+    int Count;
+  };
+
+  std::vector<Statistic> Channels;
+  Statistic Remainder;
+
+  // Channel times of the current frame, negative if not rendered
+  std::vector<double> ChannelStartTimes;
+  std::vector<double> ChannelTimes;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFramePacer::vtkMultiChannelFramePacer()
+{
+  this->Enabled = 1;
+  this->TargetFrameRate = 60.0;
+  this->SafetyMargin = 0.002;
+  this->Deviations = 2.0;
+  this->HistoryLength = 30;
+
+  this->PredictedRenderTime = 0;
+  this->LastRenderTime = 0;
+  this->LastWaitTime = 0;
+
+  this->RenderStartTime = 0;
+  this->TargetSwapTime = 0;
+  this->LastSwapTime = 0;
+
+  this->NumberOfFrames = 0;
+  this->NumberOfMissedFrames = 0;
+
+  this->Internals = new vtkMultiChannelFramePacerInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFramePacer::~vtkMultiChannelFramePacer()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::BeginFrame()
+{
+  double now = vtkTimerLog::GetUniversalTime();
+
+  this->LastWaitTime = 0;
+  this->TargetSwapTime = 0;
+
+  // Start as late as the prediction allows, once there is one
+  if (this->Enabled && this->LastSwapTime > 0 && this->Internals->Remainder.Count > 0)
+    {
+    double period = 1.0 / this->TargetFrameRate;
+    double needed = this->PredictedRenderTime + this->SafetyMargin;
+
+    // The first swap the frame can make
+    double target = this->LastSwapTime + period;
+    if (target < now + needed)
+      {
+      target += ceil((now + needed - target) / period) * period;
+      }
+
+    this->TargetSwapTime = target;
+    this->WaitUntil(target - needed);
+    this->LastWaitTime = vtkTimerLog::GetUniversalTime() - now;
+    }
+
+  this->Internals->ChannelStartTimes.clear();
+  this->Internals->ChannelTimes.clear();
+
+  // Time spent by observers sampling input is part of the frame
+  this->RenderStartTime = vtkTimerLog::GetUniversalTime();
+  this->InvokeEvent(vtkCommand::StartEvent, NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::BeginChannel(int i)
+{
+  if (i < 0)
+    {
+    return;
+    }
+
+  vtkMultiChannelFramePacerInternals* internals = this->Internals;
+  if (i >= static_cast<int>(internals->ChannelTimes.size()))
+    {
+    internals->ChannelStartTimes.resize(i + 1, 0);
+    internals->ChannelTimes.resize(i + 1, -1);
+    }
+
+  internals->ChannelStartTimes[i] = vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::EndChannel(int i)
+{
+  vtkMultiChannelFramePacerInternals* internals = this->Internals;
+  if (i < 0 || i >= static_cast<int>(internals->ChannelTimes.size()))
+    {
+    return;
+    }
+
+  internals->ChannelTimes[i] = vtkTimerLog::GetUniversalTime() - internals->ChannelStartTimes[i];
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::EndRender()
+{
+  if (this->RenderStartTime <= 0)
+    {
+    return;
+    }
+
+  vtkMultiChannelFramePacerInternals* internals = this->Internals;
+
+  this->LastRenderTime = vtkTimerLog::GetUniversalTime() - this->RenderStartTime;
+  this->RenderStartTime = 0;
+
+  double weight = 2.0 / (this->HistoryLength + 1);
+
+  // Forget channels that are no longer rendered
+  internals->Channels.resize(internals->ChannelTimes.size());
+
+  double channelTime = 0;
+  for (unsigned int i = 0; i < internals->ChannelTimes.size(); i++)
+    {
+    if (internals->ChannelTimes[i] >= 0)
+      {
+      internals->Channels[i].Add(internals->ChannelTimes[i], weight);
+      channelTime += internals->ChannelTimes[i];
+      }
+    }
+
+  // Includes the time for the GPU to finish what the channels submitted
+  double remainder = this->LastRenderTime - channelTime;
+  internals->Remainder.Add(remainder > 0 ? remainder : 0, weight);
+
+  this->Predict();
+
+  this->NumberOfFrames++;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::FrameSwapped()
+{
+  double now = vtkTimerLog::GetUniversalTime();
+
+  // Missed if it went out a refresh or more later than targeted
+  if (this->TargetSwapTime > 0 &&
+      now > this->TargetSwapTime + 0.5 / this->TargetFrameRate)
+    {
+    this->NumberOfMissedFrames++;
+    }
+
+  this->LastSwapTime = now;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::Predict()
+{
+  vtkMultiChannelFramePacerInternals* internals = this->Internals;
+
+  double mean = internals->Remainder.Mean;
+  double variance = internals->Remainder.Variance;
+  for (unsigned int i = 0; i < internals->Channels.size(); i++)
+    {
+    mean += internals->Channels[i].Mean;
+    variance += internals->Channels[i].Variance;
+    }
+
+  this->PredictedRenderTime = mean + this->Deviations * sqrt(variance);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::WaitUntil(double time)
+{
+  // Sleep in short steps, then spin for the accuracy sleeping lacks
+  while (time - vtkTimerLog::GetUniversalTime() > VTK_MULTICHANNEL_PACER_SPIN_TIME)
+    {
+    vtksys::SystemTools::Delay(1);
+    }
+
+  while (vtkTimerLog::GetUniversalTime() < time)
+    {
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelFramePacer::GetMeanChannelTime(int i)
+{
+  if (i < 0 || i >= static_cast<int>(this->Internals->Channels.size()))
+    {
+    return 0;
+    }
+
+  return this->Internals->Channels[i].Mean;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFramePacer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Enabled: " << this->Enabled << "\n";
+  os << indent << "Target Frame Rate: " << this->TargetFrameRate << "\n";
+  os << indent << "Safety Margin: " << this->SafetyMargin << "\n";
+  os << indent << "Deviations: " << this->Deviations << "\n";
+  os << indent << "History Length: " << this->HistoryLength << "\n";
+  os << indent << "Predicted Render Time: " << this->PredictedRenderTime << "\n";
+  os << indent << "Last Render Time: " << this->LastRenderTime << "\n";
+  os << indent << "Last Wait Time: " << this->LastWaitTime << "\n";
+  os << indent << "Number Of Frames: " << this->NumberOfFrames << "\n";
+  os << indent << "Number Of Missed Frames: " << this->NumberOfMissedFrames << "\n";
+}
@@ -0,0 +1,151 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFramePacer.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelFramePacer
+// .SECTION Description
+// vtkMultiChannelFramePacer delays the start of each frame so that it
+// finishes just before the swap it is meant for, rather than finishing
+// early and waiting at the swap with stale input.  This lowers the
+// latency of head tracked and HMD layouts.
+//
+// The render time of the next frame is predicted from a running mean
+// and variance of each channel's render time and of the rest of the
+// frame, as the mean plus Deviations standard deviations.  The frame
+// starts that long, plus SafetyMargin, before the next swap it can make.
+// HistoryLength sets how many frames the running statistics remember.
+//
+// Set on a vtkMultiChannelRenderWindowHelper, the pacer is driven by the
+// helper and the window.  With vertical sync on and the pacer enabled,
+// the window waits for the GPU before and after each swap so that the
+// times measured are the times the frame is drawn and shown.  A
+// vtkCommand::StartEvent is invoked after the wait, for applications to
+// read trackers and update the camera as late as possible.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkMultiChannelTracer
+
+#ifndef __vtkMultiChannelFramePacer_h
+#define __vtkMultiChannelFramePacer_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkMultiChannelFramePacerInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelFramePacer : public vtkObject
+{
+public:
+  static vtkMultiChannelFramePacer *New();
+  vtkTypeRevisionMacro(vtkMultiChannelFramePacer,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Turn pacing on or off.  When off, frames are still timed.
+  vtkSetMacro(Enabled,int);
+  vtkGetMacro(Enabled,int);
+  vtkBooleanMacro(Enabled,int);
+
+  // Description:
+  // Refresh rate of the display, in frames per second
+  vtkSetClampMacro(TargetFrameRate,double,1.0,1000.0);
+  vtkGetMacro(TargetFrameRate,double);
+
+  // Description:
+  // Time in seconds the frame should finish before the swap
+  vtkSetClampMacro(SafetyMargin,double,0.0,1.0);
+  vtkGetMacro(SafetyMargin,double);
+
+  // Description:
+  // Number of standard deviations added to the mean render time
+  vtkSetClampMacro(Deviations,double,0.0,10.0);
+  vtkGetMacro(Deviations,double);
+
+  // Description:
+  // Number of frames the render time statistics are averaged over
+  vtkSetClampMacro(HistoryLength,int,1,1000);
+  vtkGetMacro(HistoryLength,int);
+
+  // Description:
+  // Called by the helper at the start of each frame.  Waits until the
+  // predicted start time, then invokes a vtkCommand::StartEvent.
+  void BeginFrame();
+
+  // Description:
+  // Called by the helper around the rendering of each channel
+  void BeginChannel(int);
+  void EndChannel(int);
+
+  // Description:
+  // Called by the window once the frame is drawn, before the swap
+  void EndRender();
+
+  // Description:
+  // Called by the window once the frame is swapped
+  void FrameSwapped();
+
+  // Description:
+  // Predicted render time of the next frame, and the render time of and
+  // time waited before the last frame
+  vtkGetMacro(PredictedRenderTime,double);
+  vtkGetMacro(LastRenderTime,double);
+  vtkGetMacro(LastWaitTime,double);
+
+  // Description:
+  // Mean render time of a channel
+  double GetMeanChannelTime(int);
+
+  // Description:
+  // Number of frames paced, and of those swapped later than targeted
+  vtkGetMacro(NumberOfFrames,int);
+  vtkGetMacro(NumberOfMissedFrames,int);
+
+protected:
+  vtkMultiChannelFramePacer();
+  ~vtkMultiChannelFramePacer();
+
+  int Enabled;
+  double TargetFrameRate;
+  double SafetyMargin;
+  double Deviations;
+  int HistoryLength;
+
+  double PredictedRenderTime;
+  double LastRenderTime;
+  double LastWaitTime;
+
+  double RenderStartTime;
+  double TargetSwapTime;
+  double LastSwapTime;
+
+  int NumberOfFrames;
+  int NumberOfMissedFrames;
+
+  vtkMultiChannelFramePacerInternals* Internals;
+
+  // Description:
+  // Update the prediction from the running statistics
+  void Predict();
+
+  // Description:
+  // Wait until the given time
+  void WaitUntil(double time);
+
+private:
+  vtkMultiChannelFramePacer(const vtkMultiChannelFramePacer&);  // Not implemented.
+  void operator=(const vtkMultiChannelFramePacer&);  // Not implemented.
+};
+
+#endif
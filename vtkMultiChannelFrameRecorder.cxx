@@ -0,0 +1,481 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFrameRecorder.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelFrameRecorder.h"
+
+#include "vtkCollection.h"
+#include "vtkConditionVariable.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowChannel.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <deque>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelFrameRecorder, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelFrameRecorder);
+
+//----------------------------------------------------------------------------
+// One output file and its queue of frames, drained by one writer thread
+class vtkMultiChannelFrameRecorderStream
+{
+public:
+  vtkMultiChannelFrameRecorderStream()
+    {
+    this->Recorder = NULL;
+    this->File = NULL;
+    this->Format = VTK_MULTICHANNEL_RECORD_RAW;
+    this->Origin[0] = this->Origin[1] = 0;
+    this->Size[0] = this->Size[1] = 0;
+    this->ThreadId = -1;
+    this->StopRequested = 0;
+    this->Lock = vtkMutexLock::New();
+    this->QueuedCondition = vtkConditionVariable::New();
+    this->FreeCondition = vtkConditionVariable::New();
+    }
+
+  ~vtkMultiChannelFrameRecorderStream()
+    {
+    for (unsigned int i = 0; i < this->Buffers.size(); i++)
+      {
+      this->Buffers[i]->Delete();
+      }
+    if (this->File)
+      {
+      fclose(this->File);
+      }
+    this->Lock->Delete();
+    this->QueuedCondition->Delete();
+    this->FreeCondition->Delete();
+    }
+
+  void WriteFrame(vtkUnsignedCharArray*);
+  void WriterLoop();
+
+  vtkMultiChannelFrameRecorder* Recorder;
+
+  FILE* File;
+  int Format;
+
+  int Origin[2];
+  int Size[2];
+
+  int ThreadId;
+  int StopRequested;
+
+  // Buffers holds every buffer, each of which is in Free, in Queued, or
+  // being written
+  std::vector<vtkUnsignedCharArray*> Buffers;
+  std::vector<vtkUnsignedCharArray*> Free;
+  std::deque<vtkUnsignedCharArray*> Queued;
+
+  vtkMutexLock* Lock;
+  vtkConditionVariable* QueuedCondition;
+  vtkConditionVariable* FreeCondition;
+
+  // Scratch space for the writer thread
+  std::vector<unsigned char> Planes;
+};
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelFrameRecorderInternals
+{
+public:
+  std::vector<vtkMultiChannelFrameRecorderStream*> Streams;
+  int WindowSize[2];
+};
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameRecorderStream::WriteFrame(vtkUnsignedCharArray* buffer)
+{
+  int w = this->Size[0];
+  int h = this->Size[1];
+  const unsigned char* data = buffer->GetPointer(0);
+
+  // OpenGL rows are bottom to top, files are top to bottom
+  if (this->Format == VTK_MULTICHANNEL_RECORD_RAW)
+    {
+    for (int row = h - 1; row >= 0; row--)
+      {
+      fwrite(data + row * w * 3, 1, w * 3, this->File);
+      }
+    return;
+    }
+
+  // Y4M, BT.601 studio range, planar 4:4:4
+  this->Planes.resize(w * h * 3);
+  unsigned char* y = &this->Planes[0];
+  unsigned char* cb = y + w * h;
+  unsigned char* cr = cb + w * h;
+  for (int row = h - 1; row >= 0; row--)
+    {
+    const unsigned char* p = data + row * w * 3;
+    for (int i = 0; i < w; i++, p += 3)
+      {
+      int r = p[0];
+      int g = p[1];
+      int b = p[2];
+      *y++ = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+      *cb++ = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+      *cr++ = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+      }
+    }
+
+  fputs("FRAME\n", this->File);
+  fwrite(&this->Planes[0], 1, this->Planes.size(), this->File);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameRecorderStream::WriterLoop()
+{
+  this->Lock->Lock();
+  for (;;)
+    {
+    while (this->Queued.empty() && !this->StopRequested)
+      {
+      this->QueuedCondition->Wait(this->Lock);
+      }
+    if (this->Queued.empty())
+      {
+      // Stopped, and everything queued has been written
+      break;
+      }
+
+    vtkUnsignedCharArray* buffer = this->Queued.front();
+    this->Queued.pop_front();
+    this->Lock->Unlock();
+
+    this->WriteFrame(buffer);
+
+    this->Recorder->CounterLock->Lock();
+    this->Recorder->NumberOfWrittenFrames++;
+    this->Recorder->CounterLock->Unlock();
+
+    this->Lock->Lock();
+    this->Free.push_back(buffer);
+    this->FreeCondition->Signal();
+    }
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFrameRecorder::vtkMultiChannelFrameRecorder()
+{
+  this->FilePrefix = NULL;
+  this->Format = VTK_MULTICHANNEL_RECORD_Y4M;
+  this->Layout = VTK_MULTICHANNEL_RECORD_COMPOSED;
+  this->DropPolicy = VTK_MULTICHANNEL_RECORD_DROP_OLDEST;
+  this->QueueLength = 8;
+  this->FrameRate = 30;
+
+  this->Recording = 0;
+
+  this->NumberOfRecordedFrames = 0;
+  this->NumberOfWrittenFrames = 0;
+  this->NumberOfDroppedFrames = 0;
+
+  this->LastRecordTime = 0;
+
+  this->Threader = vtkMultiThreader::New();
+  this->CounterLock = vtkMutexLock::New();
+
+  this->Internals = new vtkMultiChannelFrameRecorderInternals;
+  this->Internals->WindowSize[0] = this->Internals->WindowSize[1] = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFrameRecorder::~vtkMultiChannelFrameRecorder()
+{
+  this->Stop();
+
+  this->SetFilePrefix(NULL);
+
+  this->Threader->Delete();
+  this->CounterLock->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameRecorder::Start()
+{
+  if (this->Recording)
+    {
+    return;
+    }
+
+  if (!this->FilePrefix)
+    {
+    vtkErrorMacro(<< "No file prefix set.");
+    return;
+    }
+
+  this->NumberOfRecordedFrames = 0;
+  this->NumberOfWrittenFrames = 0;
+  this->NumberOfDroppedFrames = 0;
+
+  this->Recording = 1;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameRecorder::Stop()
+{
+  if (!this->Recording)
+    {
+    return;
+    }
+
+  this->CloseStreams();
+
+  this->Recording = 0;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameRecorder::OpenStreams(vtkRenderWindow* window, vtkCollection* channels)
+{
+  int* size = window->GetSize();
+  this->Internals->WindowSize[0] = size[0];
+  this->Internals->WindowSize[1] = size[1];
+
+  // Pixel regions to record
+  std::vector<int> regions;
+  if (this->Layout == VTK_MULTICHANNEL_RECORD_CHANNELS && channels)
+    {
+    for (int i = 0; i < channels->GetNumberOfItems(); i++)
+      {
+      vtkRenderWindowChannel* channel =
+        vtkRenderWindowChannel::SafeDownCast(channels->GetItemAsObject(i));
+      int region[4];
+      channel->GetPixelRegion(size, region);
+      regions.insert(regions.end(), region, region + 4);
+      }
+    }
+  else
+    {
+    regions.push_back(0);
+    regions.push_back(0);
+    regions.push_back(size[0]);
+    regions.push_back(size[1]);
+    }
+
+  const char* extension = this->Format == VTK_MULTICHANNEL_RECORD_Y4M ? ".y4m" : ".rgb";
+  std::vector<char> fileName(strlen(this->FilePrefix) + 32);
+
+  for (unsigned int i = 0; i < regions.size() / 4; i++)
+    {
+    if (regions[i * 4 + 2] <= 0 || regions[i * 4 + 3] <= 0)
+      {
+      continue;
+      }
+
+    if (this->Layout == VTK_MULTICHANNEL_RECORD_CHANNELS)
+      {
+      sprintf(&fileName[0], "%s_%d%s", this->FilePrefix, i, extension);
+      }
+    else
+      {
+      sprintf(&fileName[0], "%s%s", this->FilePrefix, extension);
+      }
+
+    FILE* file = fopen(&fileName[0], "wb");
+    if (!file)
+      {
+      vtkErrorMacro(<< "Could not open " << &fileName[0] << " for writing.");
+      this->CloseStreams();
+      return 0;
+      }
+
+    vtkMultiChannelFrameRecorderStream* stream = new vtkMultiChannelFrameRecorderStream;
+    stream->Recorder = this;
+    stream->File = file;
+    stream->Format = this->Format;
+    stream->Origin[0] = regions[i * 4];
+    stream->Origin[1] = regions[i * 4 + 1];
+    stream->Size[0] = regions[i * 4 + 2];
+    stream->Size[1] = regions[i * 4 + 3];
+
+    if (this->Format == VTK_MULTICHANNEL_RECORD_Y4M)
+      {
+      fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n",
+              stream->Size[0], stream->Size[1], this->FrameRate);
+      }
+
+    // One buffer per queue slot, plus the one being written
+    for (int j = 0; j <= this->QueueLength; j++)
+      {
+      vtkUnsignedCharArray* buffer = vtkUnsignedCharArray::New();
+      buffer->SetNumberOfComponents(3);
+      buffer->SetNumberOfTuples(stream->Size[0] * stream->Size[1]);
+      stream->Buffers.push_back(buffer);
+      stream->Free.push_back(buffer);
+      }
+
+    stream->ThreadId = this->Threader->SpawnThread(
+      &vtkMultiChannelFrameRecorder::WriterMain, stream);
+
+    this->Internals->Streams.push_back(stream);
+    }
+
+  if (this->Internals->Streams.empty())
+    {
+    vtkErrorMacro(<< "Nothing to record.");
+    return 0;
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameRecorder::CloseStreams()
+{
+  for (unsigned int i = 0; i < this->Internals->Streams.size(); i++)
+    {
+    vtkMultiChannelFrameRecorderStream* stream = this->Internals->Streams[i];
+
+    stream->Lock->Lock();
+    stream->StopRequested = 1;
+    stream->QueuedCondition->Signal();
+    stream->Lock->Unlock();
+
+    // Waits for the queue to be written
+    this->Threader->TerminateThread(stream->ThreadId);
+
+    delete stream;
+    }
+  this->Internals->Streams.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameRecorder::RecordFrame(vtkRenderWindow* window, vtkCollection* channels)
+{
+  if (!this->Recording || !window)
+    {
+    return;
+    }
+
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  if (this->Internals->Streams.empty() && !this->OpenStreams(window, channels))
+    {
+    this->Stop();
+    return;
+    }
+
+  this->NumberOfRecordedFrames++;
+
+  // Streams have a fixed frame size
+  int* size = window->GetSize();
+  if (size[0] != this->Internals->WindowSize[0] ||
+      size[1] != this->Internals->WindowSize[1])
+    {
+    vtkWarningMacro(<< "Window size changed while recording, dropping frame.");
+    this->NumberOfDroppedFrames += static_cast<int>(this->Internals->Streams.size());
+    return;
+    }
+
+  for (unsigned int i = 0; i < this->Internals->Streams.size(); i++)
+    {
+    vtkMultiChannelFrameRecorderStream* stream = this->Internals->Streams[i];
+    vtkUnsignedCharArray* buffer = NULL;
+
+    // Get a free buffer according to the drop policy
+    stream->Lock->Lock();
+    if (this->DropPolicy == VTK_MULTICHANNEL_RECORD_BLOCK)
+      {
+      while (stream->Free.empty())
+        {
+        stream->FreeCondition->Wait(stream->Lock);
+        }
+      }
+    if (!stream->Free.empty())
+      {
+      buffer = stream->Free.back();
+      stream->Free.pop_back();
+      }
+    else if (this->DropPolicy == VTK_MULTICHANNEL_RECORD_DROP_OLDEST)
+      {
+      buffer = stream->Queued.front();
+      stream->Queued.pop_front();
+      this->NumberOfDroppedFrames++;
+      }
+    else
+      {
+      this->NumberOfDroppedFrames++;
+      }
+    stream->Lock->Unlock();
+
+    if (!buffer)
+      {
+      continue;
+      }
+
+    window->GetPixelData(stream->Origin[0], stream->Origin[1],
+                         stream->Origin[0] + stream->Size[0] - 1,
+                         stream->Origin[1] + stream->Size[1] - 1,
+                         0, buffer);
+
+    stream->Lock->Lock();
+    stream->Queued.push_back(buffer);
+    stream->QueuedCondition->Signal();
+    stream->Lock->Unlock();
+    }
+
+  this->LastRecordTime = vtkTimerLog::GetUniversalTime() - startTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameRecorder::GetNumberOfWrittenFrames()
+{
+  this->CounterLock->Lock();
+  int written = this->NumberOfWrittenFrames;
+  this->CounterLock->Unlock();
+
+  return written;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelFrameRecorder::WriterMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  static_cast<vtkMultiChannelFrameRecorderStream*>(info->UserData)->WriterLoop();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameRecorder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "File Prefix: " << (this->FilePrefix ? this->FilePrefix : "(none)") << "\n";
+  os << indent << "Format: " << (this->Format == VTK_MULTICHANNEL_RECORD_Y4M ? "Y4M" : "Raw") << "\n";
+  os << indent << "Layout: " << (this->Layout == VTK_MULTICHANNEL_RECORD_CHANNELS ? "Channels" : "Composed") << "\n";
+  os << indent << "Drop Policy: " << this->DropPolicy << "\n";
+  os << indent << "Queue Length: " << this->QueueLength << "\n";
+  os << indent << "Frame Rate: " << this->FrameRate << "\n";
+  os << indent << "Recording: " << this->Recording << "\n";
+  os << indent << "Number Of Recorded Frames: " << this->NumberOfRecordedFrames << "\n";
+  os << indent << "Number Of Written Frames: " << this->NumberOfWrittenFrames << "\n";
+  os << indent << "Number Of Dropped Frames: " << this->NumberOfDroppedFrames << "\n";
+  os << indent << "Last Record Time: " << this->LastRecordTime << "\n";
+}
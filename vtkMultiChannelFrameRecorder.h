@@ -0,0 +1,172 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFrameRecorder.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelFrameRecorder
+// .SECTION Description
+// vtkMultiChannelFrameRecorder records the frames rendered by a
+// multi-channel window to disk.  Set it on the window's
+// vtkMultiChannelRenderWindowHelper and call Start().  After the
+// channels of a frame are rendered, the helper passes the window to
+// RecordFrame(), which reads the back buffer into a preallocated buffer
+// and queues it.  Conversion and file output are done by one writer
+// thread per stream, so rendering only pays for the read back into
+// buffers that are reused from frame to frame.
+//
+// Frames can be recorded as one stream for the whole window or as one
+// stream per channel, either as raw RGB24 or as YUV4MPEG2 (4:4:4)
+// files.  Raw streams can be read with, for example,
+// "ffmpeg -f rawvideo -pix_fmt rgb24 -s WxH".  Each stream holds at
+// most QueueLength frames.  When a queue is full, the DropPolicy
+// decides whether rendering waits for the writer, the new frame is
+// dropped, or the oldest queued frame is dropped.  Dropped frames are
+// counted.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper
+
+#ifndef __vtkMultiChannelFrameRecorder_h
+#define __vtkMultiChannelFrameRecorder_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+#include "vtkMultiThreader.h"   // For VTK_THREAD_RETURN_TYPE
+
+class vtkCollection;
+class vtkMultiChannelFrameRecorderInternals;
+class vtkMutexLock;
+class vtkRenderWindow;
+
+// Formats
+#define VTK_MULTICHANNEL_RECORD_RAW  0
+#define VTK_MULTICHANNEL_RECORD_Y4M  1
+
+// Layouts
+#define VTK_MULTICHANNEL_RECORD_COMPOSED  0
+#define VTK_MULTICHANNEL_RECORD_CHANNELS  1
+
+// Drop policies
+#define VTK_MULTICHANNEL_RECORD_BLOCK        0
+#define VTK_MULTICHANNEL_RECORD_DROP_NEWEST  1
+#define VTK_MULTICHANNEL_RECORD_DROP_OLDEST  2
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelFrameRecorder : public vtkObject
+{
+public:
+  static vtkMultiChannelFrameRecorder *New();
+  vtkTypeRevisionMacro(vtkMultiChannelFrameRecorder,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Prefix of the files written.  Composed streams are written to
+  // prefix.rgb or prefix.y4m, channel streams to prefix_N.rgb or
+  // prefix_N.y4m.
+  vtkSetStringMacro(FilePrefix);
+  vtkGetStringMacro(FilePrefix);
+
+  // Description:
+  // File format
+  vtkSetClampMacro(Format,int,VTK_MULTICHANNEL_RECORD_RAW,VTK_MULTICHANNEL_RECORD_Y4M);
+  vtkGetMacro(Format,int);
+  void SetFormatToRaw() { this->SetFormat(VTK_MULTICHANNEL_RECORD_RAW); }
+  void SetFormatToY4M() { this->SetFormat(VTK_MULTICHANNEL_RECORD_Y4M); }
+
+  // Description:
+  // Record the whole window, or each channel to its own stream
+  vtkSetClampMacro(Layout,int,VTK_MULTICHANNEL_RECORD_COMPOSED,VTK_MULTICHANNEL_RECORD_CHANNELS);
+  vtkGetMacro(Layout,int);
+  void SetLayoutToComposed() { this->SetLayout(VTK_MULTICHANNEL_RECORD_COMPOSED); }
+  void SetLayoutToChannels() { this->SetLayout(VTK_MULTICHANNEL_RECORD_CHANNELS); }
+
+  // Description:
+  // What to do when a stream's queue is full
+  vtkSetClampMacro(DropPolicy,int,VTK_MULTICHANNEL_RECORD_BLOCK,VTK_MULTICHANNEL_RECORD_DROP_OLDEST);
+  vtkGetMacro(DropPolicy,int);
+  void SetDropPolicyToBlock() { this->SetDropPolicy(VTK_MULTICHANNEL_RECORD_BLOCK); }
+  void SetDropPolicyToDropNewest() { this->SetDropPolicy(VTK_MULTICHANNEL_RECORD_DROP_NEWEST); }
+  void SetDropPolicyToDropOldest() { this->SetDropPolicy(VTK_MULTICHANNEL_RECORD_DROP_OLDEST); }
+
+  // Description:
+  // Maximum number of frames queued per stream
+  vtkSetClampMacro(QueueLength,int,1,VTK_INT_MAX);
+  vtkGetMacro(QueueLength,int);
+
+  // Description:
+  // Frame rate written to Y4M headers
+  vtkSetClampMacro(FrameRate,int,1,1000);
+  vtkGetMacro(FrameRate,int);
+
+  // Description:
+  // Start and stop recording.  Stop() waits for queued frames to be
+  // written.  Streams are opened on the first recorded frame.
+  void Start();
+  void Stop();
+  vtkGetMacro(Recording,int);
+
+  // Description:
+  // Read back and queue the frame rendered in the window's back buffer.
+  // Called by vtkMultiChannelRenderWindowHelper.
+  void RecordFrame(vtkRenderWindow*, vtkCollection* channels);
+
+  // Description:
+  // Frames recorded, written, and dropped since Start()
+  vtkGetMacro(NumberOfRecordedFrames,int);
+  int GetNumberOfWrittenFrames();
+  vtkGetMacro(NumberOfDroppedFrames,int);
+
+  // Description:
+  // Time in seconds spent in the last RecordFrame()
+  vtkGetMacro(LastRecordTime,double);
+
+protected:
+  vtkMultiChannelFrameRecorder();
+  ~vtkMultiChannelFrameRecorder();
+
+  char* FilePrefix;
+  int Format;
+  int Layout;
+  int DropPolicy;
+  int QueueLength;
+  int FrameRate;
+
+  int Recording;
+
+  int NumberOfRecordedFrames;
+  int NumberOfWrittenFrames;
+  int NumberOfDroppedFrames;
+
+  double LastRecordTime;
+
+  vtkMultiThreader* Threader;
+  vtkMutexLock* CounterLock;
+
+  vtkMultiChannelFrameRecorderInternals* Internals;
+  friend class vtkMultiChannelFrameRecorderStream;
+
+  // Description:
+  // Open one stream per region and start its writer
+  int OpenStreams(vtkRenderWindow*, vtkCollection* channels);
+  void CloseStreams();
+
+  // Description:
+  // Writer thread entry point
+  static VTK_THREAD_RETURN_TYPE WriterMain(void*);
+
+private:
+  vtkMultiChannelFrameRecorder(const vtkMultiChannelFrameRecorder&);  // Not implemented.
+  void operator=(const vtkMultiChannelFrameRecorder&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,309 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFrameStreamClient.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelFrameStreamClient.h"
+
+#include "vtkClientSocket.h"
+#include "vtkImageData.h"
+#include "vtkMultiChannelFrameStreamer.h"
+#include "vtkObjectFactory.h"
+
+#include "vtk_zlib.h"
+
+#include <string.h>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelFrameStreamClient, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelFrameStreamClient);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelFrameStreamClientInternals
+{
+public:
+  std::vector<vtkImageData*> Images;
+
+  std::vector<unsigned char> Encoded;
+  std::vector<unsigned char> Decoded;
+
+  void ClearImages()
+    {
+    for (unsigned int i = 0; i < this->Images.size(); i++)
+      {
+      this->Images[i]->Delete();
+      }
+    this->Images.clear();
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFrameStreamClient::vtkMultiChannelFrameStreamClient()
+{
+  this->Socket = NULL;
+
+  this->FrameNumber = -1;
+  this->NumberOfReceivedFrames = 0;
+  this->NumberOfReceivedTiles = 0;
+  this->NumberOfBytesReceived = 0;
+
+  this->Internals = new vtkMultiChannelFrameStreamClientInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFrameStreamClient::~vtkMultiChannelFrameStreamClient()
+{
+  this->Disconnect();
+
+  this->Internals->ClearImages();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameStreamClient::Connect(const char* host, int port)
+{
+  this->Disconnect();
+
+  this->Socket = vtkClientSocket::New();
+  if (this->Socket->ConnectToServer(host, port) != 0)
+    {
+    vtkErrorMacro(<< "Could not connect to " << host << ":" << port << ".");
+    this->Disconnect();
+    return 0;
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamClient::Disconnect()
+{
+  if (this->Socket)
+    {
+    this->Socket->CloseSocket();
+    this->Socket->Delete();
+    this->Socket = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameStreamClient::GetConnected()
+{
+  return this->Socket && this->Socket->GetConnected();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameStreamClient::Receive(void* data, int length)
+{
+  if (length <= 0)
+    {
+    return 1;
+    }
+
+  if (!this->Socket || !this->Socket->Receive(data, length))
+    {
+    this->Disconnect();
+    return 0;
+    }
+
+  this->NumberOfBytesReceived += length;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameStreamClient::ReceiveFrame()
+{
+  vtkMultiChannelFrameStreamClientInternals* internals = this->Internals;
+
+  int header[4];
+  if (!this->Receive(header, sizeof(header)))
+    {
+    return 0;
+    }
+
+  if (header[0] != VTK_MULTICHANNEL_STREAM_MAGIC)
+    {
+    vtkErrorMacro(<< "Not a frame.  The sender may have a different byte order.");
+    this->Disconnect();
+    return 0;
+    }
+
+  // Sizes come from the network, so are checked before they are used
+  int numberOfChannels = header[2];
+  int numberOfTiles = header[3];
+  if (numberOfChannels < 0 || numberOfChannels > VTK_MULTICHANNEL_STREAM_MAX_CHANNELS)
+    {
+    vtkErrorMacro(<< "Bad number of channels " << numberOfChannels << ".");
+    this->Disconnect();
+    return 0;
+    }
+
+  // Size the channel images
+  std::vector<int> sizes(numberOfChannels * 2);
+  if (numberOfChannels > 0 &&
+      !this->Receive(&sizes[0], numberOfChannels * 2 * sizeof(int)))
+    {
+    return 0;
+    }
+
+  double maxTiles = 0;
+  for (int c = 0; c < numberOfChannels; c++)
+    {
+    int width = sizes[c * 2];
+    int height = sizes[c * 2 + 1];
+    if (width < 0 || width > VTK_MULTICHANNEL_STREAM_MAX_DIMENSION ||
+        height < 0 || height > VTK_MULTICHANNEL_STREAM_MAX_DIMENSION)
+      {
+      vtkErrorMacro(<< "Bad size " << width << " x " << height
+                    << " for channel " << c << ".");
+      this->Disconnect();
+      return 0;
+      }
+
+    // Each tile is sent at most once per frame
+    int columns = (width + VTK_MULTICHANNEL_STREAM_MIN_TILE_SIZE - 1) / VTK_MULTICHANNEL_STREAM_MIN_TILE_SIZE;
+    int rows = (height + VTK_MULTICHANNEL_STREAM_MIN_TILE_SIZE - 1) / VTK_MULTICHANNEL_STREAM_MIN_TILE_SIZE;
+    maxTiles += static_cast<double>(columns) * rows;
+    }
+
+  if (numberOfTiles < 0 || numberOfTiles > maxTiles)
+    {
+    vtkErrorMacro(<< "Bad number of tiles " << numberOfTiles << ".");
+    this->Disconnect();
+    return 0;
+    }
+
+  if (static_cast<int>(internals->Images.size()) != numberOfChannels)
+    {
+    internals->ClearImages();
+    for (int c = 0; c < numberOfChannels; c++)
+      {
+      internals->Images.push_back(vtkImageData::New());
+      }
+    }
+
+  for (int c = 0; c < numberOfChannels; c++)
+    {
+    vtkImageData* image = internals->Images[c];
+    int* dimensions = image->GetDimensions();
+    if (dimensions[0] != sizes[c * 2] || dimensions[1] != sizes[c * 2 + 1] ||
+        !image->GetScalarPointer())
+      {
+      image->SetDimensions(sizes[c * 2], sizes[c * 2 + 1], 1);
+      image->SetScalarTypeToUnsignedChar();
+      image->SetNumberOfScalarComponents(3);
+      image->AllocateScalars();
+      }
+    }
+
+  // Apply the tiles
+  for (int i = 0; i < numberOfTiles; i++)
+    {
+    int tile[6];
+    if (!this->Receive(tile, sizeof(tile)))
+      {
+      return 0;
+      }
+
+    int channel = tile[0];
+    int x = tile[1];
+    int y = tile[2];
+    int width = tile[3];
+    int height = tile[4];
+    int size = tile[5];
+
+    if (channel < 0 || channel >= numberOfChannels ||
+        width <= 0 || width > VTK_MULTICHANNEL_STREAM_MAX_TILE_SIZE ||
+        height <= 0 || height > VTK_MULTICHANNEL_STREAM_MAX_TILE_SIZE ||
+        x < 0 || y < 0 ||
+        x > sizes[channel * 2] - width || y > sizes[channel * 2 + 1] - height ||
+        size < 0 || static_cast<uLong>(size) > compressBound(static_cast<uLong>(width * height * 3)))
+      {
+      vtkErrorMacro(<< "Bad tile " << i << ".");
+      this->Disconnect();
+      return 0;
+      }
+
+    internals->Encoded.resize(size > 0 ? size : 1);
+    if (!this->Receive(&internals->Encoded[0], size))
+      {
+      return 0;
+      }
+
+    // The streamer sends an empty tile when it could not compress it
+    if (size == 0)
+      {
+      continue;
+      }
+
+    int length = width * 3;
+    uLongf decodedSize = static_cast<uLongf>(length * height);
+    internals->Decoded.resize(decodedSize);
+    if (uncompress(&internals->Decoded[0], &decodedSize, &internals->Encoded[0], size) != Z_OK ||
+        decodedSize != static_cast<uLongf>(length * height))
+      {
+      vtkWarningMacro(<< "Could not decompress a tile.");
+      continue;
+      }
+
+    vtkImageData* image = internals->Images[channel];
+    for (int j = 0; j < height; j++)
+      {
+      memcpy(image->GetScalarPointer(x, y + j, 0), &internals->Decoded[j * length], length);
+      }
+
+    this->NumberOfReceivedTiles++;
+    }
+
+  for (int c = 0; c < numberOfChannels; c++)
+    {
+    internals->Images[c]->Modified();
+    }
+
+  this->FrameNumber = header[1];
+  this->NumberOfReceivedFrames++;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameStreamClient::GetNumberOfChannels()
+{
+  return static_cast<int>(this->Internals->Images.size());
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkMultiChannelFrameStreamClient::GetChannelImage(int i)
+{
+  if (i < 0 || i >= static_cast<int>(this->Internals->Images.size()))
+    {
+    return NULL;
+    }
+
+  return this->Internals->Images[i];
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamClient::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Connected: " << this->GetConnected() << "\n";
+  os << indent << "Number Of Channels: " << this->GetNumberOfChannels() << "\n";
+  os << indent << "Frame Number: " << this->FrameNumber << "\n";
+  os << indent << "Number Of Received Frames: " << this->NumberOfReceivedFrames << "\n";
+  os << indent << "Number Of Received Tiles: " << this->NumberOfReceivedTiles << "\n";
+  os << indent << "Number Of Bytes Received: " << this->NumberOfBytesReceived << "\n";
+}
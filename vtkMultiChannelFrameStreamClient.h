@@ -0,0 +1,93 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFrameStreamClient.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelFrameStreamClient
+// .SECTION Description
+// vtkMultiChannelFrameStreamClient receives the frames sent by a
+// vtkMultiChannelFrameStreamer, and keeps an RGB image of each channel
+// up to date with the tiles received.  It must run on a machine with
+// the same byte order as the sender.  Connecting to localhost gives a
+// loopback preview of the window.
+
+// .SECTION see also
+// vtkMultiChannelFrameStreamer
+
+#ifndef __vtkMultiChannelFrameStreamClient_h
+#define __vtkMultiChannelFrameStreamClient_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkClientSocket;
+class vtkImageData;
+class vtkMultiChannelFrameStreamClientInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelFrameStreamClient : public vtkObject
+{
+public:
+  static vtkMultiChannelFrameStreamClient *New();
+  vtkTypeRevisionMacro(vtkMultiChannelFrameStreamClient,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Connect to a streamer, and disconnect
+  int Connect(const char* host, int port);
+  void Disconnect();
+  int GetConnected();
+
+  // Description:
+  // Wait for the next frame and apply its tiles to the channel images.
+  // Returns 0 if the connection was lost, or if the data is not a frame
+  // or exceeds the streamer's limits, in which case the client
+  // disconnects.
+  int ReceiveFrame();
+
+  // Description:
+  // Channel images as of the last frame received
+  int GetNumberOfChannels();
+  vtkImageData* GetChannelImage(int);
+
+  // Description:
+  // Number of the last frame received, and the frames, tiles and bytes
+  // received
+  vtkGetMacro(FrameNumber,int);
+  vtkGetMacro(NumberOfReceivedFrames,int);
+  vtkGetMacro(NumberOfReceivedTiles,int);
+  vtkGetMacro(NumberOfBytesReceived,double);
+
+protected:
+  vtkMultiChannelFrameStreamClient();
+  ~vtkMultiChannelFrameStreamClient();
+
+  vtkClientSocket* Socket;
+
+  int FrameNumber;
+  int NumberOfReceivedFrames;
+  int NumberOfReceivedTiles;
+  double NumberOfBytesReceived;
+
+  vtkMultiChannelFrameStreamClientInternals* Internals;
+
+  // Description:
+  // Receive the given number of bytes.  Returns 0 on failure.
+  int Receive(void*, int length);
+
+private:
+  vtkMultiChannelFrameStreamClient(const vtkMultiChannelFrameStreamClient&);  // Not implemented.
+  void operator=(const vtkMultiChannelFrameStreamClient&);  // Not implemented.
+};
+
+#endif
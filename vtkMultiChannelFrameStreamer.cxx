@@ -0,0 +1,609 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFrameStreamer.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelFrameStreamer.h"
+
+#include "vtkClientSocket.h"
+#include "vtkCollection.h"
+#include "vtkConditionVariable.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowChannel.h"
+#include "vtkServerSocket.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+
+#include "vtk_zlib.h"
+
+#include <string.h>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelFrameStreamer, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelFrameStreamer);
+
+// Encoder passes
+#define VTK_MULTICHANNEL_STREAM_HASH    0
+#define VTK_MULTICHANNEL_STREAM_ENCODE  1
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelFrameStreamerInternals
+{
+public:
+  struct Tile
+  {
+    int Channel;
+    int X;
+    int Y;
+    int Width;
+    int Height;
+
+    // Hash of the tile as last sent, and in the current frame
+    vtkTypeUInt64 SentHash;
+    vtkTypeUInt64 Hash;
+
+    std::vector<unsigned char> Encoded;
+  };
+
+  // Pixel region of each channel, as (x,y,width,height)
+  std::vector<int> Regions;
+  std::vector<vtkUnsignedCharArray*> Pixels;
+
+  std::vector<Tile> Tiles;
+  std::vector<int> ChangedTiles;
+  int Pass;
+  int KeyFrame;
+
+  // Shared with the network threads, under the lock.  Clients accepted
+  // wait in NewClients until they are attached with a key frame.
+  std::vector<vtkClientSocket*> Clients;
+  std::vector<vtkClientSocket*> NewClients;
+  std::vector<unsigned char> Message;
+  int HasMessage;
+
+  int FrameNumber;
+
+  void ClearPixels()
+    {
+    for (unsigned int i = 0; i < this->Pixels.size(); i++)
+      {
+      this->Pixels[i]->Delete();
+      }
+    this->Pixels.clear();
+    }
+};
+
+//----------------------------------------------------------------------------
+// 64-bit FNV-1a over a tile's rows, a word at a time
+static vtkTypeUInt64 vtkMultiChannelFrameStreamerHash(const unsigned char* pixels, int rowLength,
+                                                      int x, int y, int width, int height)
+{
+  vtkTypeUInt64 hash = 14695981039346656037ULL;
+  const vtkTypeUInt64 prime = 1099511628211ULL;
+
+  int length = width * 3;
+  for (int j = 0; j < height; j++)
+    {
+    const unsigned char* row = pixels + ((y + j) * rowLength + x) * 3;
+
+    int i = 0;
+    for (; i + 8 <= length; i += 8)
+      {
+      vtkTypeUInt64 word;
+      memcpy(&word, row + i, 8);
+      hash = (hash ^ word) * prime;
+      }
+    for (; i < length; i++)
+      {
+      hash = (hash ^ row[i]) * prime;
+      }
+    }
+
+  return hash;
+}
+
+//----------------------------------------------------------------------------
+static void vtkMultiChannelFrameStreamerAppend(std::vector<unsigned char>& message, int value)
+{
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+  message.insert(message.end(), bytes, bytes + sizeof(int));
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFrameStreamer::vtkMultiChannelFrameStreamer()
+{
+  this->Port = 11112;
+  this->TileSize = 64;
+  this->CompressionLevel = 1;
+  this->NumberOfEncoderThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  this->Running = 0;
+  this->StopRequested = 0;
+
+  this->NumberOfSentFrames = 0;
+  this->NumberOfDroppedFrames = 0;
+  this->NumberOfTiles = 0;
+  this->NumberOfChangedTiles = 0;
+  this->NumberOfBytesSent = 0;
+  this->LastEncodeTime = 0;
+
+  this->Server = vtkServerSocket::New();
+
+  this->Threader = vtkMultiThreader::New();
+  this->Encoders = vtkMultiThreader::New();
+  this->ListenThreadId = -1;
+  this->SendThreadId = -1;
+  this->Lock = vtkMutexLock::New();
+  this->SendCondition = vtkConditionVariable::New();
+
+  this->Internals = new vtkMultiChannelFrameStreamerInternals;
+  this->Internals->Pass = VTK_MULTICHANNEL_STREAM_HASH;
+  this->Internals->KeyFrame = 1;
+  this->Internals->HasMessage = 0;
+  this->Internals->FrameNumber = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelFrameStreamer::~vtkMultiChannelFrameStreamer()
+{
+  this->Stop();
+
+  this->Internals->ClearPixels();
+
+  this->Server->Delete();
+
+  this->Threader->Delete();
+  this->Encoders->Delete();
+  this->Lock->Delete();
+  this->SendCondition->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameStreamer::Start()
+{
+  if (this->Running)
+    {
+    return 1;
+    }
+
+  if (this->Server->CreateServer(this->Port) != 0)
+    {
+    vtkErrorMacro(<< "Could not listen on port " << this->Port << ".");
+    return 0;
+    }
+
+  this->StopRequested = 0;
+  this->Internals->HasMessage = 0;
+  this->Running = 1;
+
+  this->ListenThreadId = this->Threader->SpawnThread(&vtkMultiChannelFrameStreamer::ListenMain, this);
+  this->SendThreadId = this->Threader->SpawnThread(&vtkMultiChannelFrameStreamer::SendMain, this);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamer::Stop()
+{
+  if (!this->Running)
+    {
+    return;
+    }
+
+  this->Lock->Lock();
+  this->StopRequested = 1;
+  this->SendCondition->Broadcast();
+  this->Lock->Unlock();
+
+  this->Threader->TerminateThread(this->ListenThreadId);
+  this->Threader->TerminateThread(this->SendThreadId);
+  this->ListenThreadId = -1;
+  this->SendThreadId = -1;
+
+  for (unsigned int i = 0; i < this->Internals->Clients.size(); i++)
+    {
+    this->Internals->Clients[i]->CloseSocket();
+    this->Internals->Clients[i]->Delete();
+    }
+  this->Internals->Clients.clear();
+  for (unsigned int i = 0; i < this->Internals->NewClients.size(); i++)
+    {
+    this->Internals->NewClients[i]->CloseSocket();
+    this->Internals->NewClients[i]->Delete();
+    }
+  this->Internals->NewClients.clear();
+
+  this->Server->CloseSocket();
+
+  this->Running = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelFrameStreamer::GetNumberOfClients()
+{
+  this->Lock->Lock();
+  int clients = static_cast<int>(this->Internals->Clients.size() +
+                                 this->Internals->NewClients.size());
+  this->Lock->Unlock();
+
+  return clients;
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelFrameStreamer::GetNumberOfBytesSent()
+{
+  this->Lock->Lock();
+  double bytes = this->NumberOfBytesSent;
+  this->Lock->Unlock();
+
+  return bytes;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamer::SendFrame(vtkRenderWindow* window, vtkCollection* channels)
+{
+  if (!this->Running || !window)
+    {
+    return;
+    }
+
+  vtkMultiChannelFrameStreamerInternals* internals = this->Internals;
+
+  // Clients accepted from here on wait for the next frame, as this one
+  // may not be a key frame
+  this->Lock->Lock();
+  int numberOfClients = static_cast<int>(internals->Clients.size() + internals->NewClients.size());
+  int busy = internals->HasMessage;
+  std::vector<vtkClientSocket*> newClients;
+  if (!busy)
+    {
+    newClients.swap(internals->NewClients);
+    }
+  this->Lock->Unlock();
+
+  if (numberOfClients == 0)
+    {
+    return;
+    }
+
+  // The tiles not sent are sent with the next frame
+  if (busy)
+    {
+    this->NumberOfDroppedFrames++;
+    return;
+    }
+
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  // Pixel regions to send
+  int* size = window->GetSize();
+  std::vector<int> regions;
+  if (channels && channels->GetNumberOfItems() > 0)
+    {
+    for (int i = 0; i < channels->GetNumberOfItems(); i++)
+      {
+      vtkRenderWindowChannel* channel =
+        vtkRenderWindowChannel::SafeDownCast(channels->GetItemAsObject(i));
+      int region[4];
+      channel->GetPixelRegion(size, region);
+      regions.insert(regions.end(), region, region + 4);
+      }
+    }
+  else
+    {
+    regions.push_back(0);
+    regions.push_back(0);
+    regions.push_back(size[0]);
+    regions.push_back(size[1]);
+    }
+
+  // Clients reject frames beyond the stream limits
+  int fits = static_cast<int>(regions.size() / 4) <= VTK_MULTICHANNEL_STREAM_MAX_CHANNELS;
+  for (unsigned int c = 0; fits && c < regions.size() / 4; c++)
+    {
+    fits = regions[c * 4 + 2] <= VTK_MULTICHANNEL_STREAM_MAX_DIMENSION &&
+           regions[c * 4 + 3] <= VTK_MULTICHANNEL_STREAM_MAX_DIMENSION;
+    }
+  if (!fits)
+    {
+    vtkErrorMacro(<< "The channels exceed the stream limits.  Not sending.");
+    this->Lock->Lock();
+    internals->NewClients.insert(internals->NewClients.begin(), newClients.begin(), newClients.end());
+    this->Lock->Unlock();
+    return;
+    }
+
+  // Split the channels into tiles when their layout changes
+  if (regions != internals->Regions)
+    {
+    internals->Regions = regions;
+    internals->Tiles.clear();
+    internals->ClearPixels();
+
+    for (unsigned int c = 0; c < regions.size() / 4; c++)
+      {
+      internals->Pixels.push_back(vtkUnsignedCharArray::New());
+
+      int width = regions[c * 4 + 2];
+      int height = regions[c * 4 + 3];
+      for (int y = 0; y < height; y += this->TileSize)
+        {
+        for (int x = 0; x < width; x += this->TileSize)
+          {
+          vtkMultiChannelFrameStreamerInternals::Tile tile;
+          tile.Channel = c;
+          tile.X = x;
+          tile.Y = y;
+          tile.Width = width - x < this->TileSize ? width - x : this->TileSize;
+          tile.Height = height - y < this->TileSize ? height - y : this->TileSize;
+          tile.SentHash = 0;
+          tile.Hash = 0;
+          internals->Tiles.push_back(tile);
+          }
+        }
+      }
+
+    internals->KeyFrame = 1;
+    }
+
+  if (!newClients.empty())
+    {
+    internals->KeyFrame = 1;
+    }
+
+  // Read back
+  for (unsigned int c = 0; c < internals->Pixels.size(); c++)
+    {
+    int* region = &internals->Regions[c * 4];
+    if (region[2] > 0 && region[3] > 0)
+      {
+      window->GetPixelData(region[0], region[1],
+                           region[0] + region[2] - 1, region[1] + region[3] - 1,
+                           0, internals->Pixels[c]);
+      }
+    }
+
+  // Find the changed tiles, then compress them
+  this->Encoders->SetNumberOfThreads(this->NumberOfEncoderThreads);
+  this->Encoders->SetSingleMethod(&vtkMultiChannelFrameStreamer::EncodeMain, this);
+
+  internals->Pass = VTK_MULTICHANNEL_STREAM_HASH;
+  this->Encoders->SingleMethodExecute();
+
+  internals->ChangedTiles.clear();
+  for (unsigned int i = 0; i < internals->Tiles.size(); i++)
+    {
+    vtkMultiChannelFrameStreamerInternals::Tile& tile = internals->Tiles[i];
+    if (internals->KeyFrame || tile.Hash != tile.SentHash)
+      {
+      internals->ChangedTiles.push_back(static_cast<int>(i));
+      }
+    }
+
+  internals->Pass = VTK_MULTICHANNEL_STREAM_ENCODE;
+  this->Encoders->SingleMethodExecute();
+
+  // Build the message
+  std::vector<unsigned char> message;
+  vtkMultiChannelFrameStreamerAppend(message, VTK_MULTICHANNEL_STREAM_MAGIC);
+  vtkMultiChannelFrameStreamerAppend(message, internals->FrameNumber++);
+  vtkMultiChannelFrameStreamerAppend(message, static_cast<int>(internals->Regions.size() / 4));
+  vtkMultiChannelFrameStreamerAppend(message, static_cast<int>(internals->ChangedTiles.size()));
+  for (unsigned int c = 0; c < internals->Regions.size() / 4; c++)
+    {
+    vtkMultiChannelFrameStreamerAppend(message, internals->Regions[c * 4 + 2]);
+    vtkMultiChannelFrameStreamerAppend(message, internals->Regions[c * 4 + 3]);
+    }
+  for (unsigned int i = 0; i < internals->ChangedTiles.size(); i++)
+    {
+    vtkMultiChannelFrameStreamerInternals::Tile& tile = internals->Tiles[internals->ChangedTiles[i]];
+    vtkMultiChannelFrameStreamerAppend(message, tile.Channel);
+    vtkMultiChannelFrameStreamerAppend(message, tile.X);
+    vtkMultiChannelFrameStreamerAppend(message, tile.Y);
+    vtkMultiChannelFrameStreamerAppend(message, tile.Width);
+    vtkMultiChannelFrameStreamerAppend(message, tile.Height);
+    vtkMultiChannelFrameStreamerAppend(message, static_cast<int>(tile.Encoded.size()));
+    message.insert(message.end(), tile.Encoded.begin(), tile.Encoded.end());
+
+    tile.SentHash = tile.Hash;
+    }
+
+  // Hand it to the network thread, with the new clients attached
+  this->Lock->Lock();
+  internals->Clients.insert(internals->Clients.end(), newClients.begin(), newClients.end());
+  internals->Message.swap(message);
+  internals->HasMessage = 1;
+  this->SendCondition->Signal();
+  this->Lock->Unlock();
+
+  internals->KeyFrame = 0;
+
+  this->NumberOfSentFrames++;
+  this->NumberOfTiles = static_cast<int>(internals->Tiles.size());
+  this->NumberOfChangedTiles = static_cast<int>(internals->ChangedTiles.size());
+  this->LastEncodeTime = vtkTimerLog::GetUniversalTime() - startTime;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelFrameStreamer::EncodeMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkMultiChannelFrameStreamer* self = static_cast<vtkMultiChannelFrameStreamer*>(info->UserData);
+  self->EncodeTiles(info->ThreadID, info->NumberOfThreads);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamer::EncodeTiles(int threadId, int numberOfThreads)
+{
+  vtkMultiChannelFrameStreamerInternals* internals = this->Internals;
+
+  if (internals->Pass == VTK_MULTICHANNEL_STREAM_HASH)
+    {
+    for (unsigned int i = threadId; i < internals->Tiles.size(); i += numberOfThreads)
+      {
+      vtkMultiChannelFrameStreamerInternals::Tile& tile = internals->Tiles[i];
+      const unsigned char* pixels = internals->Pixels[tile.Channel]->GetPointer(0);
+      tile.Hash = vtkMultiChannelFrameStreamerHash(pixels, internals->Regions[tile.Channel * 4 + 2],
+                                                   tile.X, tile.Y, tile.Width, tile.Height);
+      }
+    return;
+    }
+
+  // Tiles are not contiguous in the channel image
+  std::vector<unsigned char> scratch;
+
+  for (unsigned int i = threadId; i < internals->ChangedTiles.size(); i += numberOfThreads)
+    {
+    vtkMultiChannelFrameStreamerInternals::Tile& tile = internals->Tiles[internals->ChangedTiles[i]];
+    const unsigned char* pixels = internals->Pixels[tile.Channel]->GetPointer(0);
+    int rowLength = internals->Regions[tile.Channel * 4 + 2];
+
+    int length = tile.Width * 3;
+    scratch.resize(length * tile.Height);
+    for (int j = 0; j < tile.Height; j++)
+      {
+      memcpy(&scratch[j * length], pixels + ((tile.Y + j) * rowLength + tile.X) * 3, length);
+      }
+
+    uLongf size = compressBound(static_cast<uLong>(scratch.size()));
+    tile.Encoded.resize(size);
+    if (compress2(&tile.Encoded[0], &size, &scratch[0], static_cast<uLong>(scratch.size()),
+                  this->CompressionLevel) != Z_OK)
+      {
+      size = 0;
+      }
+    tile.Encoded.resize(size);
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelFrameStreamer::ListenMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  static_cast<vtkMultiChannelFrameStreamer*>(info->UserData)->ListenLoop();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamer::ListenLoop()
+{
+  for (;;)
+    {
+    this->Lock->Lock();
+    int stop = this->StopRequested;
+    this->Lock->Unlock();
+    if (stop)
+      {
+      break;
+      }
+
+    // Time out to check for stopping
+    vtkClientSocket* client = this->Server->WaitForConnection(250);
+    if (client)
+      {
+      this->Lock->Lock();
+      this->Internals->NewClients.push_back(client);
+      this->Lock->Unlock();
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelFrameStreamer::SendMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  static_cast<vtkMultiChannelFrameStreamer*>(info->UserData)->SendLoop();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamer::SendLoop()
+{
+  vtkMultiChannelFrameStreamerInternals* internals = this->Internals;
+
+  std::vector<unsigned char> message;
+
+  this->Lock->Lock();
+  while (!this->StopRequested)
+    {
+    if (!internals->HasMessage)
+      {
+      this->SendCondition->Wait(this->Lock);
+      continue;
+      }
+
+    // Clients are only removed by this thread
+    message.swap(internals->Message);
+    std::vector<vtkClientSocket*> clients = internals->Clients;
+    this->Lock->Unlock();
+
+    std::vector<vtkClientSocket*> failed;
+    double bytes = 0;
+    for (unsigned int i = 0; i < clients.size(); i++)
+      {
+      if (clients[i]->Send(&message[0], static_cast<int>(message.size())))
+        {
+        bytes += message.size();
+        }
+      else
+        {
+        failed.push_back(clients[i]);
+        }
+      }
+
+    this->Lock->Lock();
+    for (unsigned int i = 0; i < failed.size(); i++)
+      {
+      for (unsigned int j = 0; j < internals->Clients.size(); j++)
+        {
+        if (internals->Clients[j] == failed[i])
+          {
+          internals->Clients.erase(internals->Clients.begin() + j);
+          break;
+          }
+        }
+      failed[i]->CloseSocket();
+      failed[i]->Delete();
+      }
+    this->NumberOfBytesSent += bytes;
+    internals->HasMessage = 0;
+    }
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelFrameStreamer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Port: " << this->Port << "\n";
+  os << indent << "Tile Size: " << this->TileSize << "\n";
+  os << indent << "Compression Level: " << this->CompressionLevel << "\n";
+  os << indent << "Number Of Encoder Threads: " << this->NumberOfEncoderThreads << "\n";
+  os << indent << "Running: " << this->Running << "\n";
+  os << indent << "Number Of Sent Frames: " << this->NumberOfSentFrames << "\n";
+  os << indent << "Number Of Dropped Frames: " << this->NumberOfDroppedFrames << "\n";
+  os << indent << "Number Of Tiles: " << this->NumberOfTiles << "\n";
+  os << indent << "Number Of Changed Tiles: " << this->NumberOfChangedTiles << "\n";
+  os << indent << "Number Of Bytes Sent: " << this->NumberOfBytesSent << "\n";
+  os << indent << "Last Encode Time: " << this->LastEncodeTime << "\n";
+}
@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelFrameStreamer.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelFrameStreamer
+// .SECTION Description
+// vtkMultiChannelFrameStreamer sends the channel images of each frame to
+// remote preview clients, such as vtkMultiChannelFrameStreamClient.
+// Each channel image is split into tiles of TileSize pixels, and each
+// tile is hashed.  Only the tiles whose hash differs from the last frame
+// sent are compressed, with zlib by a pool of encoder threads, so the
+// cost of encoding follows what changed rather than the window size.
+// Clients that connect are attached with the next frame, which is sent
+// with every tile, so a client never receives changes relative to a
+// frame it did not see.
+//
+// Set on a vtkMultiChannelRenderWindowHelper, SendFrame() is called once
+// all of a frame's channels are rendered.  Nothing is read back while no
+// client is connected.  Frames are sent by a network thread.  If it is
+// still sending the previous frame, the new one is dropped, and the next
+// frame sent carries every tile changed since the last one sent.
+//
+// Each frame is sent as 32-bit integers in the sender's byte order: the
+// magic number VTK_MULTICHANNEL_STREAM_MAGIC, the frame number, the number
+// of channels and the number of tiles; the width and height of each
+// channel; then for each tile its channel, x, y, width, height and
+// compressed size, followed by the compressed RGB pixels, bottom row
+// first.  Frames with more than VTK_MULTICHANNEL_STREAM_MAX_CHANNELS
+// channels, or channels larger than VTK_MULTICHANNEL_STREAM_MAX_DIMENSION,
+// are not sent.
+
+// .SECTION see also
+// vtkMultiChannelFrameStreamClient vtkMultiChannelFrameRecorder
+// vtkMultiChannelRenderWindowHelper
+
+#ifndef __vtkMultiChannelFrameStreamer_h
+#define __vtkMultiChannelFrameStreamer_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+#include "vtkMultiThreader.h"   // For VTK_THREAD_RETURN_TYPE
+
+#define VTK_MULTICHANNEL_STREAM_MAGIC 0x564d4346
+
+// Limits on the frames sent, which clients check frames against
+#define VTK_MULTICHANNEL_STREAM_MAX_CHANNELS   64
+#define VTK_MULTICHANNEL_STREAM_MAX_DIMENSION  16384
+#define VTK_MULTICHANNEL_STREAM_MIN_TILE_SIZE  8
+#define VTK_MULTICHANNEL_STREAM_MAX_TILE_SIZE  1024
+
+class vtkCollection;
+class vtkConditionVariable;
+class vtkMultiChannelFrameStreamerInternals;
+class vtkMutexLock;
+class vtkRenderWindow;
+class vtkServerSocket;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelFrameStreamer : public vtkObject
+{
+public:
+  static vtkMultiChannelFrameStreamer *New();
+  vtkTypeRevisionMacro(vtkMultiChannelFrameStreamer,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Port to listen on for clients
+  vtkSetMacro(Port,int);
+  vtkGetMacro(Port,int);
+
+  // Description:
+  // Width and height of the tiles in pixels
+  vtkSetClampMacro(TileSize,int,VTK_MULTICHANNEL_STREAM_MIN_TILE_SIZE,VTK_MULTICHANNEL_STREAM_MAX_TILE_SIZE);
+  vtkGetMacro(TileSize,int);
+
+  // Description:
+  // zlib compression level.  1 is fastest.
+  vtkSetClampMacro(CompressionLevel,int,1,9);
+  vtkGetMacro(CompressionLevel,int);
+
+  // Description:
+  // Number of threads compressing tiles
+  vtkSetClampMacro(NumberOfEncoderThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfEncoderThreads,int);
+
+  // Description:
+  // Start and stop listening for clients and sending frames
+  int Start();
+  void Stop();
+  vtkGetMacro(Running,int);
+
+  // Description:
+  // Send the changed tiles of the channels' images.  Called by the helper
+  // once all of a frame's channels are rendered.
+  void SendFrame(vtkRenderWindow*, vtkCollection* channels);
+
+  // Description:
+  // Number of clients connected, including those not yet attached
+  int GetNumberOfClients();
+
+  // Description:
+  // Frames sent and dropped, tiles in the last frame sent and those
+  // changed, and bytes sent
+  vtkGetMacro(NumberOfSentFrames,int);
+  vtkGetMacro(NumberOfDroppedFrames,int);
+  vtkGetMacro(NumberOfTiles,int);
+  vtkGetMacro(NumberOfChangedTiles,int);
+  double GetNumberOfBytesSent();
+
+  // Description:
+  // Seconds spent reading back, hashing and compressing the last frame
+  vtkGetMacro(LastEncodeTime,double);
+
+protected:
+  vtkMultiChannelFrameStreamer();
+  ~vtkMultiChannelFrameStreamer();
+
+  int Port;
+  int TileSize;
+  int CompressionLevel;
+  int NumberOfEncoderThreads;
+
+  int Running;
+  int StopRequested;
+
+  int NumberOfSentFrames;
+  int NumberOfDroppedFrames;
+  int NumberOfTiles;
+  int NumberOfChangedTiles;
+  double NumberOfBytesSent;
+  double LastEncodeTime;
+
+  vtkServerSocket* Server;
+
+  vtkMultiThreader* Threader;
+  vtkMultiThreader* Encoders;
+  int ListenThreadId;
+  int SendThreadId;
+  vtkMutexLock* Lock;
+  vtkConditionVariable* SendCondition;
+
+  vtkMultiChannelFrameStreamerInternals* Internals;
+
+  // Description:
+  // Thread entry points and loops
+  static VTK_THREAD_RETURN_TYPE ListenMain(void*);
+  static VTK_THREAD_RETURN_TYPE SendMain(void*);
+  static VTK_THREAD_RETURN_TYPE EncodeMain(void*);
+  void ListenLoop();
+  void SendLoop();
+  void EncodeTiles(int threadId, int numberOfThreads);
+
+private:
+  vtkMultiChannelFrameStreamer(const vtkMultiChannelFrameStreamer&);  // Not implemented.
+  void operator=(const vtkMultiChannelFrameStreamer&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,254 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelGLStateCache.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelGLStateCache.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkOpenGL.h"
+
+#include <map>
+
+vtkCxxRevisionMacro(vtkMultiChannelGLStateCache, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelGLStateCache);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelGLStateCacheInternals
+{
+public:
+  void Invalidate()
+    {
+    this->HasDrawBuffer = 0;
+    this->HasReadBuffer = 0;
+    this->HasViewport = 0;
+    this->HasScissor = 0;
+    this->Capabilities.clear();
+    }
+
+  int HasDrawBuffer;
+  GLenum DrawBuffer;
+
+  int HasReadBuffer;
+  GLenum ReadBuffer;
+
+  int HasViewport;
+  int Viewport[4];
+
+  int HasScissor;
+  int Scissor[4];
+
+  // Known capabilities and whether they are enabled
+  std::map<GLenum, int> Capabilities;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelGLStateCache::vtkMultiChannelGLStateCache()
+{
+  this->Enabled = 1;
+  this->InFrame = 0;
+
+  this->NumberOfIssuedCalls = 0;
+  this->NumberOfSuppressedCalls = 0;
+
+  this->Internals = new vtkMultiChannelGLStateCacheInternals;
+  this->Internals->Invalidate();
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelGLStateCache::~vtkMultiChannelGLStateCache()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::BeginFrame()
+{
+  // Anything may have changed since the last frame
+  this->Internals->Invalidate();
+  this->InFrame = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::EndFrame()
+{
+  this->InFrame = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::Invalidate()
+{
+  this->Internals->Invalidate();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::Synchronize()
+{
+  // Nothing is skipped outside a frame
+  if (!this->InFrame)
+    {
+    return;
+    }
+
+  vtkMultiChannelGLStateCacheInternals* internals = this->Internals;
+
+  GLint value;
+  glGetIntegerv(GL_DRAW_BUFFER, &value);
+  internals->DrawBuffer = static_cast<GLenum>(value);
+  internals->HasDrawBuffer = 1;
+
+  glGetIntegerv(GL_READ_BUFFER, &value);
+  internals->ReadBuffer = static_cast<GLenum>(value);
+  internals->HasReadBuffer = 1;
+
+  GLint box[4];
+  glGetIntegerv(GL_VIEWPORT, box);
+  for (int i = 0; i < 4; i++)
+    {
+    internals->Viewport[i] = box[i];
+    }
+  internals->HasViewport = 1;
+
+  glGetIntegerv(GL_SCISSOR_BOX, box);
+  for (int i = 0; i < 4; i++)
+    {
+    internals->Scissor[i] = box[i];
+    }
+  internals->HasScissor = 1;
+
+  std::map<GLenum, int>::iterator it;
+  for (it = internals->Capabilities.begin(); it != internals->Capabilities.end(); ++it)
+    {
+    it->second = glIsEnabled(it->first) ? 1 : 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelGLStateCache::Issue(int redundant)
+{
+  if (redundant && this->Enabled && this->InFrame)
+    {
+    this->NumberOfSuppressedCalls++;
+    return 0;
+    }
+
+  this->NumberOfIssuedCalls++;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::DrawBuffer(unsigned int buffer)
+{
+  vtkMultiChannelGLStateCacheInternals* internals = this->Internals;
+
+  if (this->Issue(internals->HasDrawBuffer && internals->DrawBuffer == buffer))
+    {
+    glDrawBuffer(static_cast<GLenum>(buffer));
+    internals->DrawBuffer = buffer;
+    internals->HasDrawBuffer = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::ReadBuffer(unsigned int buffer)
+{
+  vtkMultiChannelGLStateCacheInternals* internals = this->Internals;
+
+  if (this->Issue(internals->HasReadBuffer && internals->ReadBuffer == buffer))
+    {
+    glReadBuffer(static_cast<GLenum>(buffer));
+    internals->ReadBuffer = buffer;
+    internals->HasReadBuffer = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::Viewport(int x, int y, int width, int height)
+{
+  vtkMultiChannelGLStateCacheInternals* internals = this->Internals;
+  int* v = internals->Viewport;
+
+  if (this->Issue(internals->HasViewport &&
+                  v[0] == x && v[1] == y && v[2] == width && v[3] == height))
+    {
+    glViewport(x, y, width, height);
+    v[0] = x;
+    v[1] = y;
+    v[2] = width;
+    v[3] = height;
+    internals->HasViewport = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::Scissor(int x, int y, int width, int height)
+{
+  vtkMultiChannelGLStateCacheInternals* internals = this->Internals;
+  int* s = internals->Scissor;
+
+  if (this->Issue(internals->HasScissor &&
+                  s[0] == x && s[1] == y && s[2] == width && s[3] == height))
+    {
+    glScissor(x, y, width, height);
+    s[0] = x;
+    s[1] = y;
+    s[2] = width;
+    s[3] = height;
+    internals->HasScissor = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::Enable(unsigned int capability)
+{
+  std::map<GLenum, int>& capabilities = this->Internals->Capabilities;
+  std::map<GLenum, int>::iterator it = capabilities.find(capability);
+
+  if (this->Issue(it != capabilities.end() && it->second))
+    {
+    glEnable(static_cast<GLenum>(capability));
+    capabilities[capability] = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::Disable(unsigned int capability)
+{
+  std::map<GLenum, int>& capabilities = this->Internals->Capabilities;
+  std::map<GLenum, int>::iterator it = capabilities.find(capability);
+
+  if (this->Issue(it != capabilities.end() && !it->second))
+    {
+    glDisable(static_cast<GLenum>(capability));
+    capabilities[capability] = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::ResetCounters()
+{
+  this->NumberOfIssuedCalls = 0;
+  this->NumberOfSuppressedCalls = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGLStateCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Enabled: " << this->Enabled << "\n";
+  os << indent << "In Frame: " << this->InFrame << "\n";
+  os << indent << "Number Of Issued Calls: " << this->NumberOfIssuedCalls << "\n";
+  os << indent << "Number Of Suppressed Calls: " << this->NumberOfSuppressedCalls << "\n";
+}
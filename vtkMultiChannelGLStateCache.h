@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelGLStateCache.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelGLStateCache
+// .SECTION Description
+// vtkMultiChannelGLStateCache remembers the draw and read buffers,
+// viewport, scissor box and enabled capabilities it last set in a
+// context, and skips setting them again to the same values.
+// Consecutive channels usually draw to the same buffers, and channels
+// sharing a viewport set the same viewport and scissor box.  With
+// software OpenGL, each of these calls is expensive even when nothing
+// changes.
+//
+// Each vtkWin32OpenGLMultiChannelRenderWindow has a cache for its
+// context.  The cache only skips calls between BeginFrame() and
+// EndFrame(), which the window calls around the channels.  Outside a
+// frame, and after Invalidate(), every call is made.  Call Invalidate()
+// or Synchronize() after any code that may set the same state directly,
+// such as props, mappers, and framebuffer object passes.  The helper
+// synchronizes after each renderer draws a channel, so the camera's
+// state is skipped where the next channel sets the same.  The matrix
+// mode is not cached, as the camera leaves it as GL_MODELVIEW after
+// setting the projection.
+
+// .SECTION see also
+// vtkWin32OpenGLMultiChannelRenderWindow vtkOpenGLMultiChannelCamera
+// vtkOpenGLMultiChannelRenderer
+
+#ifndef __vtkMultiChannelGLStateCache_h
+#define __vtkMultiChannelGLStateCache_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkMultiChannelGLStateCacheInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelGLStateCache : public vtkObject
+{
+public:
+  static vtkMultiChannelGLStateCache *New();
+  vtkTypeRevisionMacro(vtkMultiChannelGLStateCache,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Turn skipping redundant calls on or off.  When off, calls are still
+  // counted.
+  vtkSetMacro(Enabled,int);
+  vtkGetMacro(Enabled,int);
+  vtkBooleanMacro(Enabled,int);
+
+  // Description:
+  // Start and end skipping redundant calls.  Called by the window
+  // around the channels of each frame.
+  void BeginFrame();
+  void EndFrame();
+
+  // Description:
+  // Forget the state, as it may have been set without the cache
+  void Invalidate();
+
+  // Description:
+  // Read the state back from OpenGL, as it may have been set without the
+  // cache.  State left as the cache set it stays known, so the next
+  // calls setting the same values are still skipped.  Does nothing
+  // outside a frame.
+  void Synchronize();
+
+  // Description:
+  // Set state unless already set to the same values
+  void DrawBuffer(unsigned int buffer);
+  void ReadBuffer(unsigned int buffer);
+  void Viewport(int x, int y, int width, int height);
+  void Scissor(int x, int y, int width, int height);
+  void Enable(unsigned int capability);
+  void Disable(unsigned int capability);
+
+  // Description:
+  // Calls made and skipped since the counters were reset
+  vtkGetMacro(NumberOfIssuedCalls,int);
+  vtkGetMacro(NumberOfSuppressedCalls,int);
+  void ResetCounters();
+
+protected:
+  vtkMultiChannelGLStateCache();
+  ~vtkMultiChannelGLStateCache();
+
+  int Enabled;
+  int InFrame;
+
+  int NumberOfIssuedCalls;
+  int NumberOfSuppressedCalls;
+
+  vtkMultiChannelGLStateCacheInternals* Internals;
+
+  // Description:
+  // Count a call, and return whether it has to be made
+  int Issue(int redundant);
+
+private:
+  vtkMultiChannelGLStateCache(const vtkMultiChannelGLStateCache&);  // Not implemented.
+  void operator=(const vtkMultiChannelGLStateCache&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,282 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelGeometryCache.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelGeometryCache.h"
+
+#include "vtkAbstractVolumeMapper.h"
+#include "vtkActor.h"
+#include "vtkDataSet.h"
+#include "vtkMapper.h"
+#include "vtkObjectFactory.h"
+#include "vtkProperty.h"
+#include "vtkVolume.h"
+
+#include <map>
+
+vtkCxxRevisionMacro(vtkMultiChannelGeometryCache, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelGeometryCache);
+
+// Mappers not rendered for this many frames are released
+#define VTK_MULTICHANNEL_GEOMETRY_CACHE_AGE 64
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelGeometryCacheInternals
+{
+public:
+  struct Entry
+  {
+    unsigned long Stamp;
+    vtkWindow* Window;
+    int LastFrame;
+    int Locked;
+    double Size;
+  };
+
+  typedef std::map<vtkAbstractMapper*, Entry> EntryMap;
+  EntryMap Entries;
+};
+
+//----------------------------------------------------------------------------
+// The mapper of an actor or volume, and the latest modification time the
+// mapper compares with the time its geometry was built
+static vtkAbstractMapper* vtkMultiChannelGeometryCacheGetMapper(vtkProp* prop,
+                                                                unsigned long* stamp)
+{
+  vtkActor* actor = vtkActor::SafeDownCast(prop);
+  vtkVolume* volume = vtkVolume::SafeDownCast(prop);
+  vtkAbstractMapper* mapper = NULL;
+  vtkDataSet* input = NULL;
+  unsigned long time = 0;
+  if (actor && actor->GetMapper())
+    {
+    mapper = actor->GetMapper();
+    input = actor->GetMapper()->GetInputAsDataSet();
+    time = actor->GetProperty()->GetMTime();
+    }
+  else if (volume && volume->GetMapper())
+    {
+    mapper = volume->GetMapper();
+    input = volume->GetMapper()->GetDataSetInput();
+    }
+  else
+    {
+    return NULL;
+    }
+
+  if (stamp)
+    {
+    unsigned long mapperTime = mapper->GetMTime();
+    time = mapperTime > time ? mapperTime : time;
+    if (input)
+      {
+      unsigned long inputTime = input->GetMTime();
+      time = inputTime > time ? inputTime : time;
+      }
+    *stamp = time;
+    }
+
+  return mapper;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelGeometryCache::vtkMultiChannelGeometryCache()
+{
+  this->LockMappers = 1;
+
+  this->NumberOfInvalidations = 0;
+  this->TotalNumberOfInvalidations = 0;
+  this->GeometrySize = 0;
+  this->CachedSize = 0;
+
+  this->FrameNumber = 0;
+
+  this->Internals = new vtkMultiChannelGeometryCacheInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelGeometryCache::~vtkMultiChannelGeometryCache()
+{
+  this->ReleaseMappers(0);
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGeometryCache::BeginFrame(vtkProp** props, int numProps)
+{
+  this->FrameNumber++;
+  this->NumberOfInvalidations = 0;
+  this->GeometrySize = 0;
+
+  for (int i = 0; i < numProps; i++)
+    {
+    vtkAbstractMapper* mapper = vtkMultiChannelGeometryCacheGetMapper(props[i], NULL);
+    if (!mapper)
+      {
+      continue;
+      }
+
+    vtkMultiChannelGeometryCacheInternals::EntryMap::iterator it =
+      this->Internals->Entries.find(mapper);
+    if (it == this->Internals->Entries.end())
+      {
+      vtkMultiChannelGeometryCacheInternals::Entry entry;
+      entry.Stamp = 0;
+      entry.Window = NULL;
+      entry.LastFrame = 0;
+      entry.Locked = 0;
+      entry.Size = 0;
+
+      mapper->Register(this);
+      it = this->Internals->Entries.insert(
+        vtkMultiChannelGeometryCacheInternals::EntryMap::value_type(mapper, entry)).first;
+      }
+    vtkMultiChannelGeometryCacheInternals::Entry& entry = it->second;
+
+    // A static mapper does not update its input when it renders, so the
+    // channels cannot make it re-execute.  Setting it modifies the
+    // mapper, so it is only done once rather than every frame.
+    vtkMapper* geometryMapper = vtkMapper::SafeDownCast(mapper);
+    if (geometryMapper && this->LockMappers && !entry.Locked &&
+        !geometryMapper->GetStatic())
+      {
+      geometryMapper->StaticOn();
+      entry.Locked = 1;
+      }
+
+    // Update the pipeline once for all channels
+    mapper->Update();
+    vtkDataSet* input;
+    if (geometryMapper)
+      {
+      input = geometryMapper->GetInputAsDataSet();
+      }
+    else
+      {
+      input = static_cast<vtkAbstractVolumeMapper*>(mapper)->GetDataSetInput();
+      }
+
+    entry.Size = 0;
+    if (input)
+      {
+      entry.Size = input->GetActualMemorySize() * 1024.0;
+      this->GeometrySize += entry.Size;
+      }
+
+    entry.LastFrame = this->FrameNumber;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGeometryCache::EndChannel(vtkProp** props, int numProps,
+                                              vtkWindow* window)
+{
+  for (int i = 0; i < numProps; i++)
+    {
+    unsigned long stamp;
+    vtkAbstractMapper* mapper = vtkMultiChannelGeometryCacheGetMapper(props[i], &stamp);
+    if (!mapper)
+      {
+      continue;
+      }
+
+    vtkMultiChannelGeometryCacheInternals::EntryMap::iterator it =
+      this->Internals->Entries.find(mapper);
+    if (it == this->Internals->Entries.end())
+      {
+      continue;
+      }
+
+    // The mappers rebuild their geometry when they, their input, or the
+    // actor's property have been modified since it was built, or when
+    // they are drawn in another window
+    vtkMultiChannelGeometryCacheInternals::Entry& entry = it->second;
+    if (entry.Stamp != stamp || entry.Window != window)
+      {
+      this->NumberOfInvalidations++;
+      this->TotalNumberOfInvalidations++;
+      }
+
+    entry.Stamp = stamp;
+    entry.Window = window;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGeometryCache::EndFrame()
+{
+  this->ReleaseMappers(VTK_MULTICHANNEL_GEOMETRY_CACHE_AGE);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGeometryCache::ReleaseUnusedMappers(vtkWindow* window)
+{
+  this->ReleaseMappers(1, window);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGeometryCache::ReleaseMappers(int age, vtkWindow* window)
+{
+  this->CachedSize = 0;
+
+  vtkMultiChannelGeometryCacheInternals::EntryMap::iterator it =
+    this->Internals->Entries.begin();
+  while (it != this->Internals->Entries.end())
+    {
+    int release = this->FrameNumber - it->second.LastFrame >= age;
+    int unlock = it->second.Locked && (release || !this->LockMappers);
+
+    if (unlock)
+      {
+      static_cast<vtkMapper*>(it->first)->StaticOff();
+      it->second.Locked = 0;
+      }
+
+    if (release)
+      {
+      if (window)
+        {
+        it->first->ReleaseGraphicsResources(window);
+        }
+      it->first->UnRegister(this);
+      this->Internals->Entries.erase(it++);
+      }
+    else
+      {
+      this->CachedSize += it->second.Size;
+      ++it;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGeometryCache::ResetCounters()
+{
+  this->NumberOfInvalidations = 0;
+  this->TotalNumberOfInvalidations = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelGeometryCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Lock Mappers: " << this->LockMappers << "\n";
+  os << indent << "Number Of Invalidations: " << this->NumberOfInvalidations << "\n";
+  os << indent << "Total Number Of Invalidations: " << this->TotalNumberOfInvalidations << "\n";
+  os << indent << "Geometry Size: " << this->GeometrySize << "\n";
+  os << indent << "Cached Size: " << this->CachedSize << "\n";
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelGeometryCache.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelGeometryCache
+// .SECTION Description
+// vtkMultiChannelGeometryCache makes sure that mapper geometry is built
+// at most once per frame and reused by every channel.  At the start of
+// a frame it brings each visible mapper up to date, and makes it static
+// for as long as it is rendered, so that it does not update its input
+// while rendering.  The channels then cannot trigger pipeline updates,
+// so the camera changes made per channel cannot make a camera-dependent
+// filter re-execute and the mapper rebuild its display lists or
+// buffers.  Any camera-dependent filter therefore sees the frame's
+// camera rather than the channel's.  A static mapper is static in every
+// renderer it is used in, and is only brought up to date by the cache,
+// so turn LockMappers off for mappers that other renderers also draw
+// without the multi-channel renderer.  Mappers are released, and made
+// non-static again, once they have not been rendered for a while or the
+// cache is deleted.
+//
+// After each channel, EndChannel() checks the props drawn against the
+// conditions the OpenGL mappers rebuild on: a mapper, input, or
+// property modified since the geometry was built, or a different
+// window.  Each rebuild counts as an invalidation, so a frame whose data
+// changed counts one per mapper, and any further count is geometry
+// rebuilt for a channel.  In steady state NumberOfInvalidations is 0.
+//
+// Mappers held but no longer rendered keep their geometry alive, and are
+// counted in CachedSize until released.  Sizes are those of the mapper
+// inputs, as an estimate of the geometry uploaded for them, since the
+// size of display lists and buffers is not known.
+
+// .SECTION see also
+// vtkOpenGLMultiChannelRenderer
+
+#ifndef __vtkMultiChannelGeometryCache_h
+#define __vtkMultiChannelGeometryCache_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkProp;
+class vtkWindow;
+
+class vtkMultiChannelGeometryCacheInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelGeometryCache : public vtkObject
+{
+public:
+  static vtkMultiChannelGeometryCache *New();
+  vtkTypeRevisionMacro(vtkMultiChannelGeometryCache,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Keep rendered mappers static so that channels cannot update them.
+  // On by default.
+  vtkGetMacro(LockMappers,int);
+  vtkSetMacro(LockMappers,int);
+  vtkBooleanMacro(LockMappers,int);
+
+  // Description:
+  // Update the mappers of the given props and count invalidations
+  void BeginFrame(vtkProp** props, int numProps);
+
+  // Description:
+  // Count the mappers of the given props, drawn by a channel in the
+  // given window, that rebuilt their geometry
+  void EndChannel(vtkProp** props, int numProps, vtkWindow* window);
+
+  // Description:
+  // Release mappers that are no longer rendered
+  void EndFrame();
+
+  // Description:
+  // Geometry rebuilds in the last frame and since the counters were
+  // reset
+  vtkGetMacro(NumberOfInvalidations,int);
+  vtkGetMacro(TotalNumberOfInvalidations,int);
+  void ResetCounters();
+
+  // Description:
+  // Size in bytes of the mapper inputs seen in the last frame
+  vtkGetMacro(GeometrySize,double);
+
+  // Description:
+  // Size in bytes of the inputs of all mappers held, including those no
+  // longer rendered
+  vtkGetMacro(CachedSize,double);
+
+  // Description:
+  // Release the mappers not rendered in the last frame now, rather than
+  // once they have aged, and free their graphics resources in the given
+  // window.  Call it with the window's context current.  A mapper still
+  // rendered by another renderer uploads its geometry again.
+  void ReleaseUnusedMappers(vtkWindow*);
+
+protected:
+  vtkMultiChannelGeometryCache();
+  ~vtkMultiChannelGeometryCache();
+
+  int LockMappers;
+
+  int NumberOfInvalidations;
+  int TotalNumberOfInvalidations;
+  double GeometrySize;
+  double CachedSize;
+
+  int FrameNumber;
+
+  vtkMultiChannelGeometryCacheInternals* Internals;
+
+  // Description:
+  // Release mappers not rendered in the last age frames, and free their
+  // graphics resources in the window if one is given
+  void ReleaseMappers(int age, vtkWindow* window = NULL);
+
+private:
+  vtkMultiChannelGeometryCache(const vtkMultiChannelGeometryCache&);  // Not implemented.
+  void operator=(const vtkMultiChannelGeometryCache&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,378 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelMemoryMonitor.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelMemoryMonitor.h"
+
+#include "vtkCollection.h"
+#include "vtkMultiChannelAccumulator.h"
+#include "vtkMultiChannelGeometryCache.h"
+#include "vtkMultiChannelPrefetcher.h"
+#include "vtkMultiChannelRenderTargetPool.h"
+#include "vtkMultiChannelRenderWindowHelper.h"
+#include "vtkMultiChannelReprojector.h"
+#include "vtkMultiChannelStreamer.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGLMultiChannelRenderer.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowChannel.h"
+#include "vtkRendererCollection.h"
+
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelMemoryMonitor, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelMemoryMonitor);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelMemoryMonitorInternals
+{
+public:
+  // Subsystems, in the order they are evicted from to meet the total
+  // budget: cheapest to get back first
+  enum
+  {
+    RenderTargets = 0,
+    Geometry,
+    Prefetch,
+    Streaming,
+    Images,
+    NumberOfSubsystems
+  };
+
+  std::vector<double> ChannelImages;
+  std::vector<double> ChannelShared;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelMemoryMonitor::vtkMultiChannelMemoryMonitor()
+{
+  this->Enabled = 1;
+
+  this->RenderTargetBudget = 0;
+  this->ImageBudget = 0;
+  this->GeometryBudget = 0;
+  this->PrefetchBudget = 0;
+  this->StreamingBudget = 0;
+  this->TotalBudget = 0;
+
+  this->RenderTargetMemory = 0;
+  this->ImageMemory = 0;
+  this->GeometryMemory = 0;
+  this->PrefetchMemory = 0;
+  this->StreamingMemory = 0;
+  this->TotalMemory = 0;
+  this->PeakMemory = 0;
+
+  this->NumberOfEvictions = 0;
+  this->NumberOfUpdatesOverBudget = 0;
+
+  this->Internals = new vtkMultiChannelMemoryMonitorInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelMemoryMonitor::~vtkMultiChannelMemoryMonitor()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelMemoryMonitor::Update(vtkMultiChannelRenderWindowHelper* helper,
+                                          vtkRendererCollection* renderers)
+{
+  if (!helper || !renderers)
+    {
+    return;
+    }
+
+  this->Measure(helper, renderers);
+
+  if (this->Enabled)
+    {
+    // In eviction order
+    double budgets[vtkMultiChannelMemoryMonitorInternals::NumberOfSubsystems] =
+      { this->RenderTargetBudget, this->GeometryBudget, this->PrefetchBudget,
+        this->StreamingBudget, this->ImageBudget };
+    double* memory[vtkMultiChannelMemoryMonitorInternals::NumberOfSubsystems] =
+      { &this->RenderTargetMemory, &this->GeometryMemory, &this->PrefetchMemory,
+        &this->StreamingMemory, &this->ImageMemory };
+
+    // Each subsystem within its own budget
+    for (int i = 0; i < vtkMultiChannelMemoryMonitorInternals::NumberOfSubsystems; i++)
+      {
+      if (budgets[i] > 0 && *memory[i] > budgets[i])
+        {
+        this->Evict(i, budgets[i], helper, renderers);
+        }
+      }
+
+    // Then the total, taking the excess from the cheapest first
+    for (int i = 0; i < vtkMultiChannelMemoryMonitorInternals::NumberOfSubsystems &&
+                    this->TotalBudget > 0 && this->TotalMemory > this->TotalBudget; i++)
+      {
+      double bytes = *memory[i] - (this->TotalMemory - this->TotalBudget);
+      this->Evict(i, bytes > 0 ? bytes : 0, helper, renderers);
+      }
+    }
+
+  if (this->IsOverBudget())
+    {
+    this->NumberOfUpdatesOverBudget++;
+    }
+
+  if (this->TotalMemory > this->PeakMemory)
+    {
+    this->PeakMemory = this->TotalMemory;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelMemoryMonitor::Measure(vtkMultiChannelRenderWindowHelper* helper,
+                                           vtkRendererCollection* renderers)
+{
+  vtkMultiChannelMemoryMonitorInternals* internals = this->Internals;
+
+  this->GeometryMemory = 0;
+  vtkCollectionSimpleIterator iterator;
+  vtkRenderer* renderer;
+  for (renderers->InitTraversal(iterator); (renderer = renderers->GetNextRenderer(iterator)); )
+    {
+    vtkOpenGLMultiChannelRenderer* multiChannelRenderer = vtkOpenGLMultiChannelRenderer::SafeDownCast(renderer);
+    if (multiChannelRenderer)
+      {
+      this->GeometryMemory += multiChannelRenderer->GetGeometryCache()->GetCachedSize();
+      }
+    }
+
+  vtkMultiChannelPrefetcher* prefetcher = helper->GetPrefetcher();
+  this->PrefetchMemory = prefetcher ? prefetcher->GetCacheMemory() : 0;
+
+  vtkMultiChannelStreamer* streamer = helper->GetStreamer();
+  this->StreamingMemory = streamer ? streamer->GetCurrentMemory() : 0;
+
+  // Images belong to their channel, the rest is shared by pixel area
+  vtkMultiChannelAccumulator* accumulator = helper->GetAccumulator();
+  vtkMultiChannelReprojector* reprojector = helper->GetReprojector();
+
+  vtkCollection* channels = helper->GetChannels();
+  int numberOfChannels = channels->GetNumberOfItems();
+  internals->ChannelImages.assign(numberOfChannels, 0);
+  internals->ChannelShared.assign(numberOfChannels, 0);
+
+  renderer = renderers->GetFirstRenderer();
+  int* size = renderer ? renderer->GetRenderWindow()->GetSize() : NULL;
+
+  this->ImageMemory = 0;
+  double totalArea = 0;
+  for (int i = 0; i < numberOfChannels; i++)
+    {
+    vtkRenderWindowChannel* channel = vtkRenderWindowChannel::SafeDownCast(channels->GetItemAsObject(i));
+
+    double image = 0;
+    if (accumulator)
+      {
+      image += accumulator->GetChannelMemory(i);
+      }
+    if (reprojector)
+      {
+      image += reprojector->GetChannelMemory(i);
+      }
+    internals->ChannelImages[i] = image;
+    this->ImageMemory += image;
+
+    if (size)
+      {
+      int region[4];
+      channel->GetPixelRegion(size, region);
+      if (region[2] > 0 && region[3] > 0)
+        {
+        internals->ChannelShared[i] = static_cast<double>(region[2]) * region[3];
+        totalArea += internals->ChannelShared[i];
+        }
+      }
+    }
+
+  // The images are held in the pool, and are counted as images
+  this->RenderTargetMemory = helper->GetRenderTargetPool()->GetCurrentMemory() - this->ImageMemory;
+  if (this->RenderTargetMemory < 0)
+    {
+    this->RenderTargetMemory = 0;
+    }
+
+  double shared = this->RenderTargetMemory + this->GeometryMemory +
+                  this->PrefetchMemory + this->StreamingMemory;
+  for (int i = 0; i < numberOfChannels; i++)
+    {
+    internals->ChannelShared[i] = totalArea > 0 ?
+      shared * internals->ChannelShared[i] / totalArea : shared / numberOfChannels;
+    }
+
+  this->TotalMemory = shared + this->ImageMemory;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelMemoryMonitor::Evict(int subsystem, double bytes,
+                                         vtkMultiChannelRenderWindowHelper* helper,
+                                         vtkRendererCollection* renderers)
+{
+  double before = this->TotalMemory;
+
+  switch (subsystem)
+    {
+    case vtkMultiChannelMemoryMonitorInternals::RenderTargets:
+      helper->GetRenderTargetPool()->Trim(bytes + this->ImageMemory);
+      break;
+
+    case vtkMultiChannelMemoryMonitorInternals::Geometry:
+      {
+      // Mappers rendered this frame are in use, so only the rest go,
+      // with their display lists and buffers
+      vtkCollectionSimpleIterator iterator;
+      vtkRenderer* renderer;
+      for (renderers->InitTraversal(iterator); (renderer = renderers->GetNextRenderer(iterator)); )
+        {
+        vtkOpenGLMultiChannelRenderer* multiChannelRenderer = vtkOpenGLMultiChannelRenderer::SafeDownCast(renderer);
+        if (multiChannelRenderer)
+          {
+          multiChannelRenderer->GetGeometryCache()->ReleaseUnusedMappers(
+            multiChannelRenderer->GetRenderWindow());
+          }
+        }
+      }
+      break;
+
+    case vtkMultiChannelMemoryMonitorInternals::Prefetch:
+      if (helper->GetPrefetcher())
+        {
+        helper->GetPrefetcher()->Trim(bytes);
+        }
+      break;
+
+    case vtkMultiChannelMemoryMonitorInternals::Streaming:
+      if (helper->GetStreamer())
+        {
+        helper->GetStreamer()->Trim(bytes);
+        }
+      break;
+
+    case vtkMultiChannelMemoryMonitorInternals::Images:
+      // The reprojector's images are its fallback for a late frame, so
+      // only the accumulated images go, and only if that is enough
+      if (helper->GetAccumulator())
+        {
+        vtkMultiChannelAccumulator* accumulator = helper->GetAccumulator();
+        double accumulated = 0;
+        for (int i = 0; i < this->GetNumberOfChannels(); i++)
+          {
+          accumulated += accumulator->GetChannelMemory(i);
+          }
+        if (accumulated > 0 && this->ImageMemory - accumulated <= bytes)
+          {
+          // The averages go back to the pool, which deletes as much
+          vtkMultiChannelRenderTargetPool* pool = helper->GetRenderTargetPool();
+          accumulator->ReleaseMemory();
+          pool->Trim(pool->GetCurrentMemory() - accumulated);
+          }
+        }
+      break;
+    }
+
+  this->Measure(helper, renderers);
+
+  if (this->TotalMemory < before)
+    {
+    this->NumberOfEvictions++;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelMemoryMonitor::IsOverBudget()
+{
+  return (this->RenderTargetBudget > 0 && this->RenderTargetMemory > this->RenderTargetBudget) ||
+         (this->ImageBudget > 0 && this->ImageMemory > this->ImageBudget) ||
+         (this->GeometryBudget > 0 && this->GeometryMemory > this->GeometryBudget) ||
+         (this->PrefetchBudget > 0 && this->PrefetchMemory > this->PrefetchBudget) ||
+         (this->StreamingBudget > 0 && this->StreamingMemory > this->StreamingBudget) ||
+         (this->TotalBudget > 0 && this->TotalMemory > this->TotalBudget);
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelMemoryMonitor::GetNumberOfChannels()
+{
+  return static_cast<int>(this->Internals->ChannelImages.size());
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelMemoryMonitor::GetChannelImageMemory(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfChannels())
+    {
+    return 0;
+    }
+
+  return this->Internals->ChannelImages[i];
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelMemoryMonitor::GetChannelSharedMemory(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfChannels())
+    {
+    return 0;
+    }
+
+  return this->Internals->ChannelShared[i];
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelMemoryMonitor::GetChannelMemory(int i)
+{
+  return this->GetChannelImageMemory(i) + this->GetChannelSharedMemory(i);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelMemoryMonitor::ResetCounters()
+{
+  this->PeakMemory = this->TotalMemory;
+  this->NumberOfEvictions = 0;
+  this->NumberOfUpdatesOverBudget = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelMemoryMonitor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Enabled: " << this->Enabled << "\n";
+  os << indent << "Render Target Budget: " << this->RenderTargetBudget << "\n";
+  os << indent << "Image Budget: " << this->ImageBudget << "\n";
+  os << indent << "Geometry Budget: " << this->GeometryBudget << "\n";
+  os << indent << "Prefetch Budget: " << this->PrefetchBudget << "\n";
+  os << indent << "Streaming Budget: " << this->StreamingBudget << "\n";
+  os << indent << "Total Budget: " << this->TotalBudget << "\n";
+  os << indent << "Render Target Memory: " << this->RenderTargetMemory << "\n";
+  os << indent << "Image Memory: " << this->ImageMemory << "\n";
+  os << indent << "Geometry Memory: " << this->GeometryMemory << "\n";
+  os << indent << "Prefetch Memory: " << this->PrefetchMemory << "\n";
+  os << indent << "Streaming Memory: " << this->StreamingMemory << "\n";
+  os << indent << "Total Memory: " << this->TotalMemory << "\n";
+  os << indent << "Peak Memory: " << this->PeakMemory << "\n";
+  for (int i = 0; i < this->GetNumberOfChannels(); i++)
+    {
+    os << indent << "Channel " << i << " Memory: " << this->GetChannelMemory(i)
+       << " (Images: " << this->GetChannelImageMemory(i) << ")\n";
+    }
+  os << indent << "Number Of Evictions: " << this->NumberOfEvictions << "\n";
+  os << indent << "Number Of Updates Over Budget: " << this->NumberOfUpdatesOverBudget << "\n";
+}
@@ -0,0 +1,173 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelMemoryMonitor.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelMemoryMonitor
+// .SECTION Description
+// vtkMultiChannelMemoryMonitor measures the memory held by the parts of
+// a vtkMultiChannelRenderWindowHelper that cache data across frames, and
+// evicts from them to keep within budgets.  The memory is reported for
+// each subsystem:
+//
+//   render targets: the helper's vtkMultiChannelRenderTargetPool, less
+//                   the images held in it
+//   images:         the accumulator's averages and the reprojector's
+//                   images
+//   geometry:       the mappers held by the geometry caches of the
+//                   vtkOpenGLMultiChannelRenderers, estimated from the
+//                   size of their inputs
+//   prefetch:       the time steps cached by the prefetcher
+//   streaming:      the pieces loaded by the streamer
+//
+// and for each channel.  Images belong to a channel.  The rest is shared,
+// and is divided among the channels in proportion to their pixel area.
+// Sizes are estimated from the data's actual memory size and from the
+// texture sizes, so they do not include driver overhead.
+//
+// A budget of 0 means none.  When a subsystem is over its budget, or the
+// total over TotalBudget, the monitor evicts what is least costly to get
+// back first: unused render targets, mappers not rendered in the last
+// frame, prefetched steps, streamed pieces not visible, and then the
+// accumulated images, which suspends accumulation until the scene
+// changes.  The accumulated images are only evicted if that brings the
+// images within the budget.  The targets, mappers, steps and pieces in
+// use are never evicted, nor are the reprojector's images, so a
+// subsystem may stay over its budget.
+//
+// Set on a vtkMultiChannelRenderWindowHelper, Update() is called at the
+// end of each frame, so the next frame starts within the budgets.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkMultiChannelRenderTargetPool
+// vtkMultiChannelGeometryCache vtkMultiChannelPrefetcher
+// vtkMultiChannelStreamer
+
+#ifndef __vtkMultiChannelMemoryMonitor_h
+#define __vtkMultiChannelMemoryMonitor_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkMultiChannelMemoryMonitorInternals;
+class vtkMultiChannelRenderWindowHelper;
+class vtkRendererCollection;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelMemoryMonitor : public vtkObject
+{
+public:
+  static vtkMultiChannelMemoryMonitor *New();
+  vtkTypeRevisionMacro(vtkMultiChannelMemoryMonitor,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Turn eviction on or off.  When off, memory is still measured.
+  vtkSetMacro(Enabled,int);
+  vtkGetMacro(Enabled,int);
+  vtkBooleanMacro(Enabled,int);
+
+  // Description:
+  // Budgets in bytes for each subsystem and for their total.  0 means no
+  // budget.
+  vtkSetClampMacro(RenderTargetBudget,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(RenderTargetBudget,double);
+  vtkSetClampMacro(ImageBudget,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(ImageBudget,double);
+  vtkSetClampMacro(GeometryBudget,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(GeometryBudget,double);
+  vtkSetClampMacro(PrefetchBudget,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(PrefetchBudget,double);
+  vtkSetClampMacro(StreamingBudget,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(StreamingBudget,double);
+  vtkSetClampMacro(TotalBudget,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(TotalBudget,double);
+
+  // Description:
+  // Measure the memory of the helper's subsystems and of the geometry
+  // caches of the given renderers, and evict to the budgets.  Called by
+  // the helper at the end of each frame.
+  void Update(vtkMultiChannelRenderWindowHelper*, vtkRendererCollection*);
+
+  // Description:
+  // Memory in bytes held by each subsystem and in total after the last
+  // update, and the most held in total since the counters were reset
+  vtkGetMacro(RenderTargetMemory,double);
+  vtkGetMacro(ImageMemory,double);
+  vtkGetMacro(GeometryMemory,double);
+  vtkGetMacro(PrefetchMemory,double);
+  vtkGetMacro(StreamingMemory,double);
+  vtkGetMacro(TotalMemory,double);
+  vtkGetMacro(PeakMemory,double);
+
+  // Description:
+  // Memory in bytes held for a channel after the last update: its
+  // images, its share of the rest, and their sum
+  int GetNumberOfChannels();
+  double GetChannelImageMemory(int);
+  double GetChannelSharedMemory(int);
+  double GetChannelMemory(int);
+
+  // Description:
+  // Number of evictions made to keep within the budgets, and of updates
+  // that ended over a budget, since the counters were reset
+  vtkGetMacro(NumberOfEvictions,int);
+  vtkGetMacro(NumberOfUpdatesOverBudget,int);
+  void ResetCounters();
+
+protected:
+  vtkMultiChannelMemoryMonitor();
+  ~vtkMultiChannelMemoryMonitor();
+
+  int Enabled;
+
+  double RenderTargetBudget;
+  double ImageBudget;
+  double GeometryBudget;
+  double PrefetchBudget;
+  double StreamingBudget;
+  double TotalBudget;
+
+  double RenderTargetMemory;
+  double ImageMemory;
+  double GeometryMemory;
+  double PrefetchMemory;
+  double StreamingMemory;
+  double TotalMemory;
+  double PeakMemory;
+
+  int NumberOfEvictions;
+  int NumberOfUpdatesOverBudget;
+
+  vtkMultiChannelMemoryMonitorInternals* Internals;
+
+  // Description:
+  // Measure each subsystem and the channels
+  void Measure(vtkMultiChannelRenderWindowHelper*, vtkRendererCollection*);
+
+  // Description:
+  // Evict from the given subsystem, in eviction order, until it holds at
+  // most the given number of bytes or nothing more can be evicted
+  void Evict(int subsystem, double bytes,
+             vtkMultiChannelRenderWindowHelper*, vtkRendererCollection*);
+
+  // Description:
+  // Whether any budget is exceeded
+  int IsOverBudget();
+
+private:
+  vtkMultiChannelMemoryMonitor(const vtkMultiChannelMemoryMonitor&);  // Not implemented.
+  void operator=(const vtkMultiChannelMemoryMonitor&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,405 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelOcclusionCuller.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelOcclusionCuller.h"
+
+#include "vtkMatrix4x4.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGLMultiChannelCamera.h"
+#include "vtkProp.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkTimerLog.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelOcclusionCuller, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelOcclusionCuller);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelOcclusionCullerInternals
+{
+public:
+  struct Level
+  {
+    int Width;
+    int Height;
+    std::vector<float> Depth;
+  };
+
+  struct Channel
+  {
+    Channel() : Valid(0) {}
+
+    int Valid;
+
+    // Projection times view of the frame the depth is from
+    double Matrix[16];
+
+    // Farthest depth pyramid, full size first
+    std::vector<Level> Levels;
+
+    // Props hidden in this frame, sorted
+    std::vector<vtkProp*> Hidden;
+  };
+
+  std::vector<Channel> Channels;
+
+  // Returns 1 if the box is behind the channel's depth
+  int IsHidden(const Channel& channel, const double bounds[6]);
+
+  // Rebuild the levels above the first
+  void BuildPyramid(Channel& channel);
+};
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelOcclusionCullerInternals::IsHidden(const Channel& channel, const double bounds[6])
+{
+  const double* m = channel.Matrix;
+
+  double minX = VTK_DOUBLE_MAX, maxX = -VTK_DOUBLE_MAX;
+  double minY = VTK_DOUBLE_MAX, maxY = -VTK_DOUBLE_MAX;
+  double minZ = VTK_DOUBLE_MAX;
+
+  for (int i = 0; i < 8; i++)
+    {
+    double x = bounds[i & 1];
+    double y = bounds[2 + ((i >> 1) & 1)];
+    double z = bounds[4 + ((i >> 2) & 1)];
+
+    double w = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+    // Crosses the eye plane
+    if (w <= 1e-6)
+      {
+      return 0;
+      }
+
+    double px = (m[0] * x + m[1] * y + m[2] * z + m[3]) / w;
+    double py = (m[4] * x + m[5] * y + m[6] * z + m[7]) / w;
+    double pz = (m[8] * x + m[9] * y + m[10] * z + m[11]) / w;
+
+    minX = px < minX ? px : minX;
+    maxX = px > maxX ? px : maxX;
+    minY = py < minY ? py : minY;
+    maxY = py > maxY ? py : maxY;
+    minZ = pz < minZ ? pz : minZ;
+    }
+
+  // Partly outside the previous view, or in front of the near plane
+  if (minX < -1.0 || maxX > 1.0 || minY < -1.0 || maxY > 1.0 || minZ < -1.0)
+    {
+    return 0;
+    }
+
+  const Level& base = channel.Levels[0];
+  int x0 = static_cast<int>((minX + 1.0) * 0.5 * base.Width);
+  int x1 = static_cast<int>((maxX + 1.0) * 0.5 * base.Width);
+  int y0 = static_cast<int>((minY + 1.0) * 0.5 * base.Height);
+  int y1 = static_cast<int>((maxY + 1.0) * 0.5 * base.Height);
+  x1 = x1 < base.Width ? x1 : base.Width - 1;
+  y1 = y1 < base.Height ? y1 : base.Height - 1;
+
+  // The level where the box covers at most two by two texels
+  unsigned int l = 0;
+  while (l + 1 < channel.Levels.size() && (x1 - x0 > 1 || y1 - y0 > 1))
+    {
+    x0 >>= 1;
+    x1 >>= 1;
+    y0 >>= 1;
+    y1 >>= 1;
+    l++;
+    }
+
+  const Level& level = channel.Levels[l];
+  double nearest = (minZ + 1.0) * 0.5;
+  for (int y = y0; y <= y1; y++)
+    {
+    for (int x = x0; x <= x1; x++)
+      {
+      if (nearest <= level.Depth[y * level.Width + x])
+        {
+        return 0;
+        }
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelOcclusionCullerInternals::BuildPyramid(Channel& channel)
+{
+  channel.Levels.resize(1);
+
+  while (channel.Levels.back().Width > 1 || channel.Levels.back().Height > 1)
+    {
+    const Level& below = channel.Levels.back();
+
+    Level level;
+    level.Width = (below.Width + 1) / 2;
+    level.Height = (below.Height + 1) / 2;
+    level.Depth.resize(level.Width * level.Height);
+
+    for (int y = 0; y < level.Height; y++)
+      {
+      int by0 = 2 * y;
+      int by1 = by0 + 1 < below.Height ? by0 + 1 : by0;
+      for (int x = 0; x < level.Width; x++)
+        {
+        int bx0 = 2 * x;
+        int bx1 = bx0 + 1 < below.Width ? bx0 + 1 : bx0;
+
+        float d = below.Depth[by0 * below.Width + bx0];
+        d = std::max(d, below.Depth[by0 * below.Width + bx1]);
+        d = std::max(d, below.Depth[by1 * below.Width + bx0]);
+        d = std::max(d, below.Depth[by1 * below.Width + bx1]);
+        level.Depth[y * level.Width + x] = d;
+        }
+      }
+
+    channel.Levels.push_back(level);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelOcclusionCuller::vtkMultiChannelOcclusionCuller()
+{
+  this->Enabled = 1;
+
+  this->InFrame = 0;
+  this->CurrentChannel = 0;
+
+  this->NumberOfTestedChannels = 0;
+  this->NumberOfTestedProps = 0;
+  this->NumberOfCulledProps = 0;
+
+  this->TestTime = 0;
+  this->DepthTime = 0;
+
+  this->Internals = new vtkMultiChannelOcclusionCullerInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelOcclusionCuller::~vtkMultiChannelOcclusionCuller()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelOcclusionCuller::BeginFrame(vtkProp** props, int numProps)
+{
+  vtkMultiChannelOcclusionCullerInternals* internals = this->Internals;
+
+  this->InFrame = 1;
+  this->CurrentChannel = 0;
+
+  this->NumberOfTestedChannels = 0;
+  this->NumberOfTestedProps = 0;
+  this->NumberOfCulledProps = 0;
+  this->DepthTime = 0;
+  this->TestTime = 0;
+
+  for (unsigned int c = 0; c < internals->Channels.size(); c++)
+    {
+    internals->Channels[c].Hidden.clear();
+    if (this->Enabled && internals->Channels[c].Valid)
+      {
+      this->NumberOfTestedChannels++;
+      }
+    }
+
+  if (!this->Enabled || this->NumberOfTestedChannels == 0)
+    {
+    return;
+    }
+
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  // Each prop's bounds are fetched once and tested in every channel
+  for (int i = 0; i < numProps; i++)
+    {
+    double* bounds = props[i]->GetBounds();
+    if (!bounds || bounds[0] > bounds[1])
+      {
+      continue;
+      }
+
+    this->NumberOfTestedProps++;
+
+    for (unsigned int c = 0; c < internals->Channels.size(); c++)
+      {
+      vtkMultiChannelOcclusionCullerInternals::Channel& channel = internals->Channels[c];
+      if (channel.Valid && internals->IsHidden(channel, bounds))
+        {
+        channel.Hidden.push_back(props[i]);
+        }
+      }
+    }
+
+  for (unsigned int c = 0; c < internals->Channels.size(); c++)
+    {
+    std::sort(internals->Channels[c].Hidden.begin(), internals->Channels[c].Hidden.end());
+    }
+
+  this->TestTime = vtkTimerLog::GetUniversalTime() - startTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelOcclusionCuller::Cull(vtkRenderer*, vtkProp** propList,
+                                            int& listLength, int& initialized)
+{
+  vtkMultiChannelOcclusionCullerInternals* internals = this->Internals;
+
+  if (this->Enabled && this->InFrame &&
+      this->CurrentChannel < static_cast<int>(internals->Channels.size()))
+    {
+    const std::vector<vtkProp*>& hidden = internals->Channels[this->CurrentChannel].Hidden;
+    if (!hidden.empty())
+      {
+      int count = 0;
+      for (int i = 0; i < listLength; i++)
+        {
+        if (std::binary_search(hidden.begin(), hidden.end(), propList[i]))
+          {
+          this->NumberOfCulledProps++;
+          }
+        else
+          {
+          propList[count++] = propList[i];
+          }
+        }
+      listLength = count;
+      }
+    }
+
+  // The total time the remaining props' times are relative to
+  if (!initialized)
+    {
+    return static_cast<double>(listLength);
+    }
+
+  double totalTime = 0;
+  for (int i = 0; i < listLength; i++)
+    {
+    totalTime += propList[i]->GetRenderTimeMultiplier();
+    }
+
+  return totalTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelOcclusionCuller::EndChannel(vtkRenderer* renderer)
+{
+  if (!this->InFrame)
+    {
+    return;
+    }
+
+  vtkMultiChannelOcclusionCullerInternals* internals = this->Internals;
+
+  int channelIndex = this->CurrentChannel++;
+  if (channelIndex >= static_cast<int>(internals->Channels.size()))
+    {
+    internals->Channels.resize(channelIndex + 1);
+    }
+
+  vtkMultiChannelOcclusionCullerInternals::Channel& channel = internals->Channels[channelIndex];
+  channel.Valid = 0;
+
+  if (!this->Enabled)
+    {
+    return;
+    }
+
+  int width, height, x, y;
+  renderer->GetTiledSizeAndOrigin(&width, &height, &x, &y);
+  if (width <= 0 || height <= 0)
+    {
+    return;
+    }
+
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  // The view the depth is drawn with
+  vtkCamera* camera = renderer->GetActiveCamera();
+  vtkOpenGLMultiChannelCamera* multiChannelCamera = vtkOpenGLMultiChannelCamera::SafeDownCast(camera);
+  double aspect = multiChannelCamera && multiChannelCamera->GetUseAspectRatio() ?
+    multiChannelCamera->GetAspectRatio() : static_cast<double>(width) / height;
+
+  vtkMatrix4x4* matrix = camera->GetCompositeProjectionTransformMatrix(aspect, -1, 1);
+  for (int i = 0; i < 4; i++)
+    {
+    for (int j = 0; j < 4; j++)
+      {
+      channel.Matrix[i * 4 + j] = matrix->GetElement(i, j);
+      }
+    }
+
+  channel.Levels.resize(1);
+  vtkMultiChannelOcclusionCullerInternals::Level& base = channel.Levels[0];
+  base.Width = width;
+  base.Height = height;
+  base.Depth.resize(width * height);
+
+  if (renderer->GetRenderWindow()->GetZbufferData(x, y, x + width - 1, y + height - 1, &base.Depth[0]) != VTK_OK)
+    {
+    return;
+    }
+
+  internals->BuildPyramid(channel);
+  channel.Valid = 1;
+
+  this->DepthTime += vtkTimerLog::GetUniversalTime() - startTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelOcclusionCuller::EndFrame()
+{
+  if (!this->InFrame)
+    {
+    return;
+    }
+
+  // Forget channels no longer rendered
+  if (this->CurrentChannel < static_cast<int>(this->Internals->Channels.size()))
+    {
+    this->Internals->Channels.resize(this->CurrentChannel);
+    }
+
+  this->InFrame = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelOcclusionCuller::Reset()
+{
+  this->Internals->Channels.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelOcclusionCuller::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Enabled: " << this->Enabled << "\n";
+  os << indent << "Number Of Tested Channels: " << this->NumberOfTestedChannels << "\n";
+  os << indent << "Number Of Tested Props: " << this->NumberOfTestedProps << "\n";
+  os << indent << "Number Of Culled Props: " << this->NumberOfCulledProps << "\n";
+  os << indent << "Test Time: " << this->TestTime << "\n";
+  os << indent << "Depth Time: " << this->DepthTime << "\n";
+}
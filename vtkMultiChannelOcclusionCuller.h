@@ -0,0 +1,124 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelOcclusionCuller.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelOcclusionCuller
+// .SECTION Description
+// vtkMultiChannelOcclusionCuller skips drawing props hidden behind
+// others in each channel, using the depth of the channel's previous
+// frame.  Add it to a vtkOpenGLMultiChannelRenderer with AddCuller(),
+// after the default frustum culler.
+//
+// Once a channel is drawn, its depth is read back and reduced on the
+// CPU to a pyramid in which each level keeps the farthest depth of four
+// texels below it.  At the start of the next frame, the bounds of every
+// visible prop are tested against the pyramids of all channels in one
+// pass over the prop list.  Each box is projected with the view it is
+// tested against, which is the channel's view of the previous frame.  A
+// level where the projected box covers at most two by two texels is
+// used.  If the nearest point of the box is farther than every texel
+// it covers, the prop is hidden in that channel and not drawn.  Props
+// that cross the eye plane, leave the previous view, or have no bounds
+// are always drawn.
+//
+// Props are therefore drawn a frame late when they come out from behind
+// others, or into view as the view moves.  Channels are identified by
+// the order in which they are rendered in a frame.  Outside of a
+// multi-channel frame, nothing is culled.
+
+// .SECTION see also
+// vtkOpenGLMultiChannelRenderer vtkMultiChannelRenderWindowHelper
+
+#ifndef __vtkMultiChannelOcclusionCuller_h
+#define __vtkMultiChannelOcclusionCuller_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkCuller.h"
+
+class vtkMultiChannelOcclusionCullerInternals;
+class vtkProp;
+class vtkRenderer;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelOcclusionCuller : public vtkCuller
+{
+public:
+  static vtkMultiChannelOcclusionCuller *New();
+  vtkTypeRevisionMacro(vtkMultiChannelOcclusionCuller,vtkCuller);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Turn culling on or off.  When off, depth is not read back.
+  vtkSetMacro(Enabled,int);
+  vtkGetMacro(Enabled,int);
+  vtkBooleanMacro(Enabled,int);
+
+  // Description:
+  // Called by the renderer at the start of each frame, to test the
+  // frame's props against the depth of every channel
+  void BeginFrame(vtkProp** props, int numProps);
+
+  // Description:
+  // Remove the props hidden in the current channel
+  double Cull(vtkRenderer*, vtkProp** propList, int& listLength, int& initialized);
+
+  // Description:
+  // Called by the renderer once the current channel is drawn, to read
+  // back its depth
+  void EndChannel(vtkRenderer*);
+
+  // Description:
+  // Called by the renderer at the end of each frame
+  void EndFrame();
+
+  // Description:
+  // Forget the depth of all channels
+  void Reset();
+
+  // Description:
+  // Channels and props tested, and props culled, in the last frame
+  vtkGetMacro(NumberOfTestedChannels,int);
+  vtkGetMacro(NumberOfTestedProps,int);
+  vtkGetMacro(NumberOfCulledProps,int);
+
+  // Description:
+  // Time taken to test the props and to read back and reduce depth in
+  // the last frame
+  vtkGetMacro(TestTime,double);
+  vtkGetMacro(DepthTime,double);
+
+protected:
+  vtkMultiChannelOcclusionCuller();
+  ~vtkMultiChannelOcclusionCuller();
+
+  int Enabled;
+
+  int InFrame;
+  int CurrentChannel;
+
+  int NumberOfTestedChannels;
+  int NumberOfTestedProps;
+  int NumberOfCulledProps;
+
+  double TestTime;
+  double DepthTime;
+
+  vtkMultiChannelOcclusionCullerInternals* Internals;
+
+private:
+  vtkMultiChannelOcclusionCuller(const vtkMultiChannelOcclusionCuller&);  // Not implemented.
+  void operator=(const vtkMultiChannelOcclusionCuller&);  // Not implemented.
+};
+
+#endif
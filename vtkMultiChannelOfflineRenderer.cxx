@@ -0,0 +1,242 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelOfflineRenderer.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelOfflineRenderer.h"
+
+#include "vtkCollection.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGLMultiChannelCamera.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowChannel.h"
+#include "vtkRenderer.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <stdio.h>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelOfflineRenderer, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelOfflineRenderer);
+
+vtkCxxSetObjectMacro(vtkMultiChannelOfflineRenderer, Renderer, vtkRenderer);
+vtkCxxSetObjectMacro(vtkMultiChannelOfflineRenderer, Channels, vtkCollection);
+
+//----------------------------------------------------------------------------
+// Box filter a tile rendered at supersample times its size, bottom row
+// first, and write its rows top row first into the image at (x, top)
+static void vtkMultiChannelOfflineRendererWriteTile(FILE* file, long headerSize, int imageWidth,
+                                                    const unsigned char* pixels, int supersample,
+                                                    int x, int top, int width, int height,
+                                                    unsigned char* row)
+{
+  int pixelsWidth = width * supersample;
+  int samples = supersample * supersample;
+
+  for (int r = 0; r < height; r++)
+    {
+    int sourceRow = (height - 1 - r) * supersample;
+
+    for (int c = 0; c < width; c++)
+      {
+      int sum[3] = { 0, 0, 0 };
+      for (int j = 0; j < supersample; j++)
+        {
+        const unsigned char* p = pixels + ((sourceRow + j) * pixelsWidth + c * supersample) * 3;
+        for (int i = 0; i < supersample; i++, p += 3)
+          {
+          sum[0] += p[0];
+          sum[1] += p[1];
+          sum[2] += p[2];
+          }
+        }
+      row[c * 3] = static_cast<unsigned char>(sum[0] / samples);
+      row[c * 3 + 1] = static_cast<unsigned char>(sum[1] / samples);
+      row[c * 3 + 2] = static_cast<unsigned char>(sum[2] / samples);
+      }
+
+    fseek(file, headerSize + (static_cast<long>(top + r) * imageWidth + x) * 3, SEEK_SET);
+    fwrite(row, 1, width * 3, file);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelOfflineRenderer::vtkMultiChannelOfflineRenderer()
+{
+  this->Renderer = NULL;
+  this->Channels = NULL;
+
+  this->Size[0] = this->Size[1] = 0;
+  this->TileSize[0] = this->TileSize[1] = 1024;
+  this->Supersample = 1;
+
+  this->FileName = NULL;
+
+  this->NumberOfTiles = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelOfflineRenderer::~vtkMultiChannelOfflineRenderer()
+{
+  this->SetRenderer(NULL);
+  this->SetChannels(NULL);
+  this->SetFileName(NULL);
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelOfflineRenderer::Render()
+{
+  if (!this->Renderer || !this->Channels || !this->FileName)
+    {
+    vtkErrorMacro(<< "Renderer, channels, and file name must be set.");
+    return 0;
+    }
+
+  if (this->Size[0] <= 0 || this->Size[1] <= 0 ||
+      this->TileSize[0] <= 0 || this->TileSize[1] <= 0)
+    {
+    vtkErrorMacro(<< "Invalid image or tile size.");
+    return 0;
+    }
+
+  if (!vtkOpenGLMultiChannelCamera::SafeDownCast(this->Renderer->GetActiveCamera()))
+    {
+    vtkErrorMacro(<< "Renderer must use a vtkOpenGLMultiChannelCamera.");
+    return 0;
+    }
+
+  FILE* file = fopen(this->FileName, "wb");
+  if (!file)
+    {
+    vtkErrorMacro(<< "Could not open " << this->FileName << " for writing.");
+    return 0;
+    }
+
+  int width = this->Size[0];
+  int height = this->Size[1];
+  int tileWidth = this->TileSize[0] < width ? this->TileSize[0] : width;
+  int tileHeight = this->TileSize[1] < height ? this->TileSize[1] : height;
+  int supersample = this->Supersample;
+
+  // Write the header and a black image, so tiles can be written in place
+  fprintf(file, "P6\n%d %d\n255\n", width, height);
+  long headerSize = ftell(file);
+
+  std::vector<unsigned char> row(width * 3, 0);
+  for (int i = 0; i < height; i++)
+    {
+    fwrite(&row[0], 1, row.size(), file);
+    }
+
+  // Move the renderer to an offscreen window the size of a tile
+  vtkRenderWindow* oldWindow = this->Renderer->GetRenderWindow();
+
+  vtkRenderWindow* window = vtkRenderWindow::New();
+  window->OffScreenRenderingOn();
+  window->SetSize(tileWidth * supersample, tileHeight * supersample);
+  window->AddRenderer(this->Renderer);
+
+  vtkUnsignedCharArray* pixels = vtkUnsignedCharArray::New();
+
+  this->NumberOfTiles = 0;
+
+  for (int i = 0; i < this->Channels->GetNumberOfItems(); i++)
+    {
+    vtkRenderWindowChannel* channel =
+      vtkRenderWindowChannel::SafeDownCast(this->Channels->GetItemAsObject(i));
+
+    // Channel extent in image pixels, origin at the bottom
+    double* vp = channel->GetViewport();
+    int x1 = static_cast<int>(vp[0] * width + 0.5);
+    int y1 = static_cast<int>(vp[1] * height + 0.5);
+    int x2 = static_cast<int>(vp[2] * width + 0.5);
+    int y2 = static_cast<int>(vp[3] * height + 0.5);
+    double channelWidth = x2 - x1;
+    double channelHeight = y2 - y1;
+    if (channelWidth <= 0 || channelHeight <= 0)
+      {
+      continue;
+      }
+
+    // Rows of tiles from the top, so the file is written mostly in order
+    for (int top = y2; top > y1; top -= tileHeight)
+      {
+      int bottom = top - tileHeight > y1 ? top - tileHeight : y1;
+      int h = top - bottom;
+
+      for (int left = x1; left < x2; left += tileWidth)
+        {
+        int w = left + tileWidth < x2 ? tileWidth : x2 - left;
+
+        double region[4];
+        region[0] = (left - x1) / channelWidth;
+        region[1] = (bottom - y1) / channelHeight;
+        region[2] = (left + w - x1) / channelWidth;
+        region[3] = (top - y1) / channelHeight;
+
+        double viewport[4];
+        viewport[0] = 0;
+        viewport[1] = 0;
+        viewport[2] = static_cast<double>(w) / tileWidth;
+        viewport[3] = static_cast<double>(h) / tileHeight;
+
+        window->Start();
+
+        channel->SetTile(region, viewport, channelWidth / channelHeight);
+        channel->Render(this->Renderer);
+        channel->ClearTile();
+
+        window->GetPixelData(0, 0, w * supersample - 1, h * supersample - 1,
+                             !window->GetDoubleBuffer(), pixels);
+
+        vtkMultiChannelOfflineRendererWriteTile(file, headerSize, width,
+                                                pixels->GetPointer(0), supersample,
+                                                left, height - top, w, h, &row[0]);
+
+        this->NumberOfTiles++;
+        }
+      }
+    }
+
+  pixels->Delete();
+
+  // Give the renderer back
+  window->RemoveRenderer(this->Renderer);
+  this->Renderer->SetRenderWindow(oldWindow);
+  window->Delete();
+
+  int ok = !ferror(file);
+  fclose(file);
+
+  if (!ok)
+    {
+    vtkErrorMacro(<< "Error writing " << this->FileName << ".");
+    }
+
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelOfflineRenderer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Renderer: " << this->Renderer << "\n";
+  os << indent << "Channels: " << this->Channels << "\n";
+  os << indent << "Size: (" << this->Size[0] << ", " << this->Size[1] << ")\n";
+  os << indent << "Tile Size: (" << this->TileSize[0] << ", " << this->TileSize[1] << ")\n";
+  os << indent << "Supersample: " << this->Supersample << "\n";
+  os << indent << "File Name: " << (this->FileName ? this->FileName : "(none)") << "\n";
+  os << indent << "Number Of Tiles: " << this->NumberOfTiles << "\n";
+}
@@ -0,0 +1,109 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelOfflineRenderer.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelOfflineRenderer
+// .SECTION Description
+// vtkMultiChannelOfflineRenderer renders a set of channels to an image
+// file of arbitrary size, without a window of that size.  Each channel
+// is rendered in tiles of at most TileSize pixels into an offscreen
+// window, optionally supersampled and box filtered down, and each tile
+// is written straight to its place in a binary PPM file.  Peak memory
+// is therefore proportional to one tile rather than to the image.
+// Parts of the image not covered by a channel are black.
+//
+// The renderer must use a vtkOpenGLMultiChannelCamera and cover its
+// whole viewport.  It is moved to the offscreen window while rendering
+// and moved back afterwards.  With VTK built against OSMesa, the
+// offscreen window needs no GPU or display.
+
+// .SECTION see also
+// vtkRenciRenderWindowManager vtkRenderWindowChannel
+
+#ifndef __vtkMultiChannelOfflineRenderer_h
+#define __vtkMultiChannelOfflineRenderer_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkCollection;
+class vtkRenderer;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelOfflineRenderer : public vtkObject
+{
+public:
+  static vtkMultiChannelOfflineRenderer *New();
+  vtkTypeRevisionMacro(vtkMultiChannelOfflineRenderer,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // The renderer holding the scene
+  void SetRenderer(vtkRenderer*);
+  vtkGetObjectMacro(Renderer,vtkRenderer);
+
+  // Description:
+  // The channels to render, with viewports relative to the image
+  void SetChannels(vtkCollection*);
+  vtkGetObjectMacro(Channels,vtkCollection);
+
+  // Description:
+  // Size of the image in pixels.  Must be set.
+  vtkSetVector2Macro(Size,int);
+  vtkGetVector2Macro(Size,int);
+
+  // Description:
+  // Maximum size of a tile in image pixels
+  vtkSetVector2Macro(TileSize,int);
+  vtkGetVector2Macro(TileSize,int);
+
+  // Description:
+  // Render each tile at this many times its size in each direction
+  vtkSetClampMacro(Supersample,int,1,8);
+  vtkGetMacro(Supersample,int);
+
+  // Description:
+  // PPM file to write
+  vtkSetStringMacro(FileName);
+  vtkGetStringMacro(FileName);
+
+  // Description:
+  // Render the image.  Returns 1 on success.
+  int Render();
+
+  // Description:
+  // Number of tiles rendered by the last Render()
+  vtkGetMacro(NumberOfTiles,int);
+
+protected:
+  vtkMultiChannelOfflineRenderer();
+  ~vtkMultiChannelOfflineRenderer();
+
+  vtkRenderer* Renderer;
+  vtkCollection* Channels;
+
+  int Size[2];
+  int TileSize[2];
+  int Supersample;
+
+  char* FileName;
+
+  int NumberOfTiles;
+
+private:
+  vtkMultiChannelOfflineRenderer(const vtkMultiChannelOfflineRenderer&);  // Not implemented.
+  void operator=(const vtkMultiChannelOfflineRenderer&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,494 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelPrefetcher.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelPrefetcher.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkConditionVariable.h"
+#include "vtkDataObject.h"
+#include "vtkExecutive.h"
+#include "vtkInformation.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTrivialProducer.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelPrefetcher, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelPrefetcher);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelPrefetcherInternals
+{
+public:
+  struct Worker
+  {
+    vtkMultiChannelPrefetcher* Prefetcher;
+    vtkAlgorithm* Pipeline;
+    int ThreadId;
+  };
+
+  struct Entry
+  {
+    vtkDataObject* Data;
+    double Size;
+    unsigned long LastUsed;
+  };
+
+  std::vector<Worker> Workers;
+  std::vector<double> TimeSteps;
+
+  std::map<int, Entry> Cache;
+  std::set<int> InFlight;
+  unsigned long UseCount;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelPrefetcher::vtkMultiChannelPrefetcher()
+{
+  this->TimeStep = 0;
+  this->OutputTimeStep = -1;
+  this->Lookahead = 4;
+  this->CacheSize = 8;
+  this->Loop = 1;
+  this->WaitForData = 0;
+
+  this->Running = 0;
+  this->StopRequested = 0;
+
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+  this->NumberOfExecutions = 0;
+  this->CacheMemory = 0;
+
+  this->Producer = vtkTrivialProducer::New();
+
+  this->Threader = vtkMultiThreader::New();
+  this->Lock = vtkMutexLock::New();
+  this->WorkCondition = vtkConditionVariable::New();
+  this->ReadyCondition = vtkConditionVariable::New();
+
+  this->Internals = new vtkMultiChannelPrefetcherInternals;
+  this->Internals->UseCount = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelPrefetcher::~vtkMultiChannelPrefetcher()
+{
+  this->Stop();
+  this->RemoveAllPipelines();
+
+  std::map<int, vtkMultiChannelPrefetcherInternals::Entry>::iterator it;
+  for (it = this->Internals->Cache.begin(); it != this->Internals->Cache.end(); ++it)
+    {
+    it->second.Data->Delete();
+    }
+
+  this->Producer->Delete();
+
+  this->Threader->Delete();
+  this->Lock->Delete();
+  this->WorkCondition->Delete();
+  this->ReadyCondition->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::AddPipeline(vtkAlgorithm* pipeline)
+{
+  if (this->Running)
+    {
+    vtkErrorMacro(<< "Cannot add a pipeline while running.");
+    return;
+    }
+
+  if (!pipeline)
+    {
+    return;
+    }
+
+  vtkMultiChannelPrefetcherInternals::Worker worker;
+  worker.Prefetcher = this;
+  worker.Pipeline = pipeline;
+  worker.ThreadId = -1;
+
+  pipeline->Register(this);
+  this->Internals->Workers.push_back(worker);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::RemoveAllPipelines()
+{
+  if (this->Running)
+    {
+    vtkErrorMacro(<< "Cannot remove pipelines while running.");
+    return;
+    }
+
+  for (unsigned int i = 0; i < this->Internals->Workers.size(); i++)
+    {
+    this->Internals->Workers[i].Pipeline->UnRegister(this);
+    }
+  this->Internals->Workers.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::SetTimeSteps(int numberOfTimeSteps, const double* timeSteps)
+{
+  this->Lock->Lock();
+  this->Internals->TimeSteps.assign(timeSteps, timeSteps + numberOfTimeSteps);
+  this->Lock->Unlock();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelPrefetcher::GetNumberOfTimeSteps()
+{
+  return static_cast<int>(this->Internals->TimeSteps.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::SetTimeStep(int timeStep)
+{
+  this->Lock->Lock();
+  int numberOfTimeSteps = static_cast<int>(this->Internals->TimeSteps.size());
+  if (numberOfTimeSteps > 0)
+    {
+    timeStep = timeStep < 0 ? 0 : timeStep;
+    timeStep = timeStep >= numberOfTimeSteps ? numberOfTimeSteps - 1 : timeStep;
+    }
+  this->TimeStep = timeStep;
+
+  // The prefetch window moved
+  this->WorkCondition->Broadcast();
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMultiChannelPrefetcher::GetOutputPort()
+{
+  return this->Producer->GetOutputPort();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::Start()
+{
+  if (this->Running)
+    {
+    return;
+    }
+
+  if (this->Internals->Workers.empty())
+    {
+    vtkErrorMacro(<< "No pipelines to execute.");
+    return;
+    }
+
+  // Take the time steps from the first pipeline
+  if (this->Internals->TimeSteps.empty())
+    {
+    vtkAlgorithm* pipeline = this->Internals->Workers[0].Pipeline;
+    pipeline->UpdateInformation();
+
+    vtkInformation* info = pipeline->GetExecutive()->GetOutputInformation(0);
+    if (info && info->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+      {
+      this->SetTimeSteps(info->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()),
+                         info->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS()));
+      }
+    }
+
+  if (this->Internals->TimeSteps.empty())
+    {
+    vtkErrorMacro(<< "No time steps.");
+    return;
+    }
+
+  this->StopRequested = 0;
+  this->Running = 1;
+
+  for (unsigned int i = 0; i < this->Internals->Workers.size(); i++)
+    {
+    this->Internals->Workers[i].ThreadId = this->Threader->SpawnThread(
+      &vtkMultiChannelPrefetcher::WorkerMain, &this->Internals->Workers[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::Stop()
+{
+  if (!this->Running)
+    {
+    return;
+    }
+
+  this->Lock->Lock();
+  this->StopRequested = 1;
+  this->WorkCondition->Broadcast();
+  this->ReadyCondition->Broadcast();
+  this->Lock->Unlock();
+
+  // Waits for the steps being executed to finish
+  for (unsigned int i = 0; i < this->Internals->Workers.size(); i++)
+    {
+    this->Threader->TerminateThread(this->Internals->Workers[i].ThreadId);
+    this->Internals->Workers[i].ThreadId = -1;
+    }
+
+  this->Running = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelPrefetcher::Update()
+{
+  if (!this->Running)
+    {
+    return 0;
+    }
+
+  this->Lock->Lock();
+
+  if (this->TimeStep == this->OutputTimeStep)
+    {
+    this->Lock->Unlock();
+    return 0;
+    }
+
+  std::map<int, vtkMultiChannelPrefetcherInternals::Entry>::iterator it =
+    this->Internals->Cache.find(this->TimeStep);
+  while (it == this->Internals->Cache.end() && this->WaitForData && !this->StopRequested)
+    {
+    this->ReadyCondition->Wait(this->Lock);
+    it = this->Internals->Cache.find(this->TimeStep);
+    }
+
+  int changed = 0;
+  if (it != this->Internals->Cache.end())
+    {
+    it->second.LastUsed = ++this->Internals->UseCount;
+    this->Producer->SetOutput(it->second.Data);
+    this->OutputTimeStep = this->TimeStep;
+    this->NumberOfHits++;
+    changed = 1;
+    }
+  else
+    {
+    // Keep showing the previous step
+    this->NumberOfMisses++;
+    }
+
+  this->Lock->Unlock();
+
+  return changed;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelPrefetcher::GetNextTimeStep()
+{
+  int numberOfTimeSteps = static_cast<int>(this->Internals->TimeSteps.size());
+
+  // Never prefetch more than the cache can hold
+  int lookahead = this->Lookahead < this->CacheSize - 1 ? this->Lookahead : this->CacheSize - 1;
+
+  for (int i = 0; i <= lookahead; i++)
+    {
+    int timeStep = this->TimeStep + i;
+    if (timeStep >= numberOfTimeSteps)
+      {
+      if (!this->Loop)
+        {
+        break;
+        }
+      timeStep %= numberOfTimeSteps;
+      }
+
+    if (this->Internals->Cache.find(timeStep) == this->Internals->Cache.end() &&
+        this->Internals->InFlight.find(timeStep) == this->Internals->InFlight.end())
+      {
+      return timeStep;
+      }
+    }
+
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::Evict(int steps, double bytes)
+{
+  int numberOfTimeSteps = static_cast<int>(this->Internals->TimeSteps.size());
+  std::map<int, vtkMultiChannelPrefetcherInternals::Entry>& cache = this->Internals->Cache;
+
+  while (static_cast<int>(cache.size()) > steps || this->CacheMemory > bytes)
+    {
+    // Least recently used step, preferring steps behind the current one
+    std::map<int, vtkMultiChannelPrefetcherInternals::Entry>::iterator victim = cache.end();
+    int victimAhead = 1;
+
+    std::map<int, vtkMultiChannelPrefetcherInternals::Entry>::iterator it;
+    for (it = cache.begin(); it != cache.end(); ++it)
+      {
+      if (it->first == this->OutputTimeStep)
+        {
+        continue;
+        }
+
+      int distance = it->first - this->TimeStep;
+      if (distance < 0 && this->Loop)
+        {
+        distance += numberOfTimeSteps;
+        }
+      int ahead = distance >= 0 && distance <= this->Lookahead;
+
+      if (victim == cache.end() || ahead < victimAhead ||
+          (ahead == victimAhead && it->second.LastUsed < victim->second.LastUsed))
+        {
+        victim = it;
+        victimAhead = ahead;
+        }
+      }
+
+    if (victim == cache.end())
+      {
+      break;
+      }
+
+    victim->second.Data->Delete();
+    this->CacheMemory -= victim->second.Size;
+    cache.erase(victim);
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelPrefetcher::WorkerMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkMultiChannelPrefetcherInternals::Worker* worker =
+    static_cast<vtkMultiChannelPrefetcherInternals::Worker*>(info->UserData);
+  worker->Prefetcher->WorkerLoop(worker->Pipeline);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::WorkerLoop(vtkAlgorithm* pipeline)
+{
+  this->Lock->Lock();
+  while (!this->StopRequested)
+    {
+    int timeStep = this->GetNextTimeStep();
+    if (timeStep < 0)
+      {
+      this->WorkCondition->Wait(this->Lock);
+      continue;
+      }
+
+    this->Internals->InFlight.insert(timeStep);
+    double time = this->Internals->TimeSteps[timeStep];
+    this->Lock->Unlock();
+
+    // Execute the pipeline for the step
+    pipeline->UpdateInformation();
+    vtkStreamingDemandDrivenPipeline* executive =
+      vtkStreamingDemandDrivenPipeline::SafeDownCast(pipeline->GetExecutive());
+    if (executive)
+      {
+      executive->SetUpdateTimeSteps(0, &time, 1);
+      }
+    pipeline->Update();
+
+    // The next execution replaces the output's arrays rather than
+    // modifying them, so a shallow copy keeps this step's data
+    vtkDataObject* output = pipeline->GetOutputDataObject(0);
+    vtkDataObject* data = NULL;
+    if (output)
+      {
+      data = output->NewInstance();
+      data->ShallowCopy(output);
+      }
+
+    this->Lock->Lock();
+    this->Internals->InFlight.erase(timeStep);
+    this->NumberOfExecutions++;
+    if (data)
+      {
+      this->Evict(this->CacheSize - 1, VTK_DOUBLE_MAX);
+
+      vtkMultiChannelPrefetcherInternals::Entry entry;
+      entry.Data = data;
+      entry.Size = data->GetActualMemorySize() * 1024.0;
+      entry.LastUsed = ++this->Internals->UseCount;
+      this->Internals->Cache[timeStep] = entry;
+      this->CacheMemory += entry.Size;
+      }
+    this->ReadyCondition->Broadcast();
+    }
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelPrefetcher::GetNumberOfExecutions()
+{
+  this->Lock->Lock();
+  int executions = this->NumberOfExecutions;
+  this->Lock->Unlock();
+
+  return executions;
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelPrefetcher::GetCacheMemory()
+{
+  this->Lock->Lock();
+  double memory = this->CacheMemory;
+  this->Lock->Unlock();
+
+  return memory;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::Trim(double bytes)
+{
+  this->Lock->Lock();
+  this->Evict(VTK_INT_MAX, bytes);
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelPrefetcher::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Pipelines: " << this->Internals->Workers.size() << "\n";
+  os << indent << "Number Of Time Steps: " << this->Internals->TimeSteps.size() << "\n";
+  os << indent << "Time Step: " << this->TimeStep << "\n";
+  os << indent << "Output Time Step: " << this->OutputTimeStep << "\n";
+  os << indent << "Lookahead: " << this->Lookahead << "\n";
+  os << indent << "Cache Size: " << this->CacheSize << "\n";
+  os << indent << "Loop: " << this->Loop << "\n";
+  os << indent << "Wait For Data: " << this->WaitForData << "\n";
+  os << indent << "Running: " << this->Running << "\n";
+  os << indent << "Number Of Hits: " << this->NumberOfHits << "\n";
+  os << indent << "Number Of Misses: " << this->NumberOfMisses << "\n";
+  os << indent << "Number Of Executions: " << this->NumberOfExecutions << "\n";
+  os << indent << "Cache Memory: " << this->CacheMemory << "\n";
+}
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelPrefetcher.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelPrefetcher
+// .SECTION Description
+// vtkMultiChannelPrefetcher executes a time-varying pipeline ahead of
+// the render loop, so that reading and filtering the next time step does
+// not stall a frame.  Each pipeline added with AddPipeline() is run by
+// its own worker thread.  VTK pipelines are not thread safe, so each
+// must be a separate instance of the same reader and filters, not
+// connected to anything else.
+//
+// The workers update the current time step and the Lookahead steps after
+// it, and keep shallow copies of the outputs in a cache of at most
+// CacheSize steps.  Connect the rendering pipeline to GetOutputPort().
+// Set on a vtkMultiChannelRenderWindowHelper, Update() is called at the
+// start of each frame and swaps the requested time step into the output
+// if it is ready.  Otherwise the previous step is kept, unless
+// WaitForData is on.
+//
+// Time steps are taken from the first pipeline's TIME_STEPS when
+// Start() is called, unless set with SetTimeSteps().
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper
+
+#ifndef __vtkMultiChannelPrefetcher_h
+#define __vtkMultiChannelPrefetcher_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+#include "vtkMultiThreader.h"   // For VTK_THREAD_RETURN_TYPE
+
+class vtkAlgorithm;
+class vtkAlgorithmOutput;
+class vtkConditionVariable;
+class vtkMultiChannelPrefetcherInternals;
+class vtkMutexLock;
+class vtkTrivialProducer;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelPrefetcher : public vtkObject
+{
+public:
+  static vtkMultiChannelPrefetcher *New();
+  vtkTypeRevisionMacro(vtkMultiChannelPrefetcher,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Add a pipeline instance for a worker to execute.  Cannot be called
+  // while running.
+  void AddPipeline(vtkAlgorithm*);
+  void RemoveAllPipelines();
+
+  // Description:
+  // Time step values.  If not set, they are taken from the first
+  // pipeline when Start() is called.
+  void SetTimeSteps(int numberOfTimeSteps, const double* timeSteps);
+  int GetNumberOfTimeSteps();
+
+  // Description:
+  // Index of the time step to render
+  void SetTimeStep(int);
+  vtkGetMacro(TimeStep,int);
+
+  // Description:
+  // Index of the time step in the output
+  vtkGetMacro(OutputTimeStep,int);
+
+  // Description:
+  // Number of time steps after the current one to prefetch
+  vtkSetClampMacro(Lookahead,int,0,1024);
+  vtkGetMacro(Lookahead,int);
+
+  // Description:
+  // Maximum number of time steps cached
+  vtkSetClampMacro(CacheSize,int,1,1024);
+  vtkGetMacro(CacheSize,int);
+
+  // Description:
+  // Prefetch past the last time step from the first
+  vtkGetMacro(Loop,int);
+  vtkSetMacro(Loop,int);
+  vtkBooleanMacro(Loop,int);
+
+  // Description:
+  // Make Update() wait until the requested time step is ready
+  vtkGetMacro(WaitForData,int);
+  vtkSetMacro(WaitForData,int);
+  vtkBooleanMacro(WaitForData,int);
+
+  // Description:
+  // Port to connect the rendering pipeline to
+  vtkAlgorithmOutput* GetOutputPort();
+
+  // Description:
+  // Start and stop the workers
+  void Start();
+  void Stop();
+  vtkGetMacro(Running,int);
+
+  // Description:
+  // Swap the requested time step into the output if it is ready.
+  // Returns 1 if the output changed.  Called by the helper at the start
+  // of each frame.
+  int Update();
+
+  // Description:
+  // Frames whose time step was ready or not, and pipeline executions
+  vtkGetMacro(NumberOfHits,int);
+  vtkGetMacro(NumberOfMisses,int);
+  int GetNumberOfExecutions();
+
+  // Description:
+  // Memory in bytes held by the cached steps
+  double GetCacheMemory();
+
+  // Description:
+  // Evict cached steps, least useful first, until the cache fits in the
+  // given number of bytes.  The step shown is kept.
+  void Trim(double bytes);
+
+protected:
+  vtkMultiChannelPrefetcher();
+  ~vtkMultiChannelPrefetcher();
+
+  int TimeStep;
+  int OutputTimeStep;
+  int Lookahead;
+  int CacheSize;
+  int Loop;
+  int WaitForData;
+
+  int Running;
+  int StopRequested;
+
+  int NumberOfHits;
+  int NumberOfMisses;
+  int NumberOfExecutions;
+  double CacheMemory;
+
+  vtkTrivialProducer* Producer;
+
+  vtkMultiThreader* Threader;
+  vtkMutexLock* Lock;
+  vtkConditionVariable* WorkCondition;
+  vtkConditionVariable* ReadyCondition;
+
+  vtkMultiChannelPrefetcherInternals* Internals;
+
+  // Description:
+  // Worker thread entry point and loop
+  static VTK_THREAD_RETURN_TYPE WorkerMain(void*);
+  void WorkerLoop(vtkAlgorithm*);
+
+  // Description:
+  // Next time step a worker should execute, or -1.  Called locked.
+  int GetNextTimeStep();
+
+  // Description:
+  // Evict cached steps until at most the given number of steps and bytes
+  // are cached.  Called locked.
+  void Evict(int steps, double bytes);
+
+private:
+  vtkMultiChannelPrefetcher(const vtkMultiChannelPrefetcher&);  // Not implemented.
+  void operator=(const vtkMultiChannelPrefetcher&);  // Not implemented.
+};
+
+#endif
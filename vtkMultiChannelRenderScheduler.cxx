@@ -0,0 +1,213 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelRenderScheduler.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelRenderScheduler.h"
+
+#include "vtkCallbackCommand.h"
+#include "vtkCollection.h"
+#include "vtkCommand.h"
+#include "vtkMultiChannelAccumulator.h"
+#include "vtkMultiChannelRenderWindowHelper.h"
+#include "vtkMultiChannelSceneMonitor.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowInteractor.h"
+#include "vtkWin32OpenGLMultiChannelRenderWindow.h"
+
+vtkCxxRevisionMacro(vtkMultiChannelRenderScheduler, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelRenderScheduler);
+
+//----------------------------------------------------------------------------
+vtkMultiChannelRenderScheduler::vtkMultiChannelRenderScheduler()
+{
+  this->TargetFrameRate = 60.0;
+  this->SkipUnchanged = 1;
+
+  this->SceneMonitor = vtkMultiChannelSceneMonitor::New();
+
+  this->Interactor = NULL;
+  this->TimerCallback = vtkCallbackCommand::New();
+  this->TimerCallback->SetCallback(&vtkMultiChannelRenderScheduler::TimerEvent);
+  this->TimerCallback->SetClientData(this);
+  this->TimerObserver = 0;
+  this->TimerId = -1;
+
+  this->Running = 0;
+  this->Executing = 0;
+
+  this->Pending = 0;
+  this->PendingLock = vtkMutexLock::New();
+
+  this->NumberOfRequestedRenders = 0;
+  this->NumberOfExecutedRenders = 0;
+  this->NumberOfSkippedRenders = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelRenderScheduler::~vtkMultiChannelRenderScheduler()
+{
+  this->Stop();
+
+  this->SceneMonitor->Delete();
+  this->TimerCallback->Delete();
+  this->PendingLock->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderScheduler::Start(vtkRenderWindowInteractor* interactor)
+{
+  if (this->Running)
+    {
+    return;
+    }
+
+  if (!interactor || !interactor->GetRenderWindow())
+    {
+    vtkErrorMacro(<< "No interactor with a render window given.");
+    return;
+    }
+
+  this->Interactor = interactor;
+  this->Interactor->Register(this);
+
+  this->TimerObserver = interactor->AddObserver(vtkCommand::TimerEvent, this->TimerCallback);
+  this->TimerId = interactor->CreateRepeatingTimer(
+    static_cast<unsigned long>(1000.0 / this->TargetFrameRate));
+
+  // The first tick renders whatever is there
+  this->SceneMonitor->Reset();
+  this->Pending = 1;
+
+  this->Running = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderScheduler::Stop()
+{
+  if (!this->Running)
+    {
+    return;
+    }
+
+  this->Interactor->DestroyTimer(this->TimerId);
+  this->Interactor->RemoveObserver(this->TimerObserver);
+  this->Interactor->UnRegister(this);
+  this->Interactor = NULL;
+  this->TimerId = -1;
+
+  this->Running = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderScheduler::RequestRender()
+{
+  this->PendingLock->Lock();
+  this->Pending = 1;
+  this->NumberOfRequestedRenders++;
+  this->PendingLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderScheduler::GetNumberOfRequestedRenders()
+{
+  this->PendingLock->Lock();
+  int numberOfRequestedRenders = this->NumberOfRequestedRenders;
+  this->PendingLock->Unlock();
+
+  return numberOfRequestedRenders;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderScheduler::ResetCounters()
+{
+  this->PendingLock->Lock();
+  this->NumberOfRequestedRenders = 0;
+  this->PendingLock->Unlock();
+
+  this->NumberOfExecutedRenders = 0;
+  this->NumberOfSkippedRenders = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderScheduler::TimerEvent(vtkObject*, unsigned long, void* clientData, void* callData)
+{
+  vtkMultiChannelRenderScheduler* self = static_cast<vtkMultiChannelRenderScheduler*>(clientData);
+
+  // Other timers on the interactor are not ours
+  if (!self->Running || !callData || *static_cast<int*>(callData) != self->TimerId)
+    {
+    return;
+    }
+
+  self->Execute();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderScheduler::Execute()
+{
+  this->PendingLock->Lock();
+  int pending = this->Pending;
+  this->Pending = 0;
+  this->PendingLock->Unlock();
+
+  vtkRenderWindow* window = this->Interactor->GetRenderWindow();
+
+  vtkWin32OpenGLMultiChannelRenderWindow* multiChannelWindow =
+    vtkWin32OpenGLMultiChannelRenderWindow::SafeDownCast(window);
+  vtkMultiChannelRenderWindowHelper* helper = multiChannelWindow ? multiChannelWindow->GetHelper() : NULL;
+
+  // Keep rendering until a still scene is fully antialiased
+  vtkMultiChannelAccumulator* accumulator = helper ? helper->GetAccumulator() : NULL;
+  int accumulating = accumulator && accumulator->GetEnabled() && !accumulator->GetSuspended() &&
+    accumulator->GetNumberOfAccumulatedFrames() < accumulator->GetMaximumNumberOfFrames();
+
+  if (!pending && !accumulating)
+    {
+    return;
+    }
+
+  if (this->SkipUnchanged && helper)
+    {
+    int changed = this->SceneMonitor->Update(window->GetRenderers(), helper->GetChannels());
+    if (!changed && !accumulating)
+      {
+      this->NumberOfSkippedRenders++;
+      return;
+      }
+    }
+
+  this->Executing = 1;
+  window->Render();
+  this->Executing = 0;
+
+  this->NumberOfExecutedRenders++;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderScheduler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Target Frame Rate: " << this->TargetFrameRate << "\n";
+  os << indent << "Skip Unchanged: " << this->SkipUnchanged << "\n";
+  os << indent << "Running: " << this->Running << "\n";
+  os << indent << "Number Of Requested Renders: " << this->GetNumberOfRequestedRenders() << "\n";
+  os << indent << "Number Of Executed Renders: " << this->NumberOfExecutedRenders << "\n";
+  os << indent << "Number Of Skipped Renders: " << this->NumberOfSkippedRenders << "\n";
+  os << indent << "Scene Monitor:\n";
+  this->SceneMonitor->PrintSelf(os,indent.GetNextIndent());
+}
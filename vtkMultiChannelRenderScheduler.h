@@ -0,0 +1,129 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelRenderScheduler.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelRenderScheduler
+// .SECTION Description
+// vtkMultiChannelRenderScheduler renders a multi-channel window on
+// demand, at most once per display refresh, however many renders are
+// asked for.  Once started and set on the window's
+// vtkMultiChannelRenderWindowHelper, calls to Render() on the window
+// only mark a render as pending.  A repeating timer on the interactor
+// renders the window once per tick if a render is pending.  Timer events
+// are only handled once the interaction events queued before them are,
+// so all of those are merged into one render.
+//
+// If SkipUnchanged is on, a pending render is skipped when its
+// vtkMultiChannelSceneMonitor sees nothing changed since the last one.
+// Frames are still rendered while the helper's accumulator has not
+// finished its average.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkMultiChannelSceneMonitor
+// vtkMultiChannelRenderThread
+
+#ifndef __vtkMultiChannelRenderScheduler_h
+#define __vtkMultiChannelRenderScheduler_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkCallbackCommand;
+class vtkMultiChannelSceneMonitor;
+class vtkMutexLock;
+class vtkRenderWindowInteractor;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelRenderScheduler : public vtkObject
+{
+public:
+  static vtkMultiChannelRenderScheduler *New();
+  vtkTypeRevisionMacro(vtkMultiChannelRenderScheduler,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Maximum number of renders per second
+  vtkSetClampMacro(TargetFrameRate,double,1.0,1000.0);
+  vtkGetMacro(TargetFrameRate,double);
+
+  // Description:
+  // Skip renders when nothing has changed
+  vtkSetMacro(SkipUnchanged,int);
+  vtkGetMacro(SkipUnchanged,int);
+  vtkBooleanMacro(SkipUnchanged,int);
+
+  // Description:
+  // Tells when the scene has changed
+  vtkGetObjectMacro(SceneMonitor,vtkMultiChannelSceneMonitor);
+
+  // Description:
+  // Start and stop scheduling the renders of the interactor's window.
+  // Call from the thread that runs the interactor.
+  void Start(vtkRenderWindowInteractor*);
+  void Stop();
+  vtkGetMacro(Running,int);
+
+  // Description:
+  // Mark a render as pending.  Safe to call from any thread.
+  void RequestRender();
+
+  // Description:
+  // True while the scheduler renders the window
+  vtkGetMacro(Executing,int);
+
+  // Description:
+  // Renders requested, rendered, and skipped as unchanged
+  int GetNumberOfRequestedRenders();
+  vtkGetMacro(NumberOfExecutedRenders,int);
+  vtkGetMacro(NumberOfSkippedRenders,int);
+  void ResetCounters();
+
+protected:
+  vtkMultiChannelRenderScheduler();
+  ~vtkMultiChannelRenderScheduler();
+
+  double TargetFrameRate;
+  int SkipUnchanged;
+
+  vtkMultiChannelSceneMonitor* SceneMonitor;
+
+  vtkRenderWindowInteractor* Interactor;
+  vtkCallbackCommand* TimerCallback;
+  unsigned long TimerObserver;
+  int TimerId;
+
+  int Running;
+  int Executing;
+
+  int Pending;
+  vtkMutexLock* PendingLock;
+
+  int NumberOfRequestedRenders;
+  int NumberOfExecutedRenders;
+  int NumberOfSkippedRenders;
+
+  // Description:
+  // Timer callback
+  static void TimerEvent(vtkObject*, unsigned long, void* clientData, void* callData);
+
+  // Description:
+  // Render the window if a render is pending and needed
+  void Execute();
+
+private:
+  vtkMultiChannelRenderScheduler(const vtkMultiChannelRenderScheduler&);  // Not implemented.
+  void operator=(const vtkMultiChannelRenderScheduler&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,285 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelRenderTargetPool.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelRenderTargetPool.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+#include "vtkTextureObject.h"
+
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelRenderTargetPool, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelRenderTargetPool);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelRenderTargetPoolInternals
+{
+public:
+  struct Target
+  {
+    vtkTextureObject* Texture;
+    int Width;
+    int Height;
+    int Components;
+    int Type;
+    int Depth;
+    double Size;
+    int InUse;
+    int LastUsedFrame;
+  };
+
+  std::vector<Target> Targets;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelRenderTargetPool::vtkMultiChannelRenderTargetPool()
+{
+  this->Context = NULL;
+
+  this->BucketSize = 64;
+  this->MemoryCap = 256.0 * 1024.0 * 1024.0;
+
+  this->CurrentMemory = 0;
+  this->PeakMemory = 0;
+  this->NumberOfAllocations = 0;
+
+  this->FrameNumber = 0;
+
+  this->Internals = new vtkMultiChannelRenderTargetPoolInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelRenderTargetPool::~vtkMultiChannelRenderTargetPool()
+{
+  for (unsigned int i = 0; i < this->Internals->Targets.size(); i++)
+    {
+    this->Internals->Targets[i].Texture->Delete();
+    }
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderTargetPool::SetContext(vtkRenderWindow* context)
+{
+  if (this->Context == context)
+    {
+    return;
+    }
+
+  // Targets from the old context cannot be used with the new one
+  this->ReleaseUnusedTargets();
+
+  // Not reference counted, as the pool is owned by the window's helper
+  this->Context = context;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkTextureObject* vtkMultiChannelRenderTargetPool::AcquireColorTarget(int width, int height, int components)
+{
+  return this->Acquire(width, height, components, VTK_UNSIGNED_CHAR, 0);
+}
+
+//----------------------------------------------------------------------------
+vtkTextureObject* vtkMultiChannelRenderTargetPool::AcquireFloatColorTarget(int width, int height, int components)
+{
+  return this->Acquire(width, height, components, VTK_FLOAT, 0);
+}
+
+//----------------------------------------------------------------------------
+vtkTextureObject* vtkMultiChannelRenderTargetPool::AcquireDepthTarget(int width, int height)
+{
+  return this->Acquire(width, height, 1, VTK_UNSIGNED_INT, 1);
+}
+
+//----------------------------------------------------------------------------
+vtkTextureObject* vtkMultiChannelRenderTargetPool::Acquire(int width, int height, int components, int type, int depth)
+{
+  if (!this->Context || width <= 0 || height <= 0)
+    {
+    return NULL;
+    }
+
+  // Round up to the bucket
+  width = (width + this->BucketSize - 1) / this->BucketSize * this->BucketSize;
+  height = (height + this->BucketSize - 1) / this->BucketSize * this->BucketSize;
+
+  std::vector<vtkMultiChannelRenderTargetPoolInternals::Target>& targets = this->Internals->Targets;
+  for (unsigned int i = 0; i < targets.size(); i++)
+    {
+    vtkMultiChannelRenderTargetPoolInternals::Target& target = targets[i];
+    if (!target.InUse && target.Width == width && target.Height == height &&
+        target.Components == components && target.Type == type && target.Depth == depth)
+      {
+      target.InUse = 1;
+      target.LastUsedFrame = this->FrameNumber;
+      return target.Texture;
+      }
+    }
+
+  // Make room for the new target
+  double size = static_cast<double>(width) * height *
+    (depth ? 4 : components * (type == VTK_FLOAT ? 4 : 1));
+  if (this->MemoryCap > 0)
+    {
+    this->Trim(this->MemoryCap - size);
+    }
+
+  vtkTextureObject* texture = vtkTextureObject::New();
+  texture->SetContext(this->Context);
+
+  bool created;
+  if (depth)
+    {
+    created = texture->AllocateDepth(width, height, vtkTextureObject::Fixed24);
+    }
+  else
+    {
+    created = texture->Create2D(width, height, components, type, false);
+    }
+
+  if (!created)
+    {
+    vtkErrorMacro(<< "Could not create a " << width << "x" << height << " render target.");
+    texture->Delete();
+    return NULL;
+    }
+
+  vtkMultiChannelRenderTargetPoolInternals::Target target;
+  target.Texture = texture;
+  target.Width = width;
+  target.Height = height;
+  target.Components = components;
+  target.Type = type;
+  target.Depth = depth;
+  target.Size = size;
+  target.InUse = 1;
+  target.LastUsedFrame = this->FrameNumber;
+  targets.push_back(target);
+
+  this->NumberOfAllocations++;
+  this->CurrentMemory += size;
+  if (this->CurrentMemory > this->PeakMemory)
+    {
+    this->PeakMemory = this->CurrentMemory;
+    }
+
+  return texture;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderTargetPool::Release(vtkTextureObject* texture)
+{
+  std::vector<vtkMultiChannelRenderTargetPoolInternals::Target>& targets = this->Internals->Targets;
+  for (unsigned int i = 0; i < targets.size(); i++)
+    {
+    if (targets[i].Texture == texture)
+      {
+      targets[i].InUse = 0;
+      targets[i].LastUsedFrame = this->FrameNumber;
+      return;
+      }
+    }
+
+  vtkWarningMacro(<< "Released a target not from this pool.");
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderTargetPool::EndFrame()
+{
+  this->FrameNumber++;
+
+  if (this->MemoryCap > 0)
+    {
+    this->Trim(this->MemoryCap);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderTargetPool::Trim(double bytes)
+{
+  std::vector<vtkMultiChannelRenderTargetPoolInternals::Target>& targets = this->Internals->Targets;
+
+  while (this->CurrentMemory > bytes)
+    {
+    // Least recently used target not in use
+    int oldest = -1;
+    for (unsigned int i = 0; i < targets.size(); i++)
+      {
+      if (!targets[i].InUse &&
+          (oldest < 0 || targets[i].LastUsedFrame < targets[oldest].LastUsedFrame))
+        {
+        oldest = static_cast<int>(i);
+        }
+      }
+    if (oldest < 0)
+      {
+      break;
+      }
+
+    this->CurrentMemory -= targets[oldest].Size;
+    targets[oldest].Texture->Delete();
+    targets.erase(targets.begin() + oldest);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderTargetPool::ReleaseUnusedTargets()
+{
+  this->Trim(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderTargetPool::ResetCounters()
+{
+  this->PeakMemory = this->CurrentMemory;
+  this->NumberOfAllocations = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderTargetPool::GetNumberOfTargets()
+{
+  return static_cast<int>(this->Internals->Targets.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderTargetPool::GetNumberOfTargetsInUse()
+{
+  int inUse = 0;
+  for (unsigned int i = 0; i < this->Internals->Targets.size(); i++)
+    {
+    inUse += this->Internals->Targets[i].InUse;
+    }
+
+  return inUse;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderTargetPool::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Context: " << this->Context << "\n";
+  os << indent << "Bucket Size: " << this->BucketSize << "\n";
+  os << indent << "Memory Cap: " << this->MemoryCap << "\n";
+  os << indent << "Current Memory: " << this->CurrentMemory << "\n";
+  os << indent << "Peak Memory: " << this->PeakMemory << "\n";
+  os << indent << "Number Of Allocations: " << this->NumberOfAllocations << "\n";
+  os << indent << "Number Of Targets: " << this->GetNumberOfTargets() << "\n";
+  os << indent << "Number Of Targets In Use: " << this->GetNumberOfTargetsInUse() << "\n";
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelRenderTargetPool.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelRenderTargetPool
+// .SECTION Description
+// vtkMultiChannelRenderTargetPool hands out color and depth textures to
+// be used as offscreen render targets by per-channel rendering, and
+// takes them back for reuse by other channels and later frames.
+// Requested sizes are rounded up to a multiple of BucketSize, so small
+// changes in size reuse the same targets.  A target may therefore be
+// larger than requested; render to the requested part of it.
+//
+// Targets that are not in use are kept until the pool exceeds its
+// MemoryCap, at which point the least recently used ones are deleted.
+// Each vtkMultiChannelRenderWindowHelper owns a pool for its window, and
+// gives it to its vtkMultiChannelAccumulator and
+// vtkMultiChannelReprojector for their images.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkMultiChannelAccumulator
+// vtkMultiChannelReprojector vtkTextureObject
+
+#ifndef __vtkMultiChannelRenderTargetPool_h
+#define __vtkMultiChannelRenderTargetPool_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkMultiChannelRenderTargetPoolInternals;
+class vtkRenderWindow;
+class vtkTextureObject;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelRenderTargetPool : public vtkObject
+{
+public:
+  static vtkMultiChannelRenderTargetPool *New();
+  vtkTypeRevisionMacro(vtkMultiChannelRenderTargetPool,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Window whose context the targets are created in.  Not reference
+  // counted.  Changing it deletes the targets not in use.
+  void SetContext(vtkRenderWindow*);
+  vtkGetObjectMacro(Context,vtkRenderWindow);
+
+  // Description:
+  // Granularity in pixels of target sizes
+  vtkSetClampMacro(BucketSize,int,1,4096);
+  vtkGetMacro(BucketSize,int);
+
+  // Description:
+  // Memory in bytes above which unused targets are deleted.  0 means no
+  // cap.
+  vtkSetClampMacro(MemoryCap,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MemoryCap,double);
+
+  // Description:
+  // Get a color target with the given number of 8-bit or 32-bit float
+  // components, or a 24-bit depth target, at least the given size.
+  // Returns NULL if the target cannot be created.  Give it back with
+  // Release().
+  vtkTextureObject* AcquireColorTarget(int width, int height, int components = 4);
+  vtkTextureObject* AcquireFloatColorTarget(int width, int height, int components = 4);
+  vtkTextureObject* AcquireDepthTarget(int width, int height);
+
+  // Description:
+  // Return a target to the pool
+  void Release(vtkTextureObject*);
+
+  // Description:
+  // Called once per frame by the helper.  Trims the pool to its cap.
+  void EndFrame();
+
+  // Description:
+  // Delete unused targets, least recently used first, until the pool
+  // is within the given number of bytes
+  void Trim(double bytes);
+
+  // Description:
+  // Delete all unused targets
+  void ReleaseUnusedTargets();
+
+  // Description:
+  // Memory in bytes held by the pool now and at most since the counters
+  // were reset, and the number of targets created
+  vtkGetMacro(CurrentMemory,double);
+  vtkGetMacro(PeakMemory,double);
+  vtkGetMacro(NumberOfAllocations,int);
+  void ResetCounters();
+
+  // Description:
+  // Number of targets held, and of those in use
+  int GetNumberOfTargets();
+  int GetNumberOfTargetsInUse();
+
+protected:
+  vtkMultiChannelRenderTargetPool();
+  ~vtkMultiChannelRenderTargetPool();
+
+  vtkRenderWindow* Context;
+
+  int BucketSize;
+  double MemoryCap;
+
+  double CurrentMemory;
+  double PeakMemory;
+  int NumberOfAllocations;
+
+  int FrameNumber;
+
+  vtkMultiChannelRenderTargetPoolInternals* Internals;
+
+  // Description:
+  // Get a target of the given VTK scalar type, or a depth target
+  vtkTextureObject* Acquire(int width, int height, int components, int type, int depth);
+
+private:
+  vtkMultiChannelRenderTargetPool(const vtkMultiChannelRenderTargetPool&);  // Not implemented.
+  void operator=(const vtkMultiChannelRenderTargetPool&);  // Not implemented.
+};
+
+#endif
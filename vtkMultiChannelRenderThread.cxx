@@ -0,0 +1,226 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelRenderThread.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelRenderThread.h"
+
+#include "vtkConditionVariable.h"
+#include "vtkMultiChannelSceneState.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindow.h"
+
+#ifdef _WIN32
+# include "vtkWindows.h"
+#endif
+
+vtkCxxRevisionMacro(vtkMultiChannelRenderThread, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelRenderThread);
+
+vtkCxxSetObjectMacro(vtkMultiChannelRenderThread, SceneState, vtkMultiChannelSceneState);
+
+//----------------------------------------------------------------------------
+vtkMultiChannelRenderThread::vtkMultiChannelRenderThread()
+{
+  this->RenderWindow = NULL;
+  this->SceneState = NULL;
+
+  this->Threader = vtkMultiThreader::New();
+  this->ThreadId = -1;
+  this->RenderThreadId = vtkMultiThreader::GetCurrentThreadID();
+  this->HasRenderThreadId = 0;
+
+  this->Lock = vtkMutexLock::New();
+  this->Condition = vtkConditionVariable::New();
+
+  this->Running = 0;
+  this->Pending = 0;
+  this->StopRequested = 0;
+
+  this->NumberOfRequestedFrames = 0;
+  this->NumberOfRenderedFrames = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelRenderThread::~vtkMultiChannelRenderThread()
+{
+  this->Stop();
+
+  this->SetSceneState(NULL);
+
+  this->Threader->Delete();
+  this->Lock->Delete();
+  this->Condition->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderThread::SetRenderWindow(vtkRenderWindow* window)
+{
+  if (this->Running)
+    {
+    vtkErrorMacro(<< "Cannot change the render window while the thread is running.");
+    return;
+    }
+
+  // Not reference counted, to avoid a cycle through the window's helper
+  this->RenderWindow = window;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderThread::Start()
+{
+  if (this->Running)
+    {
+    return;
+    }
+
+  if (!this->RenderWindow)
+    {
+    vtkErrorMacro(<< "No render window set.");
+    return;
+    }
+
+  // Release the context on this thread so the render thread can take it
+#ifdef _WIN32
+  wglMakeCurrent(NULL, NULL);
+#endif
+
+  this->StopRequested = 0;
+  this->Pending = 1;
+  this->HasRenderThreadId = 0;
+  this->Running = 1;
+
+  this->ThreadId = this->Threader->SpawnThread(
+    &vtkMultiChannelRenderThread::ThreadMain, this);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderThread::Stop()
+{
+  if (!this->Running)
+    {
+    return;
+    }
+
+  this->Lock->Lock();
+  this->StopRequested = 1;
+  this->Condition->Signal();
+  this->Lock->Unlock();
+
+  // Waits for the render loop to finish
+  this->Threader->TerminateThread(this->ThreadId);
+  this->ThreadId = -1;
+  this->Running = 0;
+
+  // Take the context back
+  this->RenderWindow->MakeCurrent();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderThread::RequestRender()
+{
+  if (this->SceneState)
+    {
+    this->SceneState->Publish();
+    }
+
+  this->Lock->Lock();
+  this->Pending = 1;
+  this->NumberOfRequestedFrames++;
+  this->Condition->Signal();
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderThread::IsRenderThread()
+{
+  if (!this->Running)
+    {
+    return 0;
+    }
+
+  this->Lock->Lock();
+  int isRenderThread = this->HasRenderThreadId &&
+    vtkMultiThreader::ThreadsEqual(this->RenderThreadId,
+                                   vtkMultiThreader::GetCurrentThreadID());
+  this->Lock->Unlock();
+
+  return isRenderThread;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelRenderThread::ThreadMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  static_cast<vtkMultiChannelRenderThread*>(info->UserData)->RenderLoop();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderThread::RenderLoop()
+{
+  this->Lock->Lock();
+  this->RenderThreadId = vtkMultiThreader::GetCurrentThreadID();
+  this->HasRenderThreadId = 1;
+  this->Lock->Unlock();
+
+  this->RenderWindow->MakeCurrent();
+
+  this->Lock->Lock();
+  while (!this->StopRequested)
+    {
+    while (!this->Pending && !this->StopRequested)
+      {
+      this->Condition->Wait(this->Lock);
+      }
+    if (this->StopRequested)
+      {
+      break;
+      }
+
+    // Requests made while rendering are merged into the next frame
+    this->Pending = 0;
+    this->Lock->Unlock();
+
+    if (this->SceneState)
+      {
+      this->SceneState->Apply(this->RenderWindow->GetRenderers());
+      }
+    this->RenderWindow->Render();
+
+    this->Lock->Lock();
+    this->NumberOfRenderedFrames++;
+    }
+  this->Lock->Unlock();
+
+  // Hand the context back
+#ifdef _WIN32
+  wglMakeCurrent(NULL, NULL);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderThread::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Render Window: " << this->RenderWindow << "\n";
+  os << indent << "Scene State: " << this->SceneState << "\n";
+  os << indent << "Running: " << this->Running << "\n";
+  os << indent << "Number Of Requested Frames: " << this->NumberOfRequestedFrames << "\n";
+  os << indent << "Number Of Rendered Frames: " << this->NumberOfRenderedFrames << "\n";
+}
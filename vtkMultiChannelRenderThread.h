@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelRenderThread.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelRenderThread
+// .SECTION Description
+// vtkMultiChannelRenderThread renders a multi-channel window on its own
+// thread, so that interaction and application logic do not stall behind
+// rendering all of the channels.  Once the thread is started and set on
+// the window's vtkMultiChannelRenderWindowHelper, calls to Render() on
+// the window from any other thread publish the vtkMultiChannelSceneState
+// and return immediately.  The render thread applies the newest snapshot
+// and renders, so requests made while a frame is in flight are merged.
+//
+// The window must be rendered once on the application thread before
+// Start() is called, so that it is mapped and has a context.  Start()
+// hands the context over to the render thread and Stop() hands it back.
+// The window is not reference counted and must outlive the thread.
+// vtkMultiChannelRenderWindowManager::StartRenderThread() sets up a
+// thread and scene state for a window so that the interactor's camera
+// is only read through snapshots.
+
+// .SECTION see also
+// vtkMultiChannelSceneState vtkMultiChannelRenderWindowHelper
+// vtkMultiChannelRenderWindowManager
+
+#ifndef __vtkMultiChannelRenderThread_h
+#define __vtkMultiChannelRenderThread_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+#include "vtkMultiThreader.h"   // For vtkMultiThreaderIDType
+
+class vtkConditionVariable;
+class vtkMultiChannelSceneState;
+class vtkMutexLock;
+class vtkRenderWindow;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelRenderThread : public vtkObject
+{
+public:
+  static vtkMultiChannelRenderThread *New();
+  vtkTypeRevisionMacro(vtkMultiChannelRenderThread,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // The window rendered by the thread
+  void SetRenderWindow(vtkRenderWindow*);
+  vtkGetObjectMacro(RenderWindow,vtkRenderWindow);
+
+  // Description:
+  // Scene state published by RequestRender() and applied before
+  // each frame
+  void SetSceneState(vtkMultiChannelSceneState*);
+  vtkGetObjectMacro(SceneState,vtkMultiChannelSceneState);
+
+  // Description:
+  // Start and stop the render thread
+  void Start();
+  void Stop();
+  vtkGetMacro(Running,int);
+
+  // Description:
+  // Publish the scene state and wake the render thread.  Does not wait
+  // for the frame to be rendered.
+  void RequestRender();
+
+  // Description:
+  // Returns 1 if called from the render thread
+  int IsRenderThread();
+
+  // Description:
+  // Number of frames requested and rendered
+  vtkGetMacro(NumberOfRequestedFrames,int);
+  vtkGetMacro(NumberOfRenderedFrames,int);
+
+protected:
+  vtkMultiChannelRenderThread();
+  ~vtkMultiChannelRenderThread();
+
+  vtkRenderWindow* RenderWindow;
+  vtkMultiChannelSceneState* SceneState;
+
+  vtkMultiThreader* Threader;
+  int ThreadId;
+  vtkMultiThreaderIDType RenderThreadId;
+  int HasRenderThreadId;
+
+  vtkMutexLock* Lock;
+  vtkConditionVariable* Condition;
+
+  int Running;
+  int Pending;
+  int StopRequested;
+
+  int NumberOfRequestedFrames;
+  int NumberOfRenderedFrames;
+
+  // Description:
+  // Thread entry point and render loop
+  static VTK_THREAD_RETURN_TYPE ThreadMain(void*);
+  void RenderLoop();
+
+private:
+  vtkMultiChannelRenderThread(const vtkMultiChannelRenderThread&);  // Not implemented.
+  void operator=(const vtkMultiChannelRenderThread&);  // Not implemented.
+};
+
+#endif
@@ -17,26 +17,174 @@
 #include "vtkMultiChannelRenderWindowHelper.h"
 
 #include "vtkCollection.h"
+#include "vtkCriticalSection.h"
+#include "vtkIntArray.h"
+#include "vtkMultiChannelAccumulator.h"
+#include "vtkMultiChannelCameraPath.h"
+#include "vtkMultiChannelFramePacer.h"
+#include "vtkMultiChannelFrameRecorder.h"
+#include "vtkMultiChannelFrameStreamer.h"
+#include "vtkMultiChannelGLStateCache.h"
+#include "vtkMultiChannelMemoryMonitor.h"
+#include "vtkMultiChannelPrefetcher.h"
+#include "vtkMultiChannelRenderScheduler.h"
+#include "vtkMultiChannelRenderTargetPool.h"
+#include "vtkMultiChannelRenderThread.h"
+#include "vtkMultiChannelReprojector.h"
+#include "vtkMultiChannelStreamer.h"
+#include "vtkMultiChannelTracer.h"
 #include "vtkMultiChannelRenderWindowHelper.h"
 #include "vtkObjectFactory.h"
+#include "vtkOpenGLMultiChannelCamera.h"
+#include "vtkOpenGLMultiChannelRenderer.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderWindowChannel.h"
 #include "vtkRendererCollection.h"
 #include "vtkRenderer.h"
 
+#include <stdio.h>
+
 vtkCxxRevisionMacro(vtkMultiChannelRenderWindowHelper, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkMultiChannelRenderWindowHelper);
 
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, RenderThread, vtkMultiChannelRenderThread);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, RenderScheduler, vtkMultiChannelRenderScheduler);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, FramePacer, vtkMultiChannelFramePacer);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, FrameRecorder, vtkMultiChannelFrameRecorder);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, FrameStreamer, vtkMultiChannelFrameStreamer);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, CameraPath, vtkMultiChannelCameraPath);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, Prefetcher, vtkMultiChannelPrefetcher);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, Streamer, vtkMultiChannelStreamer);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, MemoryMonitor, vtkMultiChannelMemoryMonitor);
+vtkCxxSetObjectMacro(vtkMultiChannelRenderWindowHelper, Tracer, vtkMultiChannelTracer);
+
 //----------------------------------------------------------------------------
 vtkMultiChannelRenderWindowHelper::vtkMultiChannelRenderWindowHelper() 
 {
   this->Channels = vtkCollection::New();
+
+  this->PendingChannels = vtkCollection::New();
+  this->HasPendingChannels = 0;
+  this->PendingStereo = -1;
+  this->PendingChannelsLock = new vtkSimpleCriticalSection;
+
+  this->DirectRendering = 0;
+  this->DirectRenderThreadStopped = 0;
+  this->DirectPacerEnabled = 0;
+
+  this->OverlayRenderers = vtkRendererCollection::New();
+  this->OverlayChannels = vtkIntArray::New();
+  this->InteractionRenderers = vtkRendererCollection::New();
+  this->InteractionTargets = vtkRendererCollection::New();
+  this->ChannelRenderers = vtkRendererCollection::New();
+
+  this->RenderThread = NULL;
+
+  this->RenderScheduler = NULL;
+
+  this->FramePacer = NULL;
+
+  this->Accumulator = NULL;
+
+  this->Reprojector = NULL;
+
+  this->FrameRecorder = NULL;
+
+  this->FrameStreamer = NULL;
+
+  this->CameraPath = NULL;
+
+  this->Prefetcher = NULL;
+
+  this->Streamer = NULL;
+
+  this->MemoryMonitor = NULL;
+
+  this->Tracer = NULL;
+
+  this->RenderTargetPool = vtkMultiChannelRenderTargetPool::New();
+
+  this->GLStateCache = vtkMultiChannelGLStateCache::New();
 }
 
 //----------------------------------------------------------------------------
 vtkMultiChannelRenderWindowHelper::~vtkMultiChannelRenderWindowHelper() 
 {
   this->Channels->Delete();
+
+  this->PendingChannels->Delete();
+  delete this->PendingChannelsLock;
+
+  this->OverlayRenderers->Delete();
+  this->OverlayChannels->Delete();
+  this->InteractionRenderers->Delete();
+  this->InteractionTargets->Delete();
+  this->ChannelRenderers->Delete();
+
+  this->SetRenderThread(NULL);
+  this->SetRenderScheduler(NULL);
+  this->SetFramePacer(NULL);
+  this->SetAccumulator(NULL);
+  this->SetReprojector(NULL);
+  this->SetFrameRecorder(NULL);
+  this->SetFrameStreamer(NULL);
+  this->SetCameraPath(NULL);
+  this->SetPrefetcher(NULL);
+  this->SetStreamer(NULL);
+  this->SetMemoryMonitor(NULL);
+  this->SetTracer(NULL);
+
+  this->RenderTargetPool->Delete();
+
+  this->GLStateCache->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::SetAccumulator(vtkMultiChannelAccumulator* accumulator)
+{
+  if (this->Accumulator == accumulator)
+    {
+    return;
+    }
+
+  if (this->Accumulator)
+    {
+    this->Accumulator->UnRegister(this);
+    }
+
+  // Its averages are taken from the pool
+  this->Accumulator = accumulator;
+  if (this->Accumulator)
+    {
+    this->Accumulator->Register(this);
+    this->Accumulator->SetRenderTargetPool(this->RenderTargetPool);
+    }
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::SetReprojector(vtkMultiChannelReprojector* reprojector)
+{
+  if (this->Reprojector == reprojector)
+    {
+    return;
+    }
+
+  if (this->Reprojector)
+    {
+    this->Reprojector->UnRegister(this);
+    }
+
+  // Its images are taken from the pool
+  this->Reprojector = reprojector;
+  if (this->Reprojector)
+    {
+    this->Reprojector->Register(this);
+    this->Reprojector->SetRenderTargetPool(this->RenderTargetPool);
+    }
+
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -45,21 +193,531 @@ vtkCollection *vtkMultiChannelRenderWindowHelper::GetChannels()
   return this->Channels;
 }
 
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::SwapChannels(vtkCollection* channels, int stereo)
+{
+  this->PendingChannelsLock->Lock();
+  this->PendingChannels->RemoveAllItems();
+  if (channels)
+    {
+    for (int i = 0; i < channels->GetNumberOfItems(); i++)
+      {
+      this->PendingChannels->AddItem(channels->GetItemAsObject(i));
+      }
+    }
+  this->HasPendingChannels = 1;
+  this->PendingStereo = stereo;
+  this->PendingChannelsLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::ApplyPendingChannels(vtkRenderWindow* window)
+{
+  this->PendingChannelsLock->Lock();
+  if (this->HasPendingChannels)
+    {
+    this->Channels->RemoveAllItems();
+    for (int i = 0; i < this->PendingChannels->GetNumberOfItems(); i++)
+      {
+      this->Channels->AddItem(this->PendingChannels->GetItemAsObject(i));
+      }
+    this->PendingChannels->RemoveAllItems();
+    this->HasPendingChannels = 0;
+
+    // In the same frame as the channels that need it
+    if (this->PendingStereo >= 0 && window)
+      {
+      window->SetStereoRender(this->PendingStereo);
+      }
+    this->PendingStereo = -1;
+    }
+  this->PendingChannelsLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::AddOverlayRenderer(vtkRenderer* renderer)
+{
+  this->AddOverlayRenderer(renderer, -1);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::AddOverlayRenderer(vtkRenderer* renderer, int channel)
+{
+  if (!renderer)
+    {
+    return;
+    }
+
+  // The channel's view is applied to the camera
+  if (channel >= 0 && !vtkOpenGLMultiChannelCamera::SafeDownCast(renderer->GetActiveCamera()))
+    {
+    vtkErrorMacro(<< "An overlay rendered in a channel needs a vtkOpenGLMultiChannelCamera.");
+    return;
+    }
+
+  int i = this->OverlayRenderers->IsItemPresent(renderer);
+  if (i)
+    {
+    // Move an overlay already added
+    this->OverlayChannels->SetValue(i - 1, channel < 0 ? -1 : channel);
+    }
+  else
+    {
+    this->OverlayRenderers->AddItem(renderer);
+    this->OverlayChannels->InsertNextValue(channel < 0 ? -1 : channel);
+    }
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::RemoveOverlayRenderer(vtkRenderer* renderer)
+{
+  int i = this->OverlayRenderers->IsItemPresent(renderer);
+  if (!i)
+    {
+    return;
+    }
+
+  this->OverlayRenderers->RemoveItem(i - 1);
+  for (int j = i; j < this->OverlayChannels->GetNumberOfTuples(); j++)
+    {
+    this->OverlayChannels->SetValue(j - 1, this->OverlayChannels->GetValue(j));
+    }
+  this->OverlayChannels->SetNumberOfTuples(this->OverlayChannels->GetNumberOfTuples() - 1);
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::RemoveAllOverlayRenderers()
+{
+  this->OverlayRenderers->RemoveAllItems();
+  this->OverlayChannels->Initialize();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderWindowHelper::IsOverlayRenderer(vtkRenderer* renderer)
+{
+  return this->OverlayRenderers->IsItemPresent(renderer) ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderWindowHelper::GetOverlayChannel(vtkRenderer* renderer)
+{
+  int i = this->OverlayRenderers->IsItemPresent(renderer);
+
+  return i ? this->OverlayChannels->GetValue(i - 1) : -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::AddInteractionRenderer(vtkRenderer* interaction, vtkRenderer* rendered)
+{
+  if (!interaction || !rendered || this->IsInteractionRenderer(interaction))
+    {
+    return;
+    }
+
+  this->InteractionRenderers->AddItem(interaction);
+  this->InteractionTargets->AddItem(rendered);
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::RemoveAllInteractionRenderers()
+{
+  this->InteractionRenderers->RemoveAllItems();
+  this->InteractionTargets->RemoveAllItems();
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderWindowHelper::IsInteractionRenderer(vtkRenderer* renderer)
+{
+  return this->InteractionRenderers->IsItemPresent(renderer) ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelRenderWindowHelper::GetNumberOfInteractionRenderers()
+{
+  return this->InteractionRenderers->GetNumberOfItems();
+}
+
+//----------------------------------------------------------------------------
+vtkRenderer* vtkMultiChannelRenderWindowHelper::GetInteractionRenderer(int i)
+{
+  return vtkRenderer::SafeDownCast(this->InteractionRenderers->GetItemAsObject(i));
+}
+
+//----------------------------------------------------------------------------
+vtkRenderer* vtkMultiChannelRenderWindowHelper::GetInteractionTarget(int i)
+{
+  return vtkRenderer::SafeDownCast(this->InteractionTargets->GetItemAsObject(i));
+}
+
+//----------------------------------------------------------------------------
+bool vtkMultiChannelRenderWindowHelper::DeferRender()
+{
+  if (this->DirectRendering)
+    {
+    return false;
+    }
+
+  int threadRunning = this->RenderThread && this->RenderThread->GetRunning();
+
+  // The render thread renders whatever it is asked to
+  if (threadRunning && this->RenderThread->IsRenderThread())
+    {
+    return false;
+    }
+
+  // Merge requests until the scheduler's next tick, unless this is it
+  if (this->RenderScheduler && this->RenderScheduler->GetRunning() &&
+      !this->RenderScheduler->GetExecuting())
+    {
+    this->RenderScheduler->RequestRender();
+    return true;
+    }
+
+  if (threadRunning)
+    {
+    this->RenderThread->RequestRender();
+    return true;
+    }
+
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::BeginDirectRendering()
+{
+  if (this->DirectRendering)
+    {
+    return;
+    }
+
+  // Takes the context back to this thread
+  this->DirectRenderThreadStopped = 0;
+  if (this->RenderThread && this->RenderThread->GetRunning())
+    {
+    this->RenderThread->Stop();
+    this->DirectRenderThreadStopped = 1;
+    }
+
+  if (this->FramePacer)
+    {
+    this->DirectPacerEnabled = this->FramePacer->GetEnabled();
+    this->FramePacer->EnabledOff();
+    }
+
+  this->DirectRendering = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowHelper::EndDirectRendering()
+{
+  if (!this->DirectRendering)
+    {
+    return;
+    }
+
+  this->DirectRendering = 0;
+
+  if (this->FramePacer)
+    {
+    this->FramePacer->SetEnabled(this->DirectPacerEnabled);
+    }
+
+  if (this->DirectRenderThreadStopped && this->RenderThread)
+    {
+    this->RenderThread->Start();
+    }
+  this->DirectRenderThreadStopped = 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkMultiChannelRenderWindowHelper::Render(vtkRendererCollection *renderers)
 {
-  // Render multiple channels.  
-  for (int i = 0; i < this->Channels->GetNumberOfItems(); i++) 
+  vtkCollectionSimpleIterator iterator;
+  vtkRenderer *renderer;
+
+  // Overlays are rendered once after the channels, the rest in each.
+  // Interaction renderers are not rendered.
+  vtkRendererCollection* channelRenderers = this->ChannelRenderers;
+  channelRenderers->RemoveAllItems();
+  for (renderers->InitTraversal(iterator); (renderer = renderers->GetNextRenderer(iterator)); )
+    {
+    if (!this->IsOverlayRenderer(renderer) && !this->IsInteractionRenderer(renderer))
+      {
+      channelRenderers->AddItem(renderer);
+      }
+    }
+
+  // Wait so the frame finishes just before its swap
+  if (this->FramePacer)
+    {
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Pace");
+      }
+    this->FramePacer->BeginFrame();
+    if (this->Tracer)
+      {
+      this->Tracer->End("Pace");
+      }
+    }
+
+  if (this->Tracer)
+    {
+    this->Tracer->Begin("Frame");
+    }
+
+  // Swap in the current time step before any pipeline updates
+  if (this->Prefetcher)
+    {
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Prefetch");
+      }
+    this->Prefetcher->Update();
+    if (this->Tracer)
+      {
+      this->Tracer->End("Prefetch");
+      }
+    }
+
+  channelRenderers->InitTraversal(iterator);
+  renderer = channelRenderers->GetNextRenderer(iterator);
+
+  if (this->CameraPath && this->CameraPath->GetRecording() && renderer)
+    {
+    this->CameraPath->RecordFrame(renderer->GetActiveCamera());
+    }
+
+  // Request the pieces the channels can see
+  if (this->Streamer && renderer)
     {
-    vtkRenderWindowChannel* channel = vtkRenderWindowChannel::SafeDownCast(this->Channels->GetItemAsObject(i));
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Stream");
+      }
+    this->Streamer->Update(renderer, this->Channels);
+    if (this->Tracer)
+      {
+      this->Tracer->End("Stream");
+      }
+    }
+
+  // Targets are created in the window's context
+  if (renderer)
+    {
+    this->RenderTargetPool->SetContext(renderer->GetRenderWindow());
+    }
+
+  // A still scene may not need its channels rendered again
+  int renderChannels = 1;
+  if (this->Accumulator)
+    {
+    renderChannels = this->Accumulator->BeginFrame(channelRenderers, this->Channels);
+    }
+
+  if (renderChannels)
+    {
+    // Do the view-independent work once for the frame
+    for (channelRenderers->InitTraversal(iterator); (renderer = channelRenderers->GetNextRenderer(iterator)); )
+      {
+      vtkOpenGLMultiChannelRenderer* multiChannelRenderer = vtkOpenGLMultiChannelRenderer::SafeDownCast(renderer);
+      if (multiChannelRenderer)
+        {
+        multiChannelRenderer->SetTracer(this->Tracer);
+        multiChannelRenderer->BeginFrame();
+        }
+      }
+
+    // Skip state set again to the same values by the channels
+    this->GLStateCache->BeginFrame();
+
+    // Render multiple channels.  
+    char channelName[32];
+    for (int i = 0; i < this->Channels->GetNumberOfItems(); i++) 
+      {
+      vtkRenderWindowChannel* channel = vtkRenderWindowChannel::SafeDownCast(this->Channels->GetItemAsObject(i));
+
+      if (this->Tracer)
+        {
+        sprintf(channelName, "Channel %d", i);
+        this->Tracer->Begin(channelName);
+        }
+      if (this->FramePacer)
+        {
+        this->FramePacer->BeginChannel(i);
+        }
     
-    vtkCollectionSimpleIterator iterator;
-    vtkRenderer *renderer;
+      // Props, mappers and passes may set state without the cache
+      for (channelRenderers->InitTraversal(iterator); (renderer = channelRenderers->GetNextRenderer(iterator)); )
+        {
+        channel->Render(renderer);
+        this->GLStateCache->Synchronize();
+        }
+
+      if (this->FramePacer)
+        {
+        this->FramePacer->EndChannel(i);
+        }
+
+      if (this->Tracer)
+        {
+        this->Tracer->End(channelName);
+        }
+      }
+
+    this->GLStateCache->EndFrame();
+    }
+
+  // Antialias a still scene
+  if (this->Accumulator)
+    {
+    channelRenderers->InitTraversal(iterator);
+    renderer = channelRenderers->GetNextRenderer(iterator);
+    if (renderer)
+      {
+      if (this->Tracer)
+        {
+        this->Tracer->Begin("Accumulate");
+        }
+      this->Accumulator->EndFrame(renderer->GetRenderWindow(), this->Channels);
+      if (this->Tracer)
+        {
+        this->Tracer->End("Accumulate");
+        }
+      }
+    }
+
+  // Keep the channels' images in case the next frame is late
+  if (this->Reprojector && this->Reprojector->GetRunning())
+    {
+    channelRenderers->InitTraversal(iterator);
+    renderer = channelRenderers->GetNextRenderer(iterator);
+    if (renderer)
+      {
+      if (this->Tracer)
+        {
+        this->Tracer->Begin("Capture");
+        }
+      this->Reprojector->CaptureFrame(renderer, this->Channels);
+      if (this->Tracer)
+        {
+        this->Tracer->End("Capture");
+        }
+      }
+    }
+
+  // Overlays over the finished channels, in layer order
+  if (this->OverlayRenderers->GetNumberOfItems() > 0)
+    {
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Overlay");
+      }
     for (renderers->InitTraversal(iterator); (renderer = renderers->GetNextRenderer(iterator)); )
       {
-      channel->Render(renderer);
+      if (!this->IsOverlayRenderer(renderer))
+        {
+        continue;
+        }
+
+      int channelIndex = this->GetOverlayChannel(renderer);
+      if (channelIndex < 0)
+        {
+        renderer->Render();
+        }
+      else if (channelIndex < this->Channels->GetNumberOfItems())
+        {
+        vtkRenderWindowChannel::SafeDownCast(this->Channels->GetItemAsObject(channelIndex))->Render(renderer);
+        }
+      }
+    if (this->Tracer)
+      {
+      this->Tracer->End("Overlay");
+      }
+    }
+
+  // Record the frame before it is swapped
+  if (this->FrameRecorder && this->FrameRecorder->GetRecording())
+    {
+    channelRenderers->InitTraversal(iterator);
+    renderer = channelRenderers->GetNextRenderer(iterator);
+    if (renderer)
+      {
+      if (this->Tracer)
+        {
+        this->Tracer->Begin("Read Back");
+        }
+      this->FrameRecorder->RecordFrame(renderer->GetRenderWindow(), this->Channels);
+      if (this->Tracer)
+        {
+        this->Tracer->End("Read Back");
+        }
       }
     }
+
+  // Send the changed parts of the frame to preview clients
+  if (this->FrameStreamer && this->FrameStreamer->GetRunning())
+    {
+    channelRenderers->InitTraversal(iterator);
+    renderer = channelRenderers->GetNextRenderer(iterator);
+    if (renderer)
+      {
+      if (this->Tracer)
+        {
+        this->Tracer->Begin("Encode");
+        }
+      this->FrameStreamer->SendFrame(renderer->GetRenderWindow(), this->Channels);
+      if (this->Tracer)
+        {
+        this->Tracer->End("Encode");
+        }
+      }
+    }
+
+  if (renderChannels)
+    {
+    for (channelRenderers->InitTraversal(iterator); (renderer = channelRenderers->GetNextRenderer(iterator)); )
+      {
+      vtkOpenGLMultiChannelRenderer* multiChannelRenderer = vtkOpenGLMultiChannelRenderer::SafeDownCast(renderer);
+      if (multiChannelRenderer)
+        {
+        multiChannelRenderer->EndFrame();
+        }
+      }
+    }
+
+  this->RenderTargetPool->EndFrame();
+
+  // Evict to the budgets before the next frame allocates
+  if (this->MemoryMonitor)
+    {
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Memory");
+      }
+    this->MemoryMonitor->Update(this, channelRenderers);
+    if (this->Tracer)
+      {
+      this->Tracer->End("Memory");
+      }
+    }
+
+  channelRenderers->RemoveAllItems();
+
+  if (this->Tracer)
+    {
+    this->Tracer->End("Frame");
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -69,4 +727,26 @@ void vtkMultiChannelRenderWindowHelper::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Channels:\n"; 
   this->Channels->PrintSelf(os,indent.GetNextIndent());
+
+  os << indent << "Overlay Renderers:\n";
+  this->OverlayRenderers->PrintSelf(os,indent.GetNextIndent());
+  os << indent << "Number Of Interaction Renderers: " << this->GetNumberOfInteractionRenderers() << "\n";
+
+  os << indent << "Render Thread: " << this->RenderThread << "\n";
+  os << indent << "Render Scheduler: " << this->RenderScheduler << "\n";
+  os << indent << "Direct Rendering: " << this->DirectRendering << "\n";
+  os << indent << "Frame Pacer: " << this->FramePacer << "\n";
+  os << indent << "Accumulator: " << this->Accumulator << "\n";
+  os << indent << "Reprojector: " << this->Reprojector << "\n";
+  os << indent << "Frame Recorder: " << this->FrameRecorder << "\n";
+  os << indent << "Frame Streamer: " << this->FrameStreamer << "\n";
+  os << indent << "Camera Path: " << this->CameraPath << "\n";
+  os << indent << "Prefetcher: " << this->Prefetcher << "\n";
+  os << indent << "Streamer: " << this->Streamer << "\n";
+  os << indent << "Memory Monitor: " << this->MemoryMonitor << "\n";
+  os << indent << "Tracer: " << this->Tracer << "\n";
+  os << indent << "Render Target Pool:\n";
+  this->RenderTargetPool->PrintSelf(os,indent.GetNextIndent());
+  os << indent << "GL State Cache:\n";
+  this->GLStateCache->PrintSelf(os,indent.GetNextIndent());
 }
\ No newline at end of file
@@ -35,8 +35,26 @@
 #include "vtkObject.h"
 
 class vtkCollection;
+class vtkIntArray;
+class vtkMultiChannelAccumulator;
+class vtkMultiChannelCameraPath;
+class vtkMultiChannelFramePacer;
+class vtkMultiChannelFrameRecorder;
+class vtkMultiChannelFrameStreamer;
+class vtkMultiChannelGLStateCache;
+class vtkMultiChannelMemoryMonitor;
+class vtkMultiChannelPrefetcher;
+class vtkMultiChannelRenderScheduler;
+class vtkMultiChannelRenderTargetPool;
+class vtkMultiChannelRenderThread;
+class vtkMultiChannelReprojector;
+class vtkMultiChannelStreamer;
+class vtkMultiChannelTracer;
+class vtkRenderer;
 class vtkRendererCollection;
+class vtkRenderWindow;
 class vtkRenderWindowChannel;
+class vtkSimpleCriticalSection;
 
 class VTK_MULTICHANNEL_EXPORT vtkMultiChannelRenderWindowHelper : public vtkObject 
 {
@@ -49,16 +67,208 @@ public:
   // Return the collection of channels
   vtkCollection *GetChannels();
 
+  // Description:
+  // Replace the channels with the given ones before the next frame, and
+  // turn the window's stereo rendering on or off with them unless stereo
+  // is negative.  Safe to call from any thread while the window renders.
+  // The window and its context are kept, so nothing is uploaded again.
+  void SwapChannels(vtkCollection*, int stereo = -1);
+
+  // Description:
+  // Called by the window before each frame to apply swapped channels
+  // and their stereo setting to it
+  void ApplyPendingChannels(vtkRenderWindow*);
+
   // Description:
   // Perform multi-channel rendering
   void Render(vtkRendererCollection*);
 
+  // Description:
+  // Render the given renderer once per frame, after the channels,
+  // instead of once in each channel.  With no channel given it is
+  // rendered over the whole window with its own viewport.  With a
+  // channel index it is rendered in that channel only, and must have a
+  // vtkOpenGLMultiChannelCamera.  Meant for annotations and other
+  // overlays, in a higher layer than the scene.
+  void AddOverlayRenderer(vtkRenderer*);
+  void AddOverlayRenderer(vtkRenderer*, int channel);
+  void RemoveOverlayRenderer(vtkRenderer*);
+  void RemoveAllOverlayRenderers();
+  int IsOverlayRenderer(vtkRenderer*);
+
+  // Description:
+  // Channel an overlay renderer is rendered in, or -1 for the window
+  int GetOverlayChannel(vtkRenderer*);
+
+  // Description:
+  // Add a renderer that stands in for a rendered one in interaction,
+  // and is never rendered itself.  While a render thread renders the
+  // window, the interactor changes the camera of the interaction
+  // renderer and the render thread renders with a copy.  Set up by
+  // vtkMultiChannelRenderWindowManager::StartRenderThread().
+  void AddInteractionRenderer(vtkRenderer* interaction, vtkRenderer* rendered);
+  void RemoveAllInteractionRenderers();
+  int IsInteractionRenderer(vtkRenderer*);
+
+  // Description:
+  // The interaction renderers, and the renderers they stand in for
+  int GetNumberOfInteractionRenderers();
+  vtkRenderer* GetInteractionRenderer(int);
+  vtkRenderer* GetInteractionTarget(int);
+
+  // Description:
+  // Optional thread that renders the window.  While it is running, 
+  // renders requested from other threads are handed to it.
+  void SetRenderThread(vtkMultiChannelRenderThread*);
+  vtkGetObjectMacro(RenderThread,vtkMultiChannelRenderThread);
+
+  // Description:
+  // Optional scheduler that merges the renders requested of the window
+  // into at most one per display refresh.  While it is running, renders
+  // requested are only marked as pending.
+  void SetRenderScheduler(vtkMultiChannelRenderScheduler*);
+  vtkGetObjectMacro(RenderScheduler,vtkMultiChannelRenderScheduler);
+
+  // Description:
+  // Called by the window at the start of Render().  Returns true if the
+  // render was handed off and the window should not render now.
+  bool DeferRender();
+
+  // Description:
+  // Render on the calling thread as soon as asked, between these calls.
+  // The render thread is stopped, renders are not left to the scheduler
+  // and the frame pacer does not wait.  Call them from the thread that
+  // started the render thread, as its context is taken back and handed
+  // over again.
+  void BeginDirectRendering();
+  void EndDirectRendering();
+  vtkGetMacro(DirectRendering,int);
+
+  // Description:
+  // Optional pacer that delays the start of each frame so that it
+  // finishes just before its swap
+  void SetFramePacer(vtkMultiChannelFramePacer*);
+  vtkGetObjectMacro(FramePacer,vtkMultiChannelFramePacer);
+
+  // Description:
+  // Optional accumulator that antialiases the channels progressively
+  // while the scene is still.  It is given the RenderTargetPool.
+  void SetAccumulator(vtkMultiChannelAccumulator*);
+  vtkGetObjectMacro(Accumulator,vtkMultiChannelAccumulator);
+
+  // Description:
+  // Optional reprojector that is given the channels' images once they
+  // are rendered, to show rotated if the next frame is late.  It is
+  // given the RenderTargetPool, and must be set before it is started.
+  void SetReprojector(vtkMultiChannelReprojector*);
+  vtkGetObjectMacro(Reprojector,vtkMultiChannelReprojector);
+
+  // Description:
+  // Optional recorder that is given each frame once all of its channels
+  // are rendered
+  void SetFrameRecorder(vtkMultiChannelFrameRecorder*);
+  vtkGetObjectMacro(FrameRecorder,vtkMultiChannelFrameRecorder);
+
+  // Description:
+  // Optional streamer that sends each frame to preview clients once all
+  // of its channels are rendered
+  void SetFrameStreamer(vtkMultiChannelFrameStreamer*);
+  vtkGetObjectMacro(FrameStreamer,vtkMultiChannelFrameStreamer);
+
+  // Description:
+  // Optional camera path that records the first renderer's camera at the
+  // start of each frame while recording
+  void SetCameraPath(vtkMultiChannelCameraPath*);
+  vtkGetObjectMacro(CameraPath,vtkMultiChannelCameraPath);
+
+  // Description:
+  // Optional prefetcher whose requested time step is swapped in at the
+  // start of each frame
+  void SetPrefetcher(vtkMultiChannelPrefetcher*);
+  vtkGetObjectMacro(Prefetcher,vtkMultiChannelPrefetcher);
+
+  // Description:
+  // Optional streamer whose pieces are requested for the channels'
+  // views at the start of each frame
+  void SetStreamer(vtkMultiChannelStreamer*);
+  vtkGetObjectMacro(Streamer,vtkMultiChannelStreamer);
+
+  // Description:
+  // Optional monitor that measures the memory held by the subsystems and
+  // channels at the end of each frame, and evicts to its budgets
+  void SetMemoryMonitor(vtkMultiChannelMemoryMonitor*);
+  vtkGetObjectMacro(MemoryMonitor,vtkMultiChannelMemoryMonitor);
+
+  // Description:
+  // Offscreen color and depth targets for per-channel rendering, shared
+  // by the channels and reused across frames.  The accumulator's
+  // averages and the reprojector's images are held in it.
+  vtkGetObjectMacro(RenderTargetPool,vtkMultiChannelRenderTargetPool);
+
+  // Description:
+  // Cache of the OpenGL state set by the channels, so that state the
+  // same for consecutive channels is not set again
+  vtkGetObjectMacro(GLStateCache,vtkMultiChannelGLStateCache);
+
+  // Description:
+  // Optional tracer recording a timeline of each frame.  It is passed
+  // on to the vtkOpenGLMultiChannelRenderers rendered.
+  void SetTracer(vtkMultiChannelTracer*);
+  vtkGetObjectMacro(Tracer,vtkMultiChannelTracer);
+
 protected:
   vtkMultiChannelRenderWindowHelper();
   ~vtkMultiChannelRenderWindowHelper();
 
   vtkCollection* Channels;
 
+  vtkCollection* PendingChannels;
+  int HasPendingChannels;
+  int PendingStereo;
+  vtkSimpleCriticalSection* PendingChannelsLock;
+
+  // Settings changed for direct rendering, restored after
+  int DirectRendering;
+  int DirectRenderThreadStopped;
+  int DirectPacerEnabled;
+
+  vtkRendererCollection* OverlayRenderers;
+  vtkIntArray* OverlayChannels;
+
+  vtkRendererCollection* InteractionRenderers;
+  vtkRendererCollection* InteractionTargets;
+
+  // Renderers rendered in every channel, refilled each frame
+  vtkRendererCollection* ChannelRenderers;
+
+  vtkMultiChannelRenderThread* RenderThread;
+
+  vtkMultiChannelRenderScheduler* RenderScheduler;
+
+  vtkMultiChannelFramePacer* FramePacer;
+
+  vtkMultiChannelAccumulator* Accumulator;
+
+  vtkMultiChannelReprojector* Reprojector;
+
+  vtkMultiChannelFrameRecorder* FrameRecorder;
+
+  vtkMultiChannelFrameStreamer* FrameStreamer;
+
+  vtkMultiChannelCameraPath* CameraPath;
+
+  vtkMultiChannelPrefetcher* Prefetcher;
+
+  vtkMultiChannelStreamer* Streamer;
+
+  vtkMultiChannelMemoryMonitor* MemoryMonitor;
+
+  vtkMultiChannelTracer* Tracer;
+
+  vtkMultiChannelRenderTargetPool* RenderTargetPool;
+
+  vtkMultiChannelGLStateCache* GLStateCache;
+
 private:    
   vtkMultiChannelRenderWindowHelper(const vtkMultiChannelRenderWindowHelper&);  // Not implemented.
   void operator=(const vtkMultiChannelRenderWindowHelper&);  // Not implemented.
@@ -16,12 +16,19 @@
 
 #include "vtkMultiChannelRenderWindowManager.h"
 
+#include "vtkCamera.h"
 #include "vtkCollection.h"
 #include "vtkGraphicsFactory.h"
+#include "vtkMultiChannelRenderThread.h"
 #include "vtkMultiChannelRenderWindowHelper.h"
+#include "vtkMultiChannelSceneState.h"
 #include "vtkObjectFactory.h"
+#include "vtkProp3D.h"
+#include "vtkPropCollection.h"
+#include "vtkRenderWindow.h"
 #include "vtkRenderWindowChannel.h"
 #include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
 
 // Include platform-specific headers via code borrowed from vtkGraphicsFactory.h
 
@@ -29,6 +36,7 @@
 #ifdef _WIN32
 # ifndef VTK_USE_OGLR
 #  include "vtkOpenGLMultiChannelCamera.h"
+#  include "vtkOpenGLMultiChannelRenderer.h"
 #  include "vtkWin32OpenGLMultiChannelRenderWindow.h"
 #  define VTK_DISPLAY_WIN32_OGL
 # endif // VTK_USE_OGLR
@@ -70,12 +78,17 @@ vtkMultiChannelRenderWindowManager::vtkMultiChannelRenderWindowManager()
   this->Helper = vtkMultiChannelRenderWindowHelper::New();
 
   this->NeedsStereo = false;
+
+  this->SharedContext = 0;
+  this->SharedContextWindow = NULL;
 }
 
 //----------------------------------------------------------------------------
 vtkMultiChannelRenderWindowManager::~vtkMultiChannelRenderWindowManager() 
 {
   this->Helper->Delete();
+
+  this->ClearSharedContext();
 }
 
 //----------------------------------------------------------------------------
@@ -134,6 +147,20 @@ vtkRenderWindow* vtkMultiChannelRenderWindowManager::GetRenderWindow()
       window->StereoRenderOn();
       }
 
+    if (this->SharedContext)
+      {
+      if (this->SharedContextWindow)
+        {
+        window->SetSharedContextWindow(
+          vtkWin32OpenGLMultiChannelRenderWindow::SafeDownCast(this->SharedContextWindow));
+        }
+      else
+        {
+        this->SharedContextWindow = window;
+        this->SharedContextWindow->Register(this);
+        }
+      }
+
     // Create a new helper for the next window to be created
     this->Helper->Delete();
     this->Helper = vtkMultiChannelRenderWindowHelper::New();  
@@ -156,10 +183,224 @@ vtkRenderWindow* vtkMultiChannelRenderWindowManager::GetRenderWindow()
 }
 
 //----------------------------------------------------------------------------
-vtkRenderer *vtkMultiChannelRenderWindowManager::GetRenderer()
+bool vtkMultiChannelRenderWindowManager::SwapChannels(vtkRenderWindow* window)
+{
+  vtkMultiChannelRenderWindowHelper* helper = this->GetRenderWindowHelper(window);
+  if (!helper)
+    {
+    vtkErrorMacro(<<"Not a multi-channel render window.");
+    return false;
+    }
+
+  // Stereo channels need the camera to render per eye.  The stereo
+  // setting is applied with the channels, so no frame mixes the two.
+  helper->SwapChannels(this->Helper->GetChannels(), this->NeedsStereo ? 1 : 0);
+
+  this->ClearChannels();
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowManager::ClearSharedContext()
+{
+  if (this->SharedContextWindow)
+    {
+    this->SharedContextWindow->UnRegister(this);
+    this->SharedContextWindow = NULL;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelRenderWindowHelper* vtkMultiChannelRenderWindowManager::GetRenderWindowHelper(vtkRenderWindow* window)
+{
+#ifdef VTK_DISPLAY_WIN32_OGL
+  vtkWin32OpenGLMultiChannelRenderWindow* win32Window = 
+    vtkWin32OpenGLMultiChannelRenderWindow::SafeDownCast(window);
+  if (win32Window)
+    {
+    return win32Window->GetHelper();
+    }
+#endif
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMultiChannelRenderWindowManager::StartRenderThread(vtkRenderWindow* window)
+{
+  vtkMultiChannelRenderWindowHelper* helper = this->GetRenderWindowHelper(window);
+  if (!helper)
+    {
+    vtkErrorMacro(<<"Not a multi-channel render window.");
+    return false;
+    }
+
+  if (helper->GetRenderThread() && helper->GetRenderThread()->GetRunning())
+    {
+    return true;
+    }
+
+#ifdef VTK_DISPLAY_WIN32_OGL
+  // The renderers rendered in the channels
+  vtkRendererCollection* rendered = vtkRendererCollection::New();
+  vtkCollectionSimpleIterator iterator;
+  vtkRenderer* renderer;
+  vtkRendererCollection* renderers = window->GetRenderers();
+  for (renderers->InitTraversal(iterator); (renderer = renderers->GetNextRenderer(iterator)); )
+    {
+    if (!helper->IsOverlayRenderer(renderer) && !helper->IsInteractionRenderer(renderer))
+      {
+      rendered->AddItem(renderer);
+      }
+    }
+
+  if (rendered->GetNumberOfItems() == 0)
+    {
+    vtkErrorMacro(<<"The window has no renderers.");
+    rendered->Delete();
+    return false;
+    }
+
+  // The application's camera is only read, when a render is requested
+  vtkCamera* camera = rendered->GetFirstRenderer()->GetActiveCamera();
+
+  vtkMultiChannelSceneState* sceneState = vtkMultiChannelSceneState::New();
+  sceneState->SetSourceCamera(camera);
+
+  // The renderers render with a copy, and hand interaction to stand-ins
+  // with the application's camera
+  vtkOpenGLMultiChannelCamera* renderCamera = vtkOpenGLMultiChannelCamera::New();
+  renderCamera->SetClippingRange(camera->GetClippingRange());
+  renderCamera->SetUseHorizontalViewAngle(camera->GetUseHorizontalViewAngle());
+
+  for (rendered->InitTraversal(iterator); (renderer = rendered->GetNextRenderer(iterator)); )
+    {
+    vtkRenderer* interaction = vtkRenderer::New();
+    interaction->SetViewport(renderer->GetViewport());
+    interaction->SetLayer(renderer->GetLayer());
+    interaction->SetInteractive(renderer->GetInteractive());
+    interaction->SetActiveCamera(camera);
+
+    renderer->InteractiveOff();
+    renderer->SetActiveCamera(renderCamera);
+
+    // The renderers render copies of their props, and the application's
+    // props move to the stand-ins, where they can still be picked
+    vtkPropCollection* props = vtkPropCollection::New();
+    vtkCollectionSimpleIterator pit;
+    vtkProp* prop;
+    vtkPropCollection* viewProps = renderer->GetViewProps();
+    for (viewProps->InitTraversal(pit); (prop = viewProps->GetNextProp(pit)); )
+      {
+      props->AddItem(prop);
+      }
+
+    renderer->RemoveAllViewProps();
+    for (props->InitTraversal(pit); (prop = props->GetNextProp(pit)); )
+      {
+      vtkProp3D* source = vtkProp3D::SafeDownCast(prop);
+      if (source)
+        {
+        vtkProp3D* target = source->NewInstance();
+        target->ShallowCopy(source);
+        renderer->AddViewProp(target);
+        interaction->AddViewProp(source);
+        sceneState->AddProp(source, target);
+        target->Delete();
+        }
+      else
+        {
+        renderer->AddViewProp(prop);
+        }
+      }
+    props->Delete();
+
+    window->AddRenderer(interaction);
+    helper->AddInteractionRenderer(interaction, renderer);
+    interaction->Delete();
+    }
+
+  sceneState->Publish();
+  sceneState->Apply(rendered);
+
+  vtkMultiChannelRenderThread* thread = vtkMultiChannelRenderThread::New();
+  thread->SetRenderWindow(window);
+  thread->SetSceneState(sceneState);
+  helper->SetRenderThread(thread);
+  thread->Start();
+
+  thread->Delete();
+  sceneState->Delete();
+  renderCamera->Delete();
+  rendered->Delete();
+
+  return true;
+#else
+  vtkErrorMacro(<<"Multi-channel rendering not implemented for this platform yet.");
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelRenderWindowManager::StopRenderThread(vtkRenderWindow* window)
 {
-  vtkRenderer* renderer = vtkRenderer::New();
+  vtkMultiChannelRenderWindowHelper* helper = this->GetRenderWindowHelper(window);
+  if (!helper || !helper->GetRenderThread())
+    {
+    return;
+    }
+
+  vtkMultiChannelSceneState* sceneState = helper->GetRenderThread()->GetSceneState();
+  sceneState->Register(this);
+
+  helper->GetRenderThread()->Stop();
+  helper->SetRenderThread(NULL);
+
+  // Give the renderers the application's camera and props back
+  for (int i = 0; i < helper->GetNumberOfInteractionRenderers(); i++)
+    {
+    vtkRenderer* interaction = helper->GetInteractionRenderer(i);
+    vtkRenderer* renderer = helper->GetInteractionTarget(i);
+
+    renderer->SetInteractive(interaction->GetInteractive());
+    renderer->SetActiveCamera(interaction->GetActiveCamera());
+
+    vtkPropCollection* props = vtkPropCollection::New();
+    vtkCollectionSimpleIterator pit;
+    vtkProp* prop;
+    vtkPropCollection* viewProps = renderer->GetViewProps();
+    for (viewProps->InitTraversal(pit); (prop = viewProps->GetNextProp(pit)); )
+      {
+      props->AddItem(prop);
+      }
 
+    renderer->RemoveAllViewProps();
+    interaction->RemoveAllViewProps();
+    for (props->InitTraversal(pit); (prop = props->GetNextProp(pit)); )
+      {
+      for (int j = 0; j < sceneState->GetNumberOfProps(); j++)
+        {
+        if (sceneState->GetTargetProp(j) == prop)
+          {
+          prop = sceneState->GetSourceProp(j);
+          break;
+          }
+        }
+      renderer->AddViewProp(prop);
+      }
+    props->Delete();
+
+    window->RemoveRenderer(interaction);
+    }
+  helper->RemoveAllInteractionRenderers();
+
+  sceneState->UnRegister(this);
+}
+
+//----------------------------------------------------------------------------
+vtkRenderer *vtkMultiChannelRenderWindowManager::GetRenderer()
+{
 #if defined(VTK_USE_MANGLED_MESA)
   if (vtkGraphicsFactor::UseMesaClasses)
     {
@@ -168,6 +409,8 @@ vtkRenderer *vtkMultiChannelRenderWindowManager::GetRenderer()
   }
 #endif
 
+  vtkRenderer* renderer = vtkOpenGLMultiChannelRenderer::New();
+
   vtkOpenGLMultiChannelCamera *camera = vtkOpenGLMultiChannelCamera::New();
   renderer->SetActiveCamera(camera);
 
@@ -185,4 +428,6 @@ void vtkMultiChannelRenderWindowManager::PrintSelf(ostream& os, vtkIndent indent
   this->Helper->PrintSelf(os,indent.GetNextIndent());
 
   os << indent << "NeedsStereo: " << this->NeedsStereo << "\n";
+  os << indent << "SharedContext: " << this->SharedContext << "\n";
+  os << indent << "SharedContextWindow: " << this->SharedContextWindow << "\n";
 }
\ No newline at end of file
@@ -30,10 +30,33 @@
 // which is a standard configuration for passive stereo and head-mounted 
 // display devices.  Similarly, multiple views of a scene may be necessary 
 // to render to immersive environments such as domes.
+//
+// For installations that drive projectors from separate windows, 
+// SharedContext makes the windows returned by GetRenderWindow() a
+// family drawn by the first one.  Each window has its own set of
+// channels, but the renderers added to any of them are held by the
+// first window, which draws every window of the family with its own
+// context.  VTK's mappers and textures release and rebuild their
+// display lists and textures whenever they are drawn in another
+// window, so drawing the family from one window uploads the scene once,
+// however many projectors are added.  Rendering any window of the
+// family renders all of them.  Call ClearSharedContext() to start a new
+// family.
+//
+// StartRenderThread() renders a window on a vtkMultiChannelRenderThread.
+// The application and the interactor keep changing the camera they
+// have, which the render thread only ever reads as snapshots taken by a
+// vtkMultiChannelSceneState when a render is requested.  The renderers
+// are rendered with a copy of the camera and of each of their 3D props,
+// and interaction goes through renderers that stand in for them without
+// being rendered.  The stand-ins hold the application's props, so that
+// they can be picked and moved, and their transforms are handed to the
+// copies in the same snapshots as the camera.
 
 // .SECTION see also
 // vtkRenderWindow vtkMultiChannelRenderWindowHelper vtkRenderWindowChannel
-// vtkOpenGLMultiChannelCamera
+// vtkOpenGLMultiChannelCamera vtkMultiChannelRenderThread
+// vtkMultiChannelSceneState
 
 #ifndef __vtkMultiChannelRenderWindowManager_h
 #define __vtkMultiChannelRenderWindowManager_h
@@ -64,11 +87,52 @@ public:
   // perform multi-channel rendering.
   vtkRenderWindow* GetRenderWindow();
 
+  // Description:
+  // Replace the channels of a window returned by GetRenderWindow() with
+  // the channels added since, starting with the next frame.  The window
+  // and its context are kept.  Stereo channels can only be swapped into
+  // a window that was created stereo capable.  Returns false for other
+  // windows.
+  bool SwapChannels(vtkRenderWindow*);
+
+  // Description:
+  // Returns the vtkMultiChannelRenderWindowHelper of a window returned
+  // by GetRenderWindow(), or NULL for other windows.
+  vtkMultiChannelRenderWindowHelper* GetRenderWindowHelper(vtkRenderWindow*);
+
+  // Description:
+  // Make windows returned by GetRenderWindow() a family drawn by the
+  // first window returned, with its context and renderers.  The windows
+  // of a family must all be stereo capable or all not, and are
+  // interacted with through the first window.
+  vtkGetMacro(SharedContext,int);
+  vtkSetMacro(SharedContext,int);
+  vtkBooleanMacro(SharedContext,int);
+
+  // Description:
+  // The window that draws the family, if any
+  vtkGetObjectMacro(SharedContextWindow,vtkRenderWindow);
+
+  // Description:
+  // Start a new family of shared context windows
+  void ClearSharedContext();
+
+  // Description:
+  // Render a window returned by GetRenderWindow() on its own thread,
+  // and stop.  The window must have been rendered once, with its
+  // renderers sharing the camera the application changes.  Props added
+  // to the renderers while the thread runs are not rendered.  Stopping
+  // gives the renderers that camera and their props back.  Returns false
+  // for other windows.
+  bool StartRenderThread(vtkRenderWindow*);
+  void StopRenderThread(vtkRenderWindow*);
+
   // Description:
   // Returns a vtkRenderer suitable for multi-channel rendering.
-  // This creates a standard vtkRenderer, but replaces the vtkCamera
-  // with one that supports an aspect ratio different from that 
-  // of the viewport.
+  // This creates a vtkOpenGLMultiChannelRenderer, which does its
+  // view-independent work once per frame rather than once per channel,
+  // and replaces the vtkCamera with one that supports an aspect ratio 
+  // different from that of the viewport.
   vtkRenderer* GetRenderer();
 
 protected:
@@ -79,6 +143,9 @@ protected:
 
   bool NeedsStereo;
 
+  int SharedContext;
+  vtkRenderWindow* SharedContextWindow;
+
 private:
   vtkMultiChannelRenderWindowManager(const vtkMultiChannelRenderWindowManager&);  // Not implemented.
   void operator=(const vtkMultiChannelRenderWindowManager&);  // Not implemented.
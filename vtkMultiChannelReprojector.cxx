@@ -0,0 +1,682 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelReprojector.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelReprojector.h"
+
+#include "vtkCamera.h"
+#include "vtkCollection.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkMultiChannelRenderTargetPool.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGL.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowChannel.h"
+#include "vtkRenderer.h"
+#include "vtkTextureObject.h"
+#include "vtkTimerLog.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <math.h>
+#include <vector>
+
+#ifdef _WIN32
+# include "vtkWindows.h"
+#endif
+
+vtkCxxRevisionMacro(vtkMultiChannelReprojector, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelReprojector);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelReprojectorInternals
+{
+public:
+  // A channel's image and the camera it was rendered with
+  struct Image
+  {
+    Image() : Target(0) { this->Size[0] = this->Size[1] = 0; }
+
+    // The target holds the image in its lower left corner, and is black
+    // elsewhere
+    vtkTextureObject* Target;
+    int Size[2];
+    int Region[4];
+
+    // Rotation of the camera and of the channel's view
+    double BaseRotation[3][3];
+    double ChannelRotation[3][3];
+
+    // Maps view directions to clip coordinates
+    double Projection[3][3];
+  };
+
+  // Images are captured into a set other than the one in front, which
+  // is the one reprojected, and the one being drawn, if any
+  std::vector<Image> Images[3];
+  int Front;
+  int HasFront;
+  int Back;
+  int Captured;
+  int Drawing;
+
+  int Ready;
+  double LastSwapTime;
+
+  double View[3][3];
+  int HasView;
+
+#ifdef _WIN32
+  HDC DeviceContext;
+  HGLRC Context;
+#endif
+
+  static void GetRotation(vtkMatrix4x4* matrix, double rotation[3][3])
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      for (int j = 0; j < 3; j++)
+        {
+        rotation[i][j] = matrix->GetElement(i, j);
+        }
+      }
+    }
+
+  // The x, y and w rows of the projection applied to directions
+  static void GetProjection(vtkMatrix4x4* matrix, double projection[3][3])
+    {
+    static const int rows[3] = { 0, 1, 3 };
+    for (int i = 0; i < 3; i++)
+      {
+      for (int j = 0; j < 3; j++)
+        {
+        projection[i][j] = matrix->GetElement(rows[i], j);
+        }
+      }
+    }
+
+  static void ReleaseTargets(std::vector<Image>& images, unsigned int first,
+                             vtkMultiChannelRenderTargetPool* pool)
+    {
+    for (unsigned int i = first; i < images.size(); i++)
+      {
+      if (images[i].Target)
+        {
+        pool->Release(images[i].Target);
+        }
+      }
+    images.resize(first);
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelReprojector::vtkMultiChannelReprojector()
+{
+  this->TargetFrameRate = 60.0;
+  this->LeadTime = 0.002;
+
+  this->Running = 0;
+  this->StopRequested = 0;
+
+  this->RenderWindow = NULL;
+  this->RenderTargetPool = NULL;
+
+  this->Threader = vtkMultiThreader::New();
+  this->ThreadId = -1;
+  this->Lock = vtkMutexLock::New();
+
+  this->NumberOfReprojectedFrames = 0;
+
+  this->Internals = new vtkMultiChannelReprojectorInternals;
+  this->Internals->Front = 0;
+  this->Internals->HasFront = 0;
+  this->Internals->Back = 1;
+  this->Internals->Captured = 0;
+  this->Internals->Drawing = -1;
+  this->Internals->Ready = 0;
+  this->Internals->LastSwapTime = 0;
+  this->Internals->HasView = 0;
+#ifdef _WIN32
+  this->Internals->DeviceContext = NULL;
+  this->Internals->Context = NULL;
+#endif
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelReprojector::~vtkMultiChannelReprojector()
+{
+  this->Stop();
+  this->SetRenderTargetPool(NULL);
+
+  this->Threader->Delete();
+  this->Lock->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::SetRenderTargetPool(vtkMultiChannelRenderTargetPool* pool)
+{
+  if (this->RenderTargetPool == pool)
+    {
+    return;
+    }
+
+  // The reprojection thread may be drawing the images held
+  if (this->Running)
+    {
+    vtkErrorMacro(<< "Cannot change the render target pool while running.");
+    return;
+    }
+
+  if (this->RenderTargetPool)
+    {
+    this->RenderTargetPool->UnRegister(this);
+    }
+
+  this->RenderTargetPool = pool;
+  if (this->RenderTargetPool)
+    {
+    this->RenderTargetPool->Register(this);
+    }
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelReprojector::Start(vtkRenderWindow* window)
+{
+  if (this->Running)
+    {
+    return 1;
+    }
+
+  if (!window)
+    {
+    vtkErrorMacro(<< "No render window given.");
+    return 0;
+    }
+
+  if (!this->RenderTargetPool)
+    {
+    vtkErrorMacro(<< "No render target pool set.");
+    return 0;
+    }
+
+#ifdef _WIN32
+  vtkMultiChannelReprojectorInternals* internals = this->Internals;
+
+  // A context of our own on the window, sharing the window's textures
+  window->MakeCurrent();
+  HDC deviceContext = wglGetCurrentDC();
+  HGLRC sharedContext = wglGetCurrentContext();
+  if (!deviceContext || !sharedContext)
+    {
+    vtkErrorMacro(<< "The render window has no context.");
+    return 0;
+    }
+
+  HGLRC context = wglCreateContext(deviceContext);
+  if (!context)
+    {
+    vtkErrorMacro(<< "Could not create a context.");
+    return 0;
+    }
+
+  if (!wglShareLists(sharedContext, context))
+    {
+    vtkErrorMacro(<< "wglShareLists failed.");
+    wglDeleteContext(context);
+    return 0;
+    }
+
+  internals->DeviceContext = deviceContext;
+  internals->Context = context;
+  internals->Front = 0;
+  internals->HasFront = 0;
+  internals->Back = 1;
+  internals->Captured = 0;
+  internals->Drawing = -1;
+  internals->Ready = 0;
+  internals->LastSwapTime = 0;
+
+  this->RenderWindow = window;
+  this->StopRequested = 0;
+  this->Running = 1;
+
+  this->ThreadId = this->Threader->SpawnThread(
+    &vtkMultiChannelReprojector::ThreadMain, this);
+
+  return 1;
+#else
+  vtkErrorMacro(<< "Reprojection is only supported on Windows.");
+  return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::Stop()
+{
+  if (!this->Running)
+    {
+    return;
+    }
+
+  this->Lock->Lock();
+  this->StopRequested = 1;
+  this->Lock->Unlock();
+
+  // Waits for the reprojection loop to finish
+  this->Threader->TerminateThread(this->ThreadId);
+  this->ThreadId = -1;
+  this->Running = 0;
+
+  vtkMultiChannelReprojectorInternals* internals = this->Internals;
+
+#ifdef _WIN32
+  wglDeleteContext(internals->Context);
+  internals->Context = NULL;
+  internals->DeviceContext = NULL;
+#endif
+
+  for (int i = 0; i < 3; i++)
+    {
+    vtkMultiChannelReprojectorInternals::ReleaseTargets(internals->Images[i], 0, this->RenderTargetPool);
+    }
+  internals->HasFront = 0;
+
+  this->RenderWindow = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::UpdateView(vtkMatrix4x4* view)
+{
+  if (!view)
+    {
+    return;
+    }
+
+  this->Lock->Lock();
+  vtkMultiChannelReprojectorInternals::GetRotation(view, this->Internals->View);
+  this->Internals->HasView = 1;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::CaptureFrame(vtkRenderer* renderer, vtkCollection* channels)
+{
+  if (!this->Running || !renderer || !channels)
+    {
+    return;
+    }
+
+  vtkMultiChannelReprojectorInternals* internals = this->Internals;
+
+  // Neither the set in front nor the one being drawn is written.  Once
+  // chosen, only this thread uses the set until it is swapped in front.
+  this->Lock->Lock();
+  int back = 0;
+  while ((internals->HasFront && back == internals->Front) || back == internals->Drawing)
+    {
+    back++;
+    }
+  internals->Back = back;
+  internals->Captured = 0;
+
+  std::vector<vtkMultiChannelReprojectorInternals::Image>& images = internals->Images[back];
+
+  int numberOfChannels = channels->GetNumberOfItems();
+  if (static_cast<int>(images.size()) > numberOfChannels)
+    {
+    vtkMultiChannelReprojectorInternals::ReleaseTargets(images, numberOfChannels, this->RenderTargetPool);
+    }
+  images.resize(numberOfChannels);
+  this->Lock->Unlock();
+
+  int* size = renderer->GetRenderWindow()->GetSize();
+
+  double baseRotation[3][3];
+  vtkMultiChannelReprojectorInternals::GetRotation(
+    renderer->GetActiveCamera()->GetViewTransformMatrix(), baseRotation);
+
+  vtkMatrix4x4* view = vtkMatrix4x4::New();
+  vtkMatrix4x4* projection = vtkMatrix4x4::New();
+
+  glReadBuffer(GL_BACK);
+
+  for (int i = 0; i < numberOfChannels; i++)
+    {
+    vtkRenderWindowChannel* channel = vtkRenderWindowChannel::SafeDownCast(channels->GetItemAsObject(i));
+    vtkMultiChannelReprojectorInternals::Image& image = images[i];
+
+    channel->GetPixelRegion(size, image.Region);
+    channel->GetViewMatrices(renderer, view, projection);
+
+    for (int j = 0; j < 3; j++)
+      {
+      for (int k = 0; k < 3; k++)
+        {
+        image.BaseRotation[j][k] = baseRotation[j][k];
+        }
+      }
+    vtkMultiChannelReprojectorInternals::GetRotation(view, image.ChannelRotation);
+    vtkMultiChannelReprojectorInternals::GetProjection(projection, image.Projection);
+
+    if (!image.Target || image.Size[0] != image.Region[2] || image.Size[1] != image.Region[3])
+      {
+      if (image.Target)
+        {
+        this->RenderTargetPool->Release(image.Target);
+        }
+
+      // Pooled targets are rounded up in size.  One at least a texel
+      // larger than the image, and cleared, is black all around it.
+      image.Target = this->RenderTargetPool->AcquireColorTarget(image.Region[2] + 1, image.Region[3] + 1);
+      image.Size[0] = image.Region[2];
+      image.Size[1] = image.Region[3];
+      if (!image.Target)
+        {
+        continue;
+        }
+
+      int width = image.Target->GetWidth();
+      int height = image.Target->GetHeight();
+      std::vector<unsigned char> black(static_cast<unsigned int>(width) * height * 4, 0);
+
+      glBindTexture(GL_TEXTURE_2D, image.Target->GetHandle());
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &black[0]);
+      }
+    else
+      {
+      glBindTexture(GL_TEXTURE_2D, image.Target->GetHandle());
+      }
+
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.Region[0], image.Region[1],
+                        image.Region[2], image.Region[3]);
+    }
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  view->Delete();
+  projection->Delete();
+
+  // The reprojection context may use the images as soon as they are
+  // swapped in, so the copies must be done by then
+  glFinish();
+
+  this->Lock->Lock();
+  internals->Captured = 1;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::FrameReady()
+{
+  this->Lock->Lock();
+  this->Internals->Ready = 1;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::FrameSwapped()
+{
+  vtkMultiChannelReprojectorInternals* internals = this->Internals;
+
+  this->Lock->Lock();
+  if (internals->Captured)
+    {
+    internals->Front = internals->Back;
+    internals->HasFront = 1;
+    internals->Captured = 0;
+    }
+  internals->Ready = 0;
+  internals->LastSwapTime = vtkTimerLog::GetUniversalTime();
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelReprojector::GetNumberOfReprojectedFrames()
+{
+  this->Lock->Lock();
+  int numberOfReprojectedFrames = this->NumberOfReprojectedFrames;
+  this->Lock->Unlock();
+
+  return numberOfReprojectedFrames;
+}
+
+//----------------------------------------------------------------------------
+double vtkMultiChannelReprojector::GetChannelMemory(int i)
+{
+  double memory = 0;
+
+  // Four 8-bit components, over the whole of the pooled target
+  this->Lock->Lock();
+  for (int j = 0; j < 3; j++)
+    {
+    std::vector<vtkMultiChannelReprojectorInternals::Image>& images = this->Internals->Images[j];
+    if (i >= 0 && i < static_cast<int>(images.size()) && images[i].Target)
+      {
+      memory += 4.0 * images[i].Target->GetWidth() * images[i].Target->GetHeight();
+      }
+    }
+  this->Lock->Unlock();
+
+  return memory;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelReprojector::ThreadMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  static_cast<vtkMultiChannelReprojector*>(info->UserData)->ReprojectLoop();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::ReprojectLoop()
+{
+  vtkMultiChannelReprojectorInternals* internals = this->Internals;
+
+#ifdef _WIN32
+  wglMakeCurrent(internals->DeviceContext, internals->Context);
+#endif
+
+  // Last refresh checked for a missed frame
+  double checked = 0;
+
+  this->Lock->Lock();
+  while (!this->StopRequested)
+    {
+    double period = 1.0 / this->TargetFrameRate;
+    double now = vtkTimerLog::GetUniversalTime();
+
+    // Wait for the first frame
+    if (internals->LastSwapTime <= 0)
+      {
+      this->Lock->Unlock();
+      vtksys::SystemTools::Delay(1);
+      this->Lock->Lock();
+      continue;
+      }
+
+    // The next refresh, from the phase of the last swap
+    double refresh = internals->LastSwapTime + period;
+    double earliest = (checked + 0.5 * period > now + this->LeadTime) ?
+      checked + 0.5 * period : now + this->LeadTime;
+    if (refresh < earliest)
+      {
+      refresh += ceil((earliest - refresh) / period) * period;
+      }
+    double time = refresh - this->LeadTime;
+
+    this->Lock->Unlock();
+
+    // Sleep in short steps, then spin for the accuracy sleeping lacks
+    while (time - vtkTimerLog::GetUniversalTime() > 0.002)
+      {
+      vtksys::SystemTools::Delay(1);
+      }
+    while (vtkTimerLog::GetUniversalTime() < time)
+      {
+      }
+
+    this->Lock->Lock();
+    if (this->StopRequested)
+      {
+      break;
+      }
+
+    // Missed if nothing was swapped since the last refresh and nothing
+    // is ready to swap at this one
+    if (internals->HasFront && !internals->Ready &&
+        internals->LastSwapTime < refresh - 0.5 * period)
+      {
+      this->NumberOfReprojectedFrames++;
+      this->Reproject();
+      }
+
+    checked = refresh;
+    }
+  this->Lock->Unlock();
+
+#ifdef _WIN32
+  wglMakeCurrent(NULL, NULL);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::Reproject()
+{
+  vtkMultiChannelReprojectorInternals* internals = this->Internals;
+
+  // Copy what is drawn, and keep the set from being captured into while
+  // it is drawn without the lock
+  std::vector<vtkMultiChannelReprojectorInternals::Image> images = internals->Images[internals->Front];
+  int hasView = internals->HasView;
+  double view[3][3];
+  for (int i = 0; i < 3; i++)
+    {
+    for (int j = 0; j < 3; j++)
+      {
+      view[i][j] = internals->View[i][j];
+      }
+    }
+  internals->Drawing = internals->Front;
+  this->Lock->Unlock();
+
+  glDrawBuffer(GL_FRONT);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_LIGHTING);
+  glDisable(GL_BLEND);
+  glEnable(GL_TEXTURE_2D);
+  glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  glMatrixMode(GL_MODELVIEW);
+  glLoadIdentity();
+
+  static const double corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+
+  for (unsigned int i = 0; i < images.size(); i++)
+    {
+    vtkMultiChannelReprojectorInternals::Image& image = images[i];
+
+    // Parallel projections cannot be rotated this way
+    if (!image.Target || fabs(vtkMath::Determinant3x3(image.Projection)) < 1e-12)
+      {
+      continue;
+      }
+
+    // Rotation of the channel's view from the latest view to the one
+    // rendered, R_channel * R_latest^T * R_base * R_channel^T
+    double channelInverse[3][3];
+    vtkMath::Transpose3x3(image.ChannelRotation, channelInverse);
+
+    double latestInverse[3][3];
+    vtkMath::Transpose3x3(hasView ? view : image.BaseRotation, latestInverse);
+
+    double product[3][3], rotation[3][3];
+    vtkMath::Multiply3x3(image.ChannelRotation, latestInverse, rotation);
+    vtkMath::Multiply3x3(rotation, image.BaseRotation, product);
+    vtkMath::Multiply3x3(product, channelInverse, rotation);
+
+    // Homography from the channel's clip coordinates at the latest view
+    // to those of the image
+    double projectionInverse[3][3];
+    vtkMath::Invert3x3(image.Projection, projectionInverse);
+
+    double homography[3][3];
+    vtkMath::Multiply3x3(image.Projection, rotation, product);
+    vtkMath::Multiply3x3(product, projectionInverse, homography);
+
+    double texCoords[4][3];
+    bool behind = false;
+    for (int j = 0; j < 4; j++)
+      {
+      double point[3] = { corners[j][0], corners[j][1], 1.0 };
+      vtkMath::Multiply3x3(homography, point, texCoords[j]);
+      behind = behind || texCoords[j][2] <= 0;
+      }
+
+    // Rotated too far to show any of the image
+    if (behind)
+      {
+      continue;
+      }
+
+    glViewport(image.Region[0], image.Region[1], image.Region[2], image.Region[3]);
+    glBindTexture(GL_TEXTURE_2D, image.Target->GetHandle());
+
+    // The image's part of the target
+    double s = static_cast<double>(image.Size[0]) / image.Target->GetWidth();
+    double t = static_cast<double>(image.Size[1]) / image.Target->GetHeight();
+
+    // Projective texture coordinates, from clip to texture coordinates
+    glBegin(GL_QUADS);
+    for (int j = 0; j < 4; j++)
+      {
+      double w = texCoords[j][2];
+      glTexCoord4d(0.5 * s * (texCoords[j][0] + w), 0.5 * t * (texCoords[j][1] + w), 0.0, w);
+      glVertex2d(corners[j][0], corners[j][1]);
+      }
+    glEnd();
+    }
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glFinish();
+
+  this->Lock->Lock();
+  internals->Drawing = -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelReprojector::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Target Frame Rate: " << this->TargetFrameRate << "\n";
+  os << indent << "Lead Time: " << this->LeadTime << "\n";
+  os << indent << "Running: " << this->Running << "\n";
+  os << indent << "Render Target Pool: " << this->RenderTargetPool << "\n";
+  os << indent << "Number Of Reprojected Frames: " << this->GetNumberOfReprojectedFrames() << "\n";
+}
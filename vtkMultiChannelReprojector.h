@@ -0,0 +1,148 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelReprojector.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelReprojector
+// .SECTION Description
+// vtkMultiChannelReprojector keeps the display of a head-mounted display
+// or other tracked layout moving with the head when a frame misses its
+// swap.  It keeps the last completed image of each channel with the
+// camera it was rendered with.  If no new frame is ready shortly before
+// a refresh, a thread with its own context draws those images, rotated
+// to the latest tracked view, straight into the front buffer.  This is
+// a single textured pass per channel instead of a full render.
+//
+// Only rotation is corrected, so objects close to the viewer will still
+// judder when the head moves sideways.  Areas rotated in from outside
+// the last images are black.  Drawing to the front buffer needs a full
+// screen window, or desktop composition turned off.
+//
+// Set on a vtkMultiChannelRenderWindowHelper, the images are copied into
+// targets from the helper's vtkMultiChannelRenderTargetPool after the
+// channels are rendered, and the window reports each swap.
+// Call UpdateView() with each new tracker reading, from any thread.
+// Call Start() and Stop() from the thread that renders the window, with
+// its context current.  The window is not reference counted and must
+// outlive the reprojector's thread.  Windows only.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkMultiChannelFramePacer
+// vtkMultiChannelRenderTargetPool vtkRenciRenderWindowManager
+
+#ifndef __vtkMultiChannelReprojector_h
+#define __vtkMultiChannelReprojector_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+#include "vtkMultiThreader.h"   // For VTK_THREAD_RETURN_TYPE
+
+class vtkCollection;
+class vtkMatrix4x4;
+class vtkMultiChannelRenderTargetPool;
+class vtkMultiChannelReprojectorInternals;
+class vtkMutexLock;
+class vtkRenderWindow;
+class vtkRenderer;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelReprojector : public vtkObject
+{
+public:
+  static vtkMultiChannelReprojector *New();
+  vtkTypeRevisionMacro(vtkMultiChannelReprojector,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Refresh rate of the display, in frames per second
+  vtkSetClampMacro(TargetFrameRate,double,1.0,1000.0);
+  vtkGetMacro(TargetFrameRate,double);
+
+  // Description:
+  // Time in seconds before a refresh at which a missed frame is replaced
+  vtkSetClampMacro(LeadTime,double,0.0,0.1);
+  vtkGetMacro(LeadTime,double);
+
+  // Description:
+  // Pool the images are taken from.  Set by the helper.  It cannot be
+  // changed while running.
+  void SetRenderTargetPool(vtkMultiChannelRenderTargetPool*);
+  vtkGetObjectMacro(RenderTargetPool,vtkMultiChannelRenderTargetPool);
+
+  // Description:
+  // Start and stop reprojecting into the given window
+  int Start(vtkRenderWindow*);
+  void Stop();
+  vtkGetMacro(Running,int);
+
+  // Description:
+  // Set the latest tracked view, as the view transform matrix of the
+  // camera before any channel rotations.  Safe to call from any thread.
+  void UpdateView(vtkMatrix4x4*);
+
+  // Description:
+  // Called by the helper once the channels are rendered, to copy their
+  // images with the camera they were rendered with
+  void CaptureFrame(vtkRenderer*, vtkCollection* channels);
+
+  // Description:
+  // Called by the window before and after each swap
+  void FrameReady();
+  void FrameSwapped();
+
+  // Description:
+  // Number of refreshes a reprojected frame was shown for
+  int GetNumberOfReprojectedFrames();
+
+  // Description:
+  // Texture memory in bytes held for a channel's images.  Call it from
+  // the thread that renders the window.
+  double GetChannelMemory(int);
+
+protected:
+  vtkMultiChannelReprojector();
+  ~vtkMultiChannelReprojector();
+
+  double TargetFrameRate;
+  double LeadTime;
+
+  int Running;
+  int StopRequested;
+
+  vtkRenderWindow* RenderWindow;
+  vtkMultiChannelRenderTargetPool* RenderTargetPool;
+
+  vtkMultiThreader* Threader;
+  int ThreadId;
+  vtkMutexLock* Lock;
+
+  int NumberOfReprojectedFrames;
+
+  vtkMultiChannelReprojectorInternals* Internals;
+
+  // Description:
+  // Thread entry point and loop
+  static VTK_THREAD_RETURN_TYPE ThreadMain(void*);
+  void ReprojectLoop();
+
+  // Description:
+  // Draw the last images rotated to the latest view.  Called with the
+  // lock held, which is released while drawing.
+  void Reproject();
+
+private:
+  vtkMultiChannelReprojector(const vtkMultiChannelReprojector&);  // Not implemented.
+  void operator=(const vtkMultiChannelReprojector&);  // Not implemented.
+};
+
+#endif
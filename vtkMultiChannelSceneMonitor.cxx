@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelSceneMonitor.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelSceneMonitor.h"
+
+#include "vtkCamera.h"
+#include "vtkCollection.h"
+#include "vtkLight.h"
+#include "vtkLightCollection.h"
+#include "vtkObjectFactory.h"
+#include "vtkProp.h"
+#include "vtkPropCollection.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelSceneMonitor, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelSceneMonitor);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelSceneMonitorInternals
+{
+public:
+  // Everything compared, in order
+  std::vector<double> Signature;
+  std::vector<double> LastSignature;
+  int HasSignature;
+
+  void Add(double value)
+    {
+    this->Signature.push_back(value);
+    }
+
+  void Add(const double* values, int n)
+    {
+    this->Signature.insert(this->Signature.end(), values, values + n);
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelSceneMonitor::vtkMultiChannelSceneMonitor()
+{
+  this->NumberOfUnchangedFrames = 0;
+
+  this->Internals = new vtkMultiChannelSceneMonitorInternals;
+  this->Internals->HasSignature = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelSceneMonitor::~vtkMultiChannelSceneMonitor()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelSceneMonitor::Update(vtkRendererCollection* renderers, vtkCollection* channels)
+{
+  vtkMultiChannelSceneMonitorInternals* internals = this->Internals;
+  internals->Signature.clear();
+
+  vtkCollectionSimpleIterator iterator;
+  vtkRenderer* renderer;
+  for (renderers->InitTraversal(iterator); (renderer = renderers->GetNextRenderer(iterator)); )
+    {
+    if (internals->Signature.empty())
+      {
+      int* size = renderer->GetRenderWindow()->GetSize();
+      internals->Add(size[0]);
+      internals->Add(size[1]);
+      }
+
+    internals->Add(renderer->GetViewport(), 4);
+    internals->Add(renderer->GetBackground(), 3);
+
+    vtkCamera* camera = renderer->GetActiveCamera();
+    internals->Add(camera->GetPosition(), 3);
+    internals->Add(camera->GetFocalPoint(), 3);
+    internals->Add(camera->GetViewUp(), 3);
+    internals->Add(camera->GetViewAngle());
+    internals->Add(camera->GetParallelScale());
+    internals->Add(camera->GetParallelProjection());
+
+    // Lights that follow the camera are moved every frame, to the same
+    // place while the camera is still
+    vtkCollectionSimpleIterator lightIterator;
+    vtkLight* light;
+    vtkLightCollection* lights = renderer->GetLights();
+    for (lights->InitTraversal(lightIterator); (light = lights->GetNextItem(lightIterator)); )
+      {
+      internals->Add(light->GetSwitch());
+      internals->Add(light->GetIntensity());
+      internals->Add(light->GetDiffuseColor(), 3);
+      internals->Add(light->GetPosition(), 3);
+      internals->Add(light->GetFocalPoint(), 3);
+      }
+
+    vtkCollectionSimpleIterator propIterator;
+    vtkProp* prop;
+    vtkPropCollection* props = renderer->GetViewProps();
+    internals->Add(props->GetNumberOfItems());
+    for (props->InitTraversal(propIterator); (prop = props->GetNextProp(propIterator)); )
+      {
+      internals->Add(prop->GetVisibility());
+      internals->Add(prop->GetMTime());
+      internals->Add(prop->GetRedrawMTime());
+      }
+    }
+
+  internals->Add(channels->GetNumberOfItems());
+  for (int i = 0; i < channels->GetNumberOfItems(); i++)
+    {
+    internals->Add(channels->GetItemAsObject(i)->GetMTime());
+    }
+
+  int changed = !internals->HasSignature || internals->Signature != internals->LastSignature;
+
+  internals->LastSignature.swap(internals->Signature);
+  internals->HasSignature = 1;
+
+  this->NumberOfUnchangedFrames = changed ? 0 : this->NumberOfUnchangedFrames + 1;
+
+  return changed;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelSceneMonitor::Reset()
+{
+  this->Internals->HasSignature = 0;
+  this->NumberOfUnchangedFrames = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelSceneMonitor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Unchanged Frames: " << this->NumberOfUnchangedFrames << "\n";
+}
@@ -0,0 +1,74 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelSceneMonitor.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelSceneMonitor
+// .SECTION Description
+// vtkMultiChannelSceneMonitor tells whether anything that affects the
+// rendered image has changed since it last looked.  Each channel
+// modifies the camera and renderer while it renders and puts them back
+// after, so their modification times change every frame.  The camera,
+// background and lights are therefore compared by value.  Props are
+// compared by visibility and by the modification time of everything they
+// draw, and channels by modification time.  The window size is compared
+// too.
+
+// .SECTION see also
+// vtkMultiChannelAccumulator vtkMultiChannelRenderWindowHelper
+
+#ifndef __vtkMultiChannelSceneMonitor_h
+#define __vtkMultiChannelSceneMonitor_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkCollection;
+class vtkMultiChannelSceneMonitorInternals;
+class vtkRendererCollection;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelSceneMonitor : public vtkObject
+{
+public:
+  static vtkMultiChannelSceneMonitor *New();
+  vtkTypeRevisionMacro(vtkMultiChannelSceneMonitor,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Look at the scene.  Returns 1 if it has changed since the last call
+  // or Reset(), 0 if not.
+  int Update(vtkRendererCollection*, vtkCollection* channels);
+
+  // Description:
+  // Make the next Update() report a change
+  void Reset();
+
+  // Description:
+  // Number of calls to Update() since the scene last changed
+  vtkGetMacro(NumberOfUnchangedFrames,int);
+
+protected:
+  vtkMultiChannelSceneMonitor();
+  ~vtkMultiChannelSceneMonitor();
+
+  int NumberOfUnchangedFrames;
+
+  vtkMultiChannelSceneMonitorInternals* Internals;
+
+private:
+  vtkMultiChannelSceneMonitor(const vtkMultiChannelSceneMonitor&);  // Not implemented.
+  void operator=(const vtkMultiChannelSceneMonitor&);  // Not implemented.
+};
+
+#endif
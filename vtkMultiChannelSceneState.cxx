@@ -0,0 +1,243 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelSceneState.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelSceneState.h"
+
+#include "vtkCamera.h"
+#include "vtkCollection.h"
+#include "vtkCriticalSection.h"
+#include "vtkObjectFactory.h"
+#include "vtkProp3D.h"
+#include "vtkRenderer.h"
+#include "vtkRendererCollection.h"
+
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelSceneState, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelSceneState);
+
+vtkCxxSetObjectMacro(vtkMultiChannelSceneState, SourceCamera, vtkCamera);
+
+// Number of values stored per camera and per prop
+#define VTK_MULTICHANNEL_CAMERA_SIZE  12
+#define VTK_MULTICHANNEL_PROP_SIZE    12
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelSceneStateInternals
+{
+public:
+  struct Snapshot
+  {
+    int HasCamera;
+    double Camera[VTK_MULTICHANNEL_CAMERA_SIZE];
+    std::vector<double> Props;
+  };
+
+  Snapshot Slots[3];
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelSceneState::vtkMultiChannelSceneState()
+{
+  this->SourceCamera = NULL;
+
+  this->SourceProps = vtkCollection::New();
+  this->TargetProps = vtkCollection::New();
+
+  this->WriteSlot = 0;
+  this->ReadySlot = 1;
+  this->ReadSlot = 2;
+  this->Fresh = 0;
+
+  this->NumberOfPublishedSnapshots = 0;
+  this->NumberOfAppliedSnapshots = 0;
+
+  this->Lock = new vtkSimpleCriticalSection;
+
+  this->Internals = new vtkMultiChannelSceneStateInternals;
+  for (int i = 0; i < 3; i++)
+    {
+    this->Internals->Slots[i].HasCamera = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelSceneState::~vtkMultiChannelSceneState()
+{
+  this->SetSourceCamera(NULL);
+
+  this->SourceProps->Delete();
+  this->TargetProps->Delete();
+
+  delete this->Lock;
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelSceneState::AddProp(vtkProp3D* source, vtkProp3D* target)
+{
+  if (!source || !target)
+    {
+    vtkErrorMacro(<< "Both a source and a target prop are required.");
+    return;
+    }
+
+  this->SourceProps->AddItem(source);
+  this->TargetProps->AddItem(target);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelSceneState::RemoveAllProps()
+{
+  this->SourceProps->RemoveAllItems();
+  this->TargetProps->RemoveAllItems();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelSceneState::GetNumberOfProps()
+{
+  return this->SourceProps->GetNumberOfItems();
+}
+
+//----------------------------------------------------------------------------
+vtkProp3D* vtkMultiChannelSceneState::GetSourceProp(int i)
+{
+  return static_cast<vtkProp3D*>(this->SourceProps->GetItemAsObject(i));
+}
+
+//----------------------------------------------------------------------------
+vtkProp3D* vtkMultiChannelSceneState::GetTargetProp(int i)
+{
+  return static_cast<vtkProp3D*>(this->TargetProps->GetItemAsObject(i));
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelSceneState::Publish()
+{
+  // The write slot is owned by this thread, so fill it without locking
+  vtkMultiChannelSceneStateInternals::Snapshot& slot =
+    this->Internals->Slots[this->WriteSlot];
+
+  slot.HasCamera = this->SourceCamera != NULL;
+  if (this->SourceCamera)
+    {
+    double* c = slot.Camera;
+    this->SourceCamera->GetPosition(c);
+    this->SourceCamera->GetFocalPoint(c + 3);
+    this->SourceCamera->GetViewUp(c + 6);
+    c[9] = this->SourceCamera->GetViewAngle();
+    c[10] = this->SourceCamera->GetParallelScale();
+    c[11] = this->SourceCamera->GetParallelProjection();
+    }
+
+  int numProps = this->SourceProps->GetNumberOfItems();
+  slot.Props.resize(numProps * VTK_MULTICHANNEL_PROP_SIZE);
+  for (int i = 0; i < numProps; i++)
+    {
+    vtkProp3D* prop = static_cast<vtkProp3D*>(this->SourceProps->GetItemAsObject(i));
+    double* p = &slot.Props[i * VTK_MULTICHANNEL_PROP_SIZE];
+    prop->GetPosition(p);
+    prop->GetOrientation(p + 3);
+    prop->GetScale(p + 6);
+    prop->GetOrigin(p + 9);
+    }
+
+  // Make it the newest snapshot
+  this->Lock->Lock();
+  int ready = this->ReadySlot;
+  this->ReadySlot = this->WriteSlot;
+  this->WriteSlot = ready;
+  this->Fresh = 1;
+  this->NumberOfPublishedSnapshots++;
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelSceneState::Apply(vtkRendererCollection* renderers)
+{
+  // Take the newest snapshot, if there is one
+  this->Lock->Lock();
+  int fresh = this->Fresh;
+  if (fresh)
+    {
+    int ready = this->ReadySlot;
+    this->ReadySlot = this->ReadSlot;
+    this->ReadSlot = ready;
+    this->Fresh = 0;
+    this->NumberOfAppliedSnapshots++;
+    }
+  this->Lock->Unlock();
+
+  if (!fresh)
+    {
+    return 0;
+    }
+
+  // The read slot is owned by this thread
+  vtkMultiChannelSceneStateInternals::Snapshot& slot =
+    this->Internals->Slots[this->ReadSlot];
+
+  if (slot.HasCamera && renderers)
+    {
+    const double* c = slot.Camera;
+
+    vtkCollectionSimpleIterator iterator;
+    vtkRenderer* renderer;
+    for (renderers->InitTraversal(iterator); (renderer = renderers->GetNextRenderer(iterator)); )
+      {
+      // The source camera belongs to the application thread
+      vtkCamera* camera = renderer->GetActiveCamera();
+      if (camera == this->SourceCamera)
+        {
+        continue;
+        }
+      camera->SetPosition(c[0], c[1], c[2]);
+      camera->SetFocalPoint(c[3], c[4], c[5]);
+      camera->SetViewUp(c[6], c[7], c[8]);
+      camera->SetViewAngle(c[9]);
+      camera->SetParallelScale(c[10]);
+      camera->SetParallelProjection(static_cast<int>(c[11]));
+      }
+    }
+
+  int numProps = static_cast<int>(slot.Props.size()) / VTK_MULTICHANNEL_PROP_SIZE;
+  if (numProps > this->TargetProps->GetNumberOfItems())
+    {
+    numProps = this->TargetProps->GetNumberOfItems();
+    }
+  for (int i = 0; i < numProps; i++)
+    {
+    vtkProp3D* prop = static_cast<vtkProp3D*>(this->TargetProps->GetItemAsObject(i));
+    const double* p = &slot.Props[i * VTK_MULTICHANNEL_PROP_SIZE];
+    prop->SetPosition(p[0], p[1], p[2]);
+    prop->SetOrientation(p[3], p[4], p[5]);
+    prop->SetScale(p[6], p[7], p[8]);
+    prop->SetOrigin(p[9], p[10], p[11]);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelSceneState::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Source Camera: " << this->SourceCamera << "\n";
+  os << indent << "Number Of Props: " << this->SourceProps->GetNumberOfItems() << "\n";
+  os << indent << "Number Of Published Snapshots: " << this->NumberOfPublishedSnapshots << "\n";
+  os << indent << "Number Of Applied Snapshots: " << this->NumberOfAppliedSnapshots << "\n";
+}
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelSceneState.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelSceneState
+// .SECTION Description
+// vtkMultiChannelSceneState is a triple-buffered snapshot of the camera
+// and prop transforms used to hand scene changes from the application
+// thread to a vtkMultiChannelRenderThread.  The application thread calls
+// Publish(), which copies the source camera and source props into a
+// private slot and makes it the newest snapshot without waiting on the
+// render thread.  The render thread calls Apply(), which takes the newest
+// snapshot and writes it to the renderers' cameras, other than the
+// source camera, and the target props.
+// Neither thread ever blocks on the other for longer than an index swap.
+//
+// Source objects are only read by Publish() and target objects are only
+// written by Apply(), so the source camera and props should not be the
+// ones being rendered.  Props should be added before the render thread is
+// started.  Only position, orientation, scale and origin of props are
+// transferred.
+
+// .SECTION see also
+// vtkMultiChannelRenderThread vtkMultiChannelRenderWindowHelper
+
+#ifndef __vtkMultiChannelSceneState_h
+#define __vtkMultiChannelSceneState_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkCamera;
+class vtkCollection;
+class vtkProp3D;
+class vtkRendererCollection;
+class vtkSimpleCriticalSection;
+
+class vtkMultiChannelSceneStateInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelSceneState : public vtkObject
+{
+public:
+  static vtkMultiChannelSceneState *New();
+  vtkTypeRevisionMacro(vtkMultiChannelSceneState,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Camera read by Publish().  Its state is copied to the active camera
+  // of each renderer by Apply().
+  void SetSourceCamera(vtkCamera*);
+  vtkGetObjectMacro(SourceCamera,vtkCamera);
+
+  // Description:
+  // Add a prop whose transform is read from source by Publish() and
+  // written to target by Apply().
+  void AddProp(vtkProp3D* source, vtkProp3D* target);
+  void RemoveAllProps();
+
+  // Description:
+  // Props added, as source and target pairs
+  int GetNumberOfProps();
+  vtkProp3D* GetSourceProp(int i);
+  vtkProp3D* GetTargetProp(int i);
+
+  // Description:
+  // Copy the source camera and props into a new snapshot.  Called from
+  // the application thread.
+  void Publish();
+
+  // Description:
+  // Apply the newest published snapshot to the renderers and target
+  // props.  Called from the render thread.  Returns 1 if a snapshot
+  // newer than the last one applied was used, 0 otherwise.
+  int Apply(vtkRendererCollection*);
+
+  // Description:
+  // Number of snapshots published and applied
+  vtkGetMacro(NumberOfPublishedSnapshots,int);
+  vtkGetMacro(NumberOfAppliedSnapshots,int);
+
+protected:
+  vtkMultiChannelSceneState();
+  ~vtkMultiChannelSceneState();
+
+  vtkCamera* SourceCamera;
+
+  vtkCollection* SourceProps;
+  vtkCollection* TargetProps;
+
+  // Slot indices, swapped under Lock
+  int WriteSlot;
+  int ReadySlot;
+  int ReadSlot;
+  int Fresh;
+
+  int NumberOfPublishedSnapshots;
+  int NumberOfAppliedSnapshots;
+
+  vtkSimpleCriticalSection* Lock;
+
+  vtkMultiChannelSceneStateInternals* Internals;
+
+private:
+  vtkMultiChannelSceneState(const vtkMultiChannelSceneState&);  // Not implemented.
+  void operator=(const vtkMultiChannelSceneState&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,712 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelStreamer.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelStreamer.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkCamera.h"
+#include "vtkCollection.h"
+#include "vtkConditionVariable.h"
+#include "vtkDataObject.h"
+#include "vtkExecutive.h"
+#include "vtkExtentTranslator.h"
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkRenderWindowChannel.h"
+#include "vtkRenderer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTrivialProducer.h"
+
+#include <algorithm>
+#include <math.h>
+#include <set>
+#include <utility>
+#include <vector>
+
+vtkCxxRevisionMacro(vtkMultiChannelStreamer, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelStreamer);
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelStreamerInternals
+{
+public:
+  struct Piece
+  {
+    double Bounds[6];
+    int HasBounds;
+
+    vtkDataObject* Data;
+    double Size;
+
+    int LastSeenFrame;
+    double Priority;
+  };
+
+  // Only used by the render thread
+  std::vector<Piece> Pieces;
+
+  // Shared with the worker, under the lock.  Pending holds the pieces
+  // being loaded or loaded but not yet taken in.
+  std::vector<int> Requests;
+  std::vector<std::pair<int, vtkDataObject*> > Completed;
+  std::set<int> Pending;
+};
+
+//----------------------------------------------------------------------------
+// Orders piece requests largest first
+class vtkMultiChannelStreamerCompare
+{
+public:
+  vtkMultiChannelStreamerCompare(vtkMultiChannelStreamerInternals* internals)
+    {
+    this->Internals = internals;
+    }
+
+  bool operator()(int a, int b) const
+    {
+    return this->Internals->Pieces[a].Priority > this->Internals->Pieces[b].Priority;
+    }
+
+  vtkMultiChannelStreamerInternals* Internals;
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelStreamer::vtkMultiChannelStreamer()
+{
+  this->Pipeline = NULL;
+  this->NumberOfPieces = 1;
+  this->MemoryBudget = 1024.0 * 1024.0 * 1024.0;
+
+  this->Running = 0;
+  this->StopRequested = 0;
+  this->FrameNumber = 0;
+
+  this->NumberOfVisiblePieces = 0;
+  this->NumberOfLoadedPieces = 0;
+  this->CurrentMemory = 0;
+  this->LargestPieceSize = 0;
+  this->NumberOfLoads = 0;
+  this->NumberOfEvictions = 0;
+
+  this->Producer = vtkTrivialProducer::New();
+
+  this->Threader = vtkMultiThreader::New();
+  this->ThreadId = -1;
+  this->Lock = vtkMutexLock::New();
+  this->WorkCondition = vtkConditionVariable::New();
+
+  this->Internals = new vtkMultiChannelStreamerInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelStreamer::~vtkMultiChannelStreamer()
+{
+  this->Stop();
+  this->SetPipeline(NULL);
+
+  for (unsigned int i = 0; i < this->Internals->Pieces.size(); i++)
+    {
+    if (this->Internals->Pieces[i].Data)
+      {
+      this->Internals->Pieces[i].Data->Delete();
+      }
+    }
+  for (unsigned int i = 0; i < this->Internals->Completed.size(); i++)
+    {
+    this->Internals->Completed[i].second->Delete();
+    }
+
+  this->Producer->Delete();
+
+  this->Threader->Delete();
+  this->Lock->Delete();
+  this->WorkCondition->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::SetPipeline(vtkAlgorithm* pipeline)
+{
+  if (this->Running)
+    {
+    vtkErrorMacro(<< "Cannot set the pipeline while running.");
+    return;
+    }
+
+  if (this->Pipeline == pipeline)
+    {
+    return;
+    }
+
+  if (this->Pipeline)
+    {
+    this->Pipeline->UnRegister(this);
+    }
+  this->Pipeline = pipeline;
+  if (this->Pipeline)
+    {
+    this->Pipeline->Register(this);
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::SetPieceBounds(int piece, const double bounds[6])
+{
+  if (piece < 0)
+    {
+    return;
+    }
+
+  if (piece >= static_cast<int>(this->Internals->Pieces.size()))
+    {
+    vtkMultiChannelStreamerInternals::Piece empty;
+    empty.HasBounds = 0;
+    empty.Data = NULL;
+    empty.Size = 0;
+    empty.LastSeenFrame = -1;
+    empty.Priority = 0;
+    this->Internals->Pieces.resize(piece + 1, empty);
+    }
+
+  vtkMultiChannelStreamerInternals::Piece& p = this->Internals->Pieces[piece];
+  for (int i = 0; i < 6; i++)
+    {
+    p.Bounds[i] = bounds[i];
+    }
+  p.HasBounds = 1;
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::RemoveAllPieceBounds()
+{
+  for (unsigned int i = 0; i < this->Internals->Pieces.size(); i++)
+    {
+    this->Internals->Pieces[i].HasBounds = 0;
+    }
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithmOutput* vtkMultiChannelStreamer::GetOutputPort()
+{
+  return this->Producer->GetOutputPort();
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::Start()
+{
+  if (this->Running)
+    {
+    return;
+    }
+
+  if (!this->Pipeline)
+    {
+    vtkErrorMacro(<< "No pipeline to stream.");
+    return;
+    }
+
+  // Pieces loaded with a different number of pieces do not fit
+  if (static_cast<int>(this->Internals->Pieces.size()) != this->NumberOfPieces)
+    {
+    for (unsigned int i = 0; i < this->Internals->Pieces.size(); i++)
+      {
+      vtkMultiChannelStreamerInternals::Piece& piece = this->Internals->Pieces[i];
+      if (piece.Data)
+        {
+        piece.Data->Delete();
+        piece.Data = NULL;
+        this->CurrentMemory -= piece.Size;
+        }
+      }
+
+    vtkMultiChannelStreamerInternals::Piece empty;
+    empty.HasBounds = 0;
+    empty.Data = NULL;
+    empty.Size = 0;
+    empty.LastSeenFrame = -1;
+    empty.Priority = 0;
+    this->Internals->Pieces.resize(this->NumberOfPieces, empty);
+    this->LargestPieceSize = 0;
+
+    this->UpdateOutput();
+    }
+
+  this->ComputePieceBounds();
+
+  this->StopRequested = 0;
+  this->Running = 1;
+
+  this->ThreadId = this->Threader->SpawnThread(&vtkMultiChannelStreamer::WorkerMain, this);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::Stop()
+{
+  if (!this->Running)
+    {
+    return;
+    }
+
+  this->Lock->Lock();
+  this->StopRequested = 1;
+  this->Internals->Requests.clear();
+  this->WorkCondition->Broadcast();
+  this->Lock->Unlock();
+
+  // Waits for the piece being loaded
+  this->Threader->TerminateThread(this->ThreadId);
+  this->ThreadId = -1;
+
+  this->Running = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::ComputePieceBounds()
+{
+  this->Pipeline->UpdateInformation();
+
+  vtkInformation* info = this->Pipeline->GetExecutive()->GetOutputInformation(0);
+  if (!info ||
+      !info->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()) ||
+      !info->Has(vtkDataObject::ORIGIN()) ||
+      !info->Has(vtkDataObject::SPACING()))
+    {
+    // Not image data
+    return;
+    }
+
+  int wholeExtent[6];
+  double origin[3];
+  double spacing[3];
+  info->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  info->Get(vtkDataObject::ORIGIN(), origin);
+  info->Get(vtkDataObject::SPACING(), spacing);
+
+  // Split the extent the same way the pipeline will
+  vtkExtentTranslator* translator = vtkExtentTranslator::New();
+  translator->SetWholeExtent(wholeExtent);
+  translator->SetNumberOfPieces(this->NumberOfPieces);
+  translator->SetGhostLevel(0);
+
+  for (int i = 0; i < this->NumberOfPieces; i++)
+    {
+    vtkMultiChannelStreamerInternals::Piece& piece = this->Internals->Pieces[i];
+
+    translator->SetPiece(i);
+    if (!translator->PieceToExtent())
+      {
+      continue;
+      }
+
+    int extent[6];
+    translator->GetExtent(extent);
+    for (int j = 0; j < 3; j++)
+      {
+      double a = origin[j] + extent[2 * j] * spacing[j];
+      double b = origin[j] + extent[2 * j + 1] * spacing[j];
+      piece.Bounds[2 * j] = a < b ? a : b;
+      piece.Bounds[2 * j + 1] = a < b ? b : a;
+      }
+    piece.HasBounds = 1;
+    }
+
+  translator->Delete();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelStreamer::Update(vtkRenderer* renderer, vtkCollection* channels)
+{
+  if (!this->Running)
+    {
+    return 0;
+    }
+
+  this->FrameNumber++;
+
+  int changed = 0;
+
+  // Take in the loaded pieces
+  this->Lock->Lock();
+  std::vector<std::pair<int, vtkDataObject*> > completed;
+  completed.swap(this->Internals->Completed);
+  for (unsigned int i = 0; i < completed.size(); i++)
+    {
+    this->Internals->Pending.erase(completed[i].first);
+    }
+  this->Lock->Unlock();
+
+  for (unsigned int i = 0; i < completed.size(); i++)
+    {
+    vtkMultiChannelStreamerInternals::Piece& piece = this->Internals->Pieces[completed[i].first];
+    if (piece.Data)
+      {
+      completed[i].second->Delete();
+      continue;
+      }
+
+    piece.Data = completed[i].second;
+    piece.Size = piece.Data->GetActualMemorySize() * 1024.0;
+    piece.LastSeenFrame = this->FrameNumber;
+    this->CurrentMemory += piece.Size;
+    if (piece.Size > this->LargestPieceSize)
+      {
+      this->LargestPieceSize = piece.Size;
+      }
+    changed = 1;
+    }
+
+  this->UpdateVisibility(renderer, channels);
+
+  this->NumberOfLoadedPieces = 0;
+  std::vector<int> requests;
+  for (unsigned int i = 0; i < this->Internals->Pieces.size(); i++)
+    {
+    vtkMultiChannelStreamerInternals::Piece& piece = this->Internals->Pieces[i];
+    if (piece.Data)
+      {
+      this->NumberOfLoadedPieces++;
+      }
+    else if (piece.LastSeenFrame == this->FrameNumber)
+      {
+      requests.push_back(static_cast<int>(i));
+      }
+    }
+
+  // Pieces are assumed to be no larger than the largest loaded so far
+  double pieceSize = this->LargestPieceSize;
+
+  std::stable_sort(requests.begin(), requests.end(),
+                   vtkMultiChannelStreamerCompare(this->Internals));
+
+  // Make room for the largest piece, and request as many as fit
+  if (!requests.empty())
+    {
+    changed |= this->Evict(this->MemoryBudget - pieceSize);
+    }
+  else
+    {
+    changed |= this->Evict(this->MemoryBudget);
+    }
+
+  this->Lock->Lock();
+  this->Internals->Requests.clear();
+
+  // Until a piece is loaded there is no estimate, so only one is loaded
+  // at a time
+  if (pieceSize <= 0 && !requests.empty())
+    {
+    requests.resize(this->Internals->Pending.empty() ? 1 : 0);
+    }
+
+  double memory = this->CurrentMemory;
+  for (unsigned int i = 0; i < requests.size(); i++)
+    {
+    if (this->Internals->Pending.find(requests[i]) != this->Internals->Pending.end())
+      {
+      memory += pieceSize;
+      continue;
+      }
+    if (memory + pieceSize > this->MemoryBudget)
+      {
+      break;
+      }
+    this->Internals->Requests.push_back(requests[i]);
+    memory += pieceSize;
+    }
+  this->WorkCondition->Signal();
+  this->Lock->Unlock();
+
+  if (changed)
+    {
+    this->UpdateOutput();
+    }
+
+  return changed;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::UpdateVisibility(vtkRenderer* renderer, vtkCollection* channels)
+{
+  std::vector<vtkMultiChannelStreamerInternals::Piece>& pieces = this->Internals->Pieces;
+  for (unsigned int i = 0; i < pieces.size(); i++)
+    {
+    pieces[i].Priority = 0;
+    if (!pieces[i].HasBounds)
+      {
+      pieces[i].LastSeenFrame = this->FrameNumber;
+      }
+    }
+
+  double position[3];
+  renderer->GetActiveCamera()->GetPosition(position);
+
+  for (int c = 0; c < channels->GetNumberOfItems(); c++)
+    {
+    vtkRenderWindowChannel* channel = vtkRenderWindowChannel::SafeDownCast(channels->GetItemAsObject(c));
+    if (!channel)
+      {
+      continue;
+      }
+
+    double planes[24];
+    channel->GetFrustumPlanes(renderer, planes);
+
+    // Only the side planes are used, as the clipping range depends on
+    // what is loaded
+    for (int p = 0; p < 4; p++)
+      {
+      double* plane = planes + 4 * p;
+      double length = sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+      if (length > 0)
+        {
+        for (int j = 0; j < 4; j++)
+          {
+          plane[j] /= length;
+          }
+        }
+      }
+
+    // Tangent of half the vertical view angle, from the angle between
+    // the bottom and top planes
+    double* bottom = planes + 8;
+    double* top = planes + 12;
+    double cosAngle = -(bottom[0] * top[0] + bottom[1] * top[1] + bottom[2] * top[2]);
+    double tanHalfAngle = cosAngle > -1.0 ? sqrt((1.0 - cosAngle) / (1.0 + cosAngle)) : 1.0;
+    if (tanHalfAngle <= 0)
+      {
+      tanHalfAngle = 1.0;
+      }
+
+    for (unsigned int i = 0; i < pieces.size(); i++)
+      {
+      vtkMultiChannelStreamerInternals::Piece& piece = pieces[i];
+      if (!piece.HasBounds)
+        {
+        continue;
+        }
+
+      // Outside if the corner farthest along a plane's normal is outside
+      const double* b = piece.Bounds;
+      int visible = 1;
+      for (int p = 0; p < 4 && visible; p++)
+        {
+        const double* plane = planes + 4 * p;
+        double x = plane[0] > 0 ? b[1] : b[0];
+        double y = plane[1] > 0 ? b[3] : b[2];
+        double z = plane[2] > 0 ? b[5] : b[4];
+        visible = plane[0] * x + plane[1] * y + plane[2] * z + plane[3] >= 0;
+        }
+      if (!visible)
+        {
+        continue;
+        }
+
+      // Fraction of the channel's height covered by the bounding sphere
+      double center[3];
+      double radius = 0;
+      double distance = 0;
+      for (int j = 0; j < 3; j++)
+        {
+        center[j] = (b[2 * j] + b[2 * j + 1]) / 2.0;
+        radius += (b[2 * j + 1] - b[2 * j]) * (b[2 * j + 1] - b[2 * j]) / 4.0;
+        distance += (center[j] - position[j]) * (center[j] - position[j]);
+        }
+      radius = sqrt(radius);
+      distance = sqrt(distance);
+
+      double size = distance > radius ? radius / (distance * tanHalfAngle) : VTK_DOUBLE_MAX;
+
+      piece.LastSeenFrame = this->FrameNumber;
+      if (size > piece.Priority)
+        {
+        piece.Priority = size;
+        }
+      }
+    }
+
+  this->NumberOfVisiblePieces = 0;
+  for (unsigned int i = 0; i < pieces.size(); i++)
+    {
+    if (pieces[i].LastSeenFrame == this->FrameNumber)
+      {
+      this->NumberOfVisiblePieces++;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelStreamer::Trim(double bytes)
+{
+  if (!this->Evict(bytes))
+    {
+    return 0;
+    }
+
+  this->UpdateOutput();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelStreamer::Evict(double bytes)
+{
+  std::vector<vtkMultiChannelStreamerInternals::Piece>& pieces = this->Internals->Pieces;
+
+  int evicted = 0;
+  while (this->CurrentMemory > bytes)
+    {
+    // Piece not seen for the longest time
+    int oldest = -1;
+    for (unsigned int i = 0; i < pieces.size(); i++)
+      {
+      if (pieces[i].Data && pieces[i].LastSeenFrame < this->FrameNumber &&
+          (oldest < 0 || pieces[i].LastSeenFrame < pieces[oldest].LastSeenFrame))
+        {
+        oldest = static_cast<int>(i);
+        }
+      }
+    if (oldest < 0)
+      {
+      break;
+      }
+
+    pieces[oldest].Data->Delete();
+    pieces[oldest].Data = NULL;
+    this->CurrentMemory -= pieces[oldest].Size;
+    pieces[oldest].Size = 0;
+
+    this->NumberOfLoadedPieces--;
+    this->NumberOfEvictions++;
+    evicted = 1;
+    }
+
+  return evicted;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::UpdateOutput()
+{
+  vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::New();
+
+  unsigned int block = 0;
+  for (unsigned int i = 0; i < this->Internals->Pieces.size(); i++)
+    {
+    if (this->Internals->Pieces[i].Data)
+      {
+      output->SetNumberOfBlocks(block + 1);
+      output->SetBlock(block, this->Internals->Pieces[i].Data);
+      block++;
+      }
+    }
+
+  this->Producer->SetOutput(output);
+  output->Delete();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMultiChannelStreamer::WorkerMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkMultiChannelStreamer* self = static_cast<vtkMultiChannelStreamer*>(info->UserData);
+  self->WorkerLoop();
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::WorkerLoop()
+{
+  this->Lock->Lock();
+  while (!this->StopRequested)
+    {
+    if (this->Internals->Requests.empty())
+      {
+      this->WorkCondition->Wait(this->Lock);
+      continue;
+      }
+
+    int piece = this->Internals->Requests.front();
+    this->Internals->Requests.erase(this->Internals->Requests.begin());
+    this->Internals->Pending.insert(piece);
+    this->Lock->Unlock();
+
+    // Request the piece
+    this->Pipeline->UpdateInformation();
+    vtkStreamingDemandDrivenPipeline* executive =
+      vtkStreamingDemandDrivenPipeline::SafeDownCast(this->Pipeline->GetExecutive());
+    if (executive)
+      {
+      executive->SetUpdateExtent(0, piece, this->NumberOfPieces, 0);
+      }
+    this->Pipeline->Update();
+
+    // The next piece replaces the output's arrays rather than modifying
+    // them, so a shallow copy keeps this piece's data
+    vtkDataObject* output = this->Pipeline->GetOutputDataObject(0);
+    vtkDataObject* data = NULL;
+    if (output)
+      {
+      data = output->NewInstance();
+      data->ShallowCopy(output);
+      }
+
+    this->Lock->Lock();
+    this->NumberOfLoads++;
+    if (data)
+      {
+      this->Internals->Completed.push_back(std::make_pair(piece, data));
+      }
+    else
+      {
+      this->Internals->Pending.erase(piece);
+      }
+    }
+  this->Lock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelStreamer::GetNumberOfLoads()
+{
+  this->Lock->Lock();
+  int loads = this->NumberOfLoads;
+  this->Lock->Unlock();
+
+  return loads;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelStreamer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Pipeline: " << this->Pipeline << "\n";
+  os << indent << "Number Of Pieces: " << this->NumberOfPieces << "\n";
+  os << indent << "Memory Budget: " << this->MemoryBudget << "\n";
+  os << indent << "Running: " << this->Running << "\n";
+  os << indent << "Number Of Visible Pieces: " << this->NumberOfVisiblePieces << "\n";
+  os << indent << "Number Of Loaded Pieces: " << this->NumberOfLoadedPieces << "\n";
+  os << indent << "Current Memory: " << this->CurrentMemory << "\n";
+  os << indent << "Largest Piece Size: " << this->LargestPieceSize << "\n";
+  os << indent << "Number Of Loads: " << this->NumberOfLoads << "\n";
+  os << indent << "Number Of Evictions: " << this->NumberOfEvictions << "\n";
+}
@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelStreamer.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelStreamer
+// .SECTION Description
+// vtkMultiChannelStreamer loads the pieces of a dataset too large for
+// memory that can be seen by at least one channel.  The pipeline is split
+// into NumberOfPieces pieces using VTK's piece requests, and executed one
+// piece at a time by a worker thread.  The pipeline must not be connected
+// to anything else.
+//
+// Set on a vtkMultiChannelRenderWindowHelper, Update() is called at the
+// start of each frame.  It tests the bounds of each piece against the
+// view frustum of each channel.  Pieces that are visible but not loaded
+// are requested, largest first, where the size of a piece is its
+// projected size in the channel in which it is largest.  While the
+// loaded pieces exceed MemoryBudget, those not seen for the longest
+// time are evicted.  Pieces visible in the current frame are never
+// evicted, so the budget should hold everything visible at once.
+//
+// The bounds of the pieces of image data are computed from the whole
+// extent, origin and spacing when Start() is called.  For other data,
+// give them with SetPieceBounds().  Pieces without bounds are always
+// loaded.
+//
+// The output is a vtkMultiBlockDataSet with a block for each loaded piece.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkRenderWindowChannel
+
+#ifndef __vtkMultiChannelStreamer_h
+#define __vtkMultiChannelStreamer_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+#include "vtkMultiThreader.h"   // For VTK_THREAD_RETURN_TYPE
+
+class vtkAlgorithm;
+class vtkAlgorithmOutput;
+class vtkCollection;
+class vtkConditionVariable;
+class vtkMultiChannelStreamerInternals;
+class vtkMutexLock;
+class vtkRenderer;
+class vtkTrivialProducer;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelStreamer : public vtkObject
+{
+public:
+  static vtkMultiChannelStreamer *New();
+  vtkTypeRevisionMacro(vtkMultiChannelStreamer,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Pipeline to request pieces from.  Cannot be set while running.
+  void SetPipeline(vtkAlgorithm*);
+  vtkGetObjectMacro(Pipeline,vtkAlgorithm);
+
+  // Description:
+  // Number of pieces the data is split into
+  vtkSetClampMacro(NumberOfPieces,int,1,VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfPieces,int);
+
+  // Description:
+  // Bounds of a piece, as (xmin,xmax,ymin,ymax,zmin,zmax).  Pieces
+  // without bounds are always loaded.
+  void SetPieceBounds(int piece, const double bounds[6]);
+  void RemoveAllPieceBounds();
+
+  // Description:
+  // Memory in bytes the loaded pieces are kept within
+  vtkSetClampMacro(MemoryBudget,double,0.0,VTK_DOUBLE_MAX);
+  vtkGetMacro(MemoryBudget,double);
+
+  // Description:
+  // Port to connect the rendering pipeline to
+  vtkAlgorithmOutput* GetOutputPort();
+
+  // Description:
+  // Start and stop the worker
+  void Start();
+  void Stop();
+  vtkGetMacro(Running,int);
+
+  // Description:
+  // Take in the pieces loaded since the last call, and update the
+  // requests and evictions for the channels' views with the given
+  // renderer.  Returns 1 if the output changed.  Called by the helper
+  // at the start of each frame.
+  int Update(vtkRenderer*, vtkCollection* channels);
+
+  // Description:
+  // Evict pieces not visible in the last frame until the loaded pieces
+  // fit in the given number of bytes, whatever the MemoryBudget.
+  // Returns 1 if the output changed.
+  int Trim(double bytes);
+
+  // Description:
+  // Pieces visible and loaded in the last frame, and memory in bytes
+  // held by the loaded pieces
+  vtkGetMacro(NumberOfVisiblePieces,int);
+  vtkGetMacro(NumberOfLoadedPieces,int);
+  vtkGetMacro(CurrentMemory,double);
+
+  // Description:
+  // Memory in bytes of the largest piece loaded, used to estimate the
+  // size of pieces not yet loaded.  0 until a piece is loaded, and until
+  // then only one piece is loaded at a time.
+  vtkGetMacro(LargestPieceSize,double);
+
+  // Description:
+  // Pieces loaded and evicted since starting
+  int GetNumberOfLoads();
+  vtkGetMacro(NumberOfEvictions,int);
+
+protected:
+  vtkMultiChannelStreamer();
+  ~vtkMultiChannelStreamer();
+
+  vtkAlgorithm* Pipeline;
+  int NumberOfPieces;
+  double MemoryBudget;
+
+  int Running;
+  int StopRequested;
+  int FrameNumber;
+
+  int NumberOfVisiblePieces;
+  int NumberOfLoadedPieces;
+  double CurrentMemory;
+  double LargestPieceSize;
+  int NumberOfLoads;
+  int NumberOfEvictions;
+
+  vtkTrivialProducer* Producer;
+
+  vtkMultiThreader* Threader;
+  int ThreadId;
+  vtkMutexLock* Lock;
+  vtkConditionVariable* WorkCondition;
+
+  vtkMultiChannelStreamerInternals* Internals;
+
+  // Description:
+  // Compute the bounds of the pieces of image data
+  void ComputePieceBounds();
+
+  // Description:
+  // Test the pieces against the channels' frusta
+  void UpdateVisibility(vtkRenderer*, vtkCollection* channels);
+
+  // Description:
+  // Evict pieces not visible until the loaded pieces fit in the given
+  // number of bytes.  Returns 1 if any were evicted.
+  int Evict(double bytes);
+
+  // Description:
+  // Replace the output with the loaded pieces
+  void UpdateOutput();
+
+  // Description:
+  // Worker thread entry point and loop
+  static VTK_THREAD_RETURN_TYPE WorkerMain(void*);
+  void WorkerLoop();
+
+private:
+  vtkMultiChannelStreamer(const vtkMultiChannelStreamer&);  // Not implemented.
+  void operator=(const vtkMultiChannelStreamer&);  // Not implemented.
+};
+
+#endif
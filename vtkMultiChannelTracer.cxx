@@ -0,0 +1,260 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelTracer.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelTracer.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+vtkCxxRevisionMacro(vtkMultiChannelTracer, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelTracer);
+
+// Maximum number of threads that can record
+#define VTK_MULTICHANNEL_TRACER_MAX_THREADS 64
+
+// Maximum length of an event name, including the terminator
+#define VTK_MULTICHANNEL_TRACER_NAME_LENGTH 32
+
+//----------------------------------------------------------------------------
+class vtkMultiChannelTracerInternals
+{
+public:
+  struct Event
+  {
+    char Name[VTK_MULTICHANNEL_TRACER_NAME_LENGTH];
+    char Phase;
+    double Time;
+  };
+
+  // Written only by its own thread.  Count is updated after the event
+  // is filled in, so a reader never sees a partial event.
+  struct Buffer
+  {
+    vtkMultiThreaderIDType ThreadId;
+    Event* Events;
+    int Size;
+    volatile int Count;
+    volatile int Dropped;
+  };
+
+  Buffer Buffers[VTK_MULTICHANNEL_TRACER_MAX_THREADS];
+  volatile int NumberOfBuffers;
+
+  // Only taken when a thread records for the first time
+  vtkSimpleCriticalSection Lock;
+
+  Buffer* GetBuffer(int size)
+    {
+    vtkMultiThreaderIDType id = vtkMultiThreader::GetCurrentThreadID();
+
+    int n = this->NumberOfBuffers;
+    for (int i = 0; i < n; i++)
+      {
+      if (vtkMultiThreader::ThreadsEqual(this->Buffers[i].ThreadId, id))
+        {
+        return &this->Buffers[i];
+        }
+      }
+
+    this->Lock.Lock();
+    Buffer* buffer = NULL;
+    if (this->NumberOfBuffers < VTK_MULTICHANNEL_TRACER_MAX_THREADS)
+      {
+      buffer = &this->Buffers[this->NumberOfBuffers];
+      buffer->ThreadId = id;
+      buffer->Events = new Event[size];
+      buffer->Size = size;
+      buffer->Count = 0;
+      buffer->Dropped = 0;
+      this->NumberOfBuffers++;
+      }
+    this->Lock.Unlock();
+
+    return buffer;
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkMultiChannelTracer::vtkMultiChannelTracer()
+{
+  this->Enabled = 1;
+  this->BufferSize = 65536;
+
+  this->StartTime = vtkTimerLog::GetUniversalTime();
+
+  this->Internals = new vtkMultiChannelTracerInternals;
+  this->Internals->NumberOfBuffers = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelTracer::~vtkMultiChannelTracer()
+{
+  for (int i = 0; i < this->Internals->NumberOfBuffers; i++)
+    {
+    delete [] this->Internals->Buffers[i].Events;
+    }
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelTracer::Begin(const char* name)
+{
+  this->Record(name, 'B');
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelTracer::End(const char* name)
+{
+  this->Record(name, 'E');
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelTracer::Record(const char* name, char phase)
+{
+  if (!this->Enabled)
+    {
+    return;
+    }
+
+  vtkMultiChannelTracerInternals::Buffer* buffer =
+    this->Internals->GetBuffer(this->BufferSize);
+  if (!buffer)
+    {
+    return;
+    }
+
+  if (buffer->Count >= buffer->Size)
+    {
+    buffer->Dropped++;
+    return;
+    }
+
+  vtkMultiChannelTracerInternals::Event& event = buffer->Events[buffer->Count];
+  strncpy(event.Name, name, VTK_MULTICHANNEL_TRACER_NAME_LENGTH - 1);
+  event.Name[VTK_MULTICHANNEL_TRACER_NAME_LENGTH - 1] = '\0';
+  event.Phase = phase;
+  event.Time = vtkTimerLog::GetUniversalTime();
+
+  buffer->Count++;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelTracer::Clear()
+{
+  for (int i = 0; i < this->Internals->NumberOfBuffers; i++)
+    {
+    this->Internals->Buffers[i].Count = 0;
+    this->Internals->Buffers[i].Dropped = 0;
+    }
+
+  this->StartTime = vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelTracer::WriteTraceFile(const char* fileName)
+{
+  FILE* file = fopen(fileName, "w");
+  if (!file)
+    {
+    vtkErrorMacro(<< "Could not open " << fileName << " for writing.");
+    return 0;
+    }
+
+  fprintf(file, "{\"traceEvents\":[\n");
+
+  const char* separator = "";
+  for (int i = 0; i < this->Internals->NumberOfBuffers; i++)
+    {
+    vtkMultiChannelTracerInternals::Buffer& buffer = this->Internals->Buffers[i];
+
+    // Name the thread after its slot
+    fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,"
+                  "\"args\":{\"name\":\"Thread %d\"}}", separator, i, i);
+    separator = ",\n";
+
+    int count = buffer.Count;
+    for (int j = 0; j < count; j++)
+      {
+      vtkMultiChannelTracerInternals::Event& event = buffer.Events[j];
+
+      // Names are ours, but keep the JSON valid regardless
+      char name[VTK_MULTICHANNEL_TRACER_NAME_LENGTH];
+      for (int k = 0; k < VTK_MULTICHANNEL_TRACER_NAME_LENGTH; k++)
+        {
+        char c = event.Name[k];
+        name[k] = (c == '"' || c == '\\' || (c > 0 && c < ' ')) ? '_' : c;
+        }
+
+      fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%d}",
+              separator, name, event.Phase,
+              (event.Time - this->StartTime) * 1.0e6, i);
+      }
+    }
+
+  fprintf(file, "\n]}\n");
+
+  int ok = !ferror(file);
+  fclose(file);
+
+  if (!ok)
+    {
+    vtkErrorMacro(<< "Error writing " << fileName << ".");
+    }
+
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelTracer::GetNumberOfEvents()
+{
+  int count = 0;
+  for (int i = 0; i < this->Internals->NumberOfBuffers; i++)
+    {
+    count += this->Internals->Buffers[i].Count;
+    }
+
+  return count;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelTracer::GetNumberOfDroppedEvents()
+{
+  int dropped = 0;
+  for (int i = 0; i < this->Internals->NumberOfBuffers; i++)
+    {
+    dropped += this->Internals->Buffers[i].Dropped;
+    }
+
+  return dropped;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelTracer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Enabled: " << this->Enabled << "\n";
+  os << indent << "Buffer Size: " << this->BufferSize << "\n";
+  os << indent << "Number Of Threads: " << this->Internals->NumberOfBuffers << "\n";
+  os << indent << "Number Of Events: " << this->GetNumberOfEvents() << "\n";
+  os << indent << "Number Of Dropped Events: " << this->GetNumberOfDroppedEvents() << "\n";
+}
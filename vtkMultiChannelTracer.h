@@ -0,0 +1,99 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelTracer.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelTracer
+// .SECTION Description
+// vtkMultiChannelTracer records a timeline of the multi-channel render
+// path.  When set on a vtkMultiChannelRenderWindowHelper, the helper,
+// its vtkOpenGLMultiChannelRenderers, and the window record begin and
+// end events for each frame, pipeline update, clear, channel, cull,
+// draw, read back, and swap.  WriteTraceFile() writes the events in the
+// Chrome trace event format, which can be opened in chrome://tracing or
+// Perfetto.
+//
+// Each thread records into its own fixed-size buffer without locking.
+// Events that do not fit are counted and dropped.  Clear() and
+// WriteTraceFile() should be called while no frame is being rendered.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper
+
+#ifndef __vtkMultiChannelTracer_h
+#define __vtkMultiChannelTracer_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkObject.h"
+
+class vtkMultiChannelTracerInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelTracer : public vtkObject
+{
+public:
+  static vtkMultiChannelTracer *New();
+  vtkTypeRevisionMacro(vtkMultiChannelTracer,vtkObject);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Record events only when enabled
+  vtkGetMacro(Enabled,int);
+  vtkSetMacro(Enabled,int);
+  vtkBooleanMacro(Enabled,int);
+
+  // Description:
+  // Number of events each thread can record before Clear() is called.
+  // Takes effect for threads that have not recorded yet.
+  vtkSetClampMacro(BufferSize,int,1,VTK_INT_MAX);
+  vtkGetMacro(BufferSize,int);
+
+  // Description:
+  // Record the beginning and end of a span on the calling thread.  The
+  // name is copied.
+  void Begin(const char* name);
+  void End(const char* name);
+
+  // Description:
+  // Discard all recorded events
+  void Clear();
+
+  // Description:
+  // Write the recorded events as Chrome trace event JSON.  Returns 1 on
+  // success.
+  int WriteTraceFile(const char* fileName);
+
+  // Description:
+  // Number of events recorded and dropped since the last Clear()
+  int GetNumberOfEvents();
+  int GetNumberOfDroppedEvents();
+
+protected:
+  vtkMultiChannelTracer();
+  ~vtkMultiChannelTracer();
+
+  int Enabled;
+  int BufferSize;
+
+  double StartTime;
+
+  vtkMultiChannelTracerInternals* Internals;
+
+  void Record(const char* name, char phase);
+
+private:
+  vtkMultiChannelTracer(const vtkMultiChannelTracer&);  // Not implemented.
+  void operator=(const vtkMultiChannelTracer&);  // Not implemented.
+};
+
+#endif
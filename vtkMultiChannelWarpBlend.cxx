@@ -0,0 +1,565 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelWarpBlend.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkMultiChannelWarpBlend.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimerLog.h"
+
+#include <math.h>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VTK_MULTICHANNEL_WARPBLEND_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define VTK_MULTICHANNEL_WARPBLEND_AVX2
+#include <immintrin.h>
+#endif
+
+vtkCxxRevisionMacro(vtkMultiChannelWarpBlend, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMultiChannelWarpBlend);
+
+//----------------------------------------------------------------------------
+// Fixed point warp and blend tables, one entry per output pixel.  Weights
+// are in 1/256ths.
+class vtkMultiChannelWarpBlendInternals
+{
+public:
+  std::vector<int> Index;
+  std::vector<int> Fx;
+  std::vector<int> Fy;
+  std::vector<int> Weight;
+
+  int WholeExtent[6];
+  int Width;
+  int Height;
+  int InputWidth;
+  int InputHeight;
+
+  unsigned long WarpMapTime;
+  unsigned long BlendMaskTime;
+  int HasBlendMask;
+
+  unsigned char Lut[256];
+  int LutIsIdentity;
+};
+
+//----------------------------------------------------------------------------
+// Bilinear sample, weight and store pixels [begin, end) of a row.  The
+// scalar and SIMD versions give the same results.
+static void vtkMultiChannelWarpBlendRow(vtkMultiChannelWarpBlendInternals* tables,
+                                        const unsigned char* input, int components,
+                                        int offset, int begin, int end,
+                                        unsigned char* output)
+{
+  int stride = tables->InputWidth * components;
+
+  for (int i = begin; i < end; i++)
+    {
+    int fx = tables->Fx[offset + i];
+    int fy = tables->Fy[offset + i];
+    int w = tables->Weight[offset + i];
+
+    const unsigned char* p00 = input + tables->Index[offset + i] * components;
+    const unsigned char* p01 = p00 + components;
+    const unsigned char* p10 = p00 + stride;
+    const unsigned char* p11 = p10 + components;
+
+    unsigned char* out = output + i * components;
+    for (int c = 0; c < components; c++)
+      {
+      int top = (p00[c] * (256 - fx) + p01[c] * fx) >> 8;
+      int bottom = (p10[c] * (256 - fx) + p11[c] * fx) >> 8;
+      int value = (top * (256 - fy) + bottom * fy) >> 8;
+      out[c] = static_cast<unsigned char>((value * w) >> 8);
+      }
+    }
+}
+
+#ifdef VTK_MULTICHANNEL_WARPBLEND_SSE2
+//----------------------------------------------------------------------------
+// Four RGBA pixels at a time, with the texels gathered by hand.  Returns
+// the number of pixels done.
+static int vtkMultiChannelWarpBlendRowSSE2(vtkMultiChannelWarpBlendInternals* tables,
+                                           const unsigned char* input,
+                                           int offset, int count,
+                                           unsigned char* output)
+{
+  const int* texels = reinterpret_cast<const int*>(input);
+  const int* index = &tables->Index[offset];
+  int width = tables->InputWidth;
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(256);
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4)
+    {
+    int i0 = index[i];
+    int i1 = index[i + 1];
+    int i2 = index[i + 2];
+    int i3 = index[i + 3];
+
+    __m128i t00 = _mm_set_epi32(texels[i3], texels[i2], texels[i1], texels[i0]);
+    __m128i t01 = _mm_set_epi32(texels[i3 + 1], texels[i2 + 1], texels[i1 + 1], texels[i0 + 1]);
+    __m128i t10 = _mm_set_epi32(texels[i3 + width], texels[i2 + width],
+                                texels[i1 + width], texels[i0 + width]);
+    __m128i t11 = _mm_set_epi32(texels[i3 + width + 1], texels[i2 + width + 1],
+                                texels[i1 + width + 1], texels[i0 + width + 1]);
+
+    // Spread each pixel's weights over its four 16-bit components
+    __m128i fx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tables->Fx[offset + i]));
+    __m128i fy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tables->Fy[offset + i]));
+    __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tables->Weight[offset + i]));
+    fx = _mm_or_si128(fx, _mm_slli_epi32(fx, 16));
+    fy = _mm_or_si128(fy, _mm_slli_epi32(fy, 16));
+    w = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+
+    __m128i result[2];
+    for (int half = 0; half < 2; half++)
+      {
+      __m128i a, b, c, d, wx, wy, ww;
+      if (half == 0)
+        {
+        a = _mm_unpacklo_epi8(t00, zero);
+        b = _mm_unpacklo_epi8(t01, zero);
+        c = _mm_unpacklo_epi8(t10, zero);
+        d = _mm_unpacklo_epi8(t11, zero);
+        wx = _mm_unpacklo_epi32(fx, fx);
+        wy = _mm_unpacklo_epi32(fy, fy);
+        ww = _mm_unpacklo_epi32(w, w);
+        }
+      else
+        {
+        a = _mm_unpackhi_epi8(t00, zero);
+        b = _mm_unpackhi_epi8(t01, zero);
+        c = _mm_unpackhi_epi8(t10, zero);
+        d = _mm_unpackhi_epi8(t11, zero);
+        wx = _mm_unpackhi_epi32(fx, fx);
+        wy = _mm_unpackhi_epi32(fy, fy);
+        ww = _mm_unpackhi_epi32(w, w);
+        }
+
+      __m128i rx = _mm_sub_epi16(one, wx);
+      __m128i top = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, rx), _mm_mullo_epi16(b, wx)), 8);
+      __m128i bottom = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c, rx), _mm_mullo_epi16(d, wx)), 8);
+
+      __m128i ry = _mm_sub_epi16(one, wy);
+      __m128i value = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(top, ry), _mm_mullo_epi16(bottom, wy)), 8);
+
+      result[half] = _mm_srli_epi16(_mm_mullo_epi16(value, ww), 8);
+      }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 4),
+                     _mm_packus_epi16(result[0], result[1]));
+    }
+
+  return i;
+}
+#endif
+
+#ifdef VTK_MULTICHANNEL_WARPBLEND_AVX2
+//----------------------------------------------------------------------------
+// Eight RGBA pixels at a time, with gathered texels.  The unpacks and the
+// pack work within 128-bit lanes, so pixels keep their order.  Returns the
+// number of pixels done.
+static int vtkMultiChannelWarpBlendRowAVX2(vtkMultiChannelWarpBlendInternals* tables,
+                                           const unsigned char* input,
+                                           int offset, int count,
+                                           unsigned char* output)
+{
+  const int* texels = reinterpret_cast<const int*>(input);
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi16(256);
+  const __m256i right = _mm256_set1_epi32(1);
+  const __m256i down = _mm256_set1_epi32(tables->InputWidth);
+
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+    {
+    __m256i i00 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&tables->Index[offset + i]));
+    __m256i i01 = _mm256_add_epi32(i00, right);
+    __m256i i10 = _mm256_add_epi32(i00, down);
+    __m256i i11 = _mm256_add_epi32(i10, right);
+
+    __m256i t00 = _mm256_i32gather_epi32(texels, i00, 4);
+    __m256i t01 = _mm256_i32gather_epi32(texels, i01, 4);
+    __m256i t10 = _mm256_i32gather_epi32(texels, i10, 4);
+    __m256i t11 = _mm256_i32gather_epi32(texels, i11, 4);
+
+    // Spread each pixel's weights over its four 16-bit components
+    __m256i fx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&tables->Fx[offset + i]));
+    __m256i fy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&tables->Fy[offset + i]));
+    __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&tables->Weight[offset + i]));
+    fx = _mm256_or_si256(fx, _mm256_slli_epi32(fx, 16));
+    fy = _mm256_or_si256(fy, _mm256_slli_epi32(fy, 16));
+    w = _mm256_or_si256(w, _mm256_slli_epi32(w, 16));
+
+    __m256i result[2];
+    for (int half = 0; half < 2; half++)
+      {
+      __m256i a, b, c, d, wx, wy, ww;
+      if (half == 0)
+        {
+        a = _mm256_unpacklo_epi8(t00, zero);
+        b = _mm256_unpacklo_epi8(t01, zero);
+        c = _mm256_unpacklo_epi8(t10, zero);
+        d = _mm256_unpacklo_epi8(t11, zero);
+        wx = _mm256_unpacklo_epi32(fx, fx);
+        wy = _mm256_unpacklo_epi32(fy, fy);
+        ww = _mm256_unpacklo_epi32(w, w);
+        }
+      else
+        {
+        a = _mm256_unpackhi_epi8(t00, zero);
+        b = _mm256_unpackhi_epi8(t01, zero);
+        c = _mm256_unpackhi_epi8(t10, zero);
+        d = _mm256_unpackhi_epi8(t11, zero);
+        wx = _mm256_unpackhi_epi32(fx, fx);
+        wy = _mm256_unpackhi_epi32(fy, fy);
+        ww = _mm256_unpackhi_epi32(w, w);
+        }
+
+      __m256i rx = _mm256_sub_epi16(one, wx);
+      __m256i top = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(a, rx), _mm256_mullo_epi16(b, wx)), 8);
+      __m256i bottom = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(c, rx), _mm256_mullo_epi16(d, wx)), 8);
+
+      __m256i ry = _mm256_sub_epi16(one, wy);
+      __m256i value = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(top, ry), _mm256_mullo_epi16(bottom, wy)), 8);
+
+      result[half] = _mm256_srli_epi16(_mm256_mullo_epi16(value, ww), 8);
+      }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i * 4),
+                        _mm256_packus_epi16(result[0], result[1]));
+    }
+
+  return i;
+}
+#endif
+
+//----------------------------------------------------------------------------
+vtkMultiChannelWarpBlend::vtkMultiChannelWarpBlend()
+{
+  this->SetNumberOfInputPorts(3);
+
+  this->Gamma = 1.0;
+  this->UseSIMD = 1;
+
+  this->ExecuteTime = 0;
+  this->PixelsPerSecond = 0;
+
+  this->Internals = new vtkMultiChannelWarpBlendInternals;
+  this->Internals->Width = 0;
+  this->Internals->Height = 0;
+  this->Internals->InputWidth = 0;
+  this->Internals->InputHeight = 0;
+  this->Internals->WarpMapTime = 0;
+  this->Internals->BlendMaskTime = 0;
+  this->Internals->HasBlendMask = 0;
+  this->Internals->LutIsIdentity = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelWarpBlend::~vtkMultiChannelWarpBlend()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelWarpBlend::SetWarpMapConnection(vtkAlgorithmOutput* output)
+{
+  this->SetInputConnection(1, output);
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelWarpBlend::SetBlendMaskConnection(vtkAlgorithmOutput* output)
+{
+  this->SetInputConnection(2, output);
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelWarpBlend::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (!this->Superclass::FillInputPortInformation(port, info))
+    {
+    return 0;
+    }
+
+  if (port == 2)
+    {
+    info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelWarpBlend::RequestInformation(vtkInformation*,
+                                                 vtkInformationVector** inputVector,
+                                                 vtkInformationVector* outputVector)
+{
+  vtkInformation* warpInfo = inputVector[1]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  // The output is the size of the warp map
+  int wholeExtent[6];
+  warpInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent, 6);
+  outInfo->Set(vtkDataObject::ORIGIN(), 0.0, 0.0, 0.0);
+  outInfo->Set(vtkDataObject::SPACING(), 1.0, 1.0, 1.0);
+
+  // Components are those of the channel image
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, -1);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelWarpBlend::RequestUpdateExtent(vtkInformation*,
+                                                  vtkInformationVector** inputVector,
+                                                  vtkInformationVector*)
+{
+  // The warp may sample anywhere, so all inputs are needed whole
+  for (int port = 0; port < 3; port++)
+    {
+    vtkInformation* inInfo = inputVector[port]->GetInformationObject(0);
+    if (inInfo)
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+                  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelWarpBlend::RequestData(vtkInformation* request,
+                                          vtkInformationVector** inputVector,
+                                          vtkInformationVector* outputVector)
+{
+  double start = vtkTimerLog::GetUniversalTime();
+
+  vtkImageData* input = vtkImageData::SafeDownCast(
+    inputVector[0]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData* warpMap = vtkImageData::SafeDownCast(
+    inputVector[1]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData* blendMask = NULL;
+  if (this->GetNumberOfInputConnections(2) > 0)
+    {
+    blendMask = vtkImageData::SafeDownCast(
+      inputVector[2]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+    }
+
+  if (!this->UpdateTables(input, warpMap, blendMask))
+    {
+    return 0;
+    }
+
+  // Gamma lookup table
+  vtkMultiChannelWarpBlendInternals* tables = this->Internals;
+  tables->LutIsIdentity = this->Gamma == 1.0;
+  for (int i = 0; i < 256; i++)
+    {
+    tables->Lut[i] = static_cast<unsigned char>(255.0 * pow(i / 255.0, this->Gamma) + 0.5);
+    }
+
+  int result = this->Superclass::RequestData(request, inputVector, outputVector);
+
+  this->ExecuteTime = vtkTimerLog::GetUniversalTime() - start;
+  this->PixelsPerSecond = this->ExecuteTime > 0 ?
+    static_cast<double>(tables->Width) * tables->Height / this->ExecuteTime : 0.0;
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+int vtkMultiChannelWarpBlend::UpdateTables(vtkImageData* input, vtkImageData* warpMap, vtkImageData* blendMask)
+{
+  if (!input || !warpMap)
+    {
+    vtkErrorMacro(<< "A channel image and a warp map are needed.");
+    return 0;
+    }
+
+  if (input->GetScalarType() != VTK_UNSIGNED_CHAR ||
+      input->GetNumberOfScalarComponents() < 1 ||
+      input->GetNumberOfScalarComponents() > 4)
+    {
+    vtkErrorMacro(<< "The channel image must be unsigned char with 1 to 4 components.");
+    return 0;
+    }
+
+  int* inputDimensions = input->GetDimensions();
+  if (inputDimensions[0] < 2 || inputDimensions[1] < 2)
+    {
+    vtkErrorMacro(<< "The channel image must be at least 2x2.");
+    return 0;
+    }
+
+  if (warpMap->GetScalarType() != VTK_FLOAT || warpMap->GetNumberOfScalarComponents() != 2)
+    {
+    vtkErrorMacro(<< "The warp map must be float with 2 components.");
+    return 0;
+    }
+
+  int* dimensions = warpMap->GetDimensions();
+  if (blendMask)
+    {
+    int* maskDimensions = blendMask->GetDimensions();
+    if (blendMask->GetScalarType() != VTK_UNSIGNED_CHAR ||
+        blendMask->GetNumberOfScalarComponents() != 1 ||
+        maskDimensions[0] != dimensions[0] || maskDimensions[1] != dimensions[1])
+      {
+      vtkErrorMacro(<< "The blend mask must be unsigned char with 1 component, the size of the warp map.");
+      return 0;
+      }
+    }
+
+  vtkMultiChannelWarpBlendInternals* tables = this->Internals;
+  if (tables->InputWidth == inputDimensions[0] &&
+      tables->InputHeight == inputDimensions[1] &&
+      tables->WarpMapTime == warpMap->GetMTime() &&
+      tables->HasBlendMask == (blendMask != NULL) &&
+      (!blendMask || tables->BlendMaskTime == blendMask->GetMTime()))
+    {
+    return 1;
+    }
+
+  tables->InputWidth = inputDimensions[0];
+  tables->InputHeight = inputDimensions[1];
+  tables->WarpMapTime = warpMap->GetMTime();
+  tables->HasBlendMask = blendMask != NULL;
+  tables->BlendMaskTime = blendMask ? blendMask->GetMTime() : 0;
+
+  warpMap->GetExtent(tables->WholeExtent);
+  tables->Width = dimensions[0];
+  tables->Height = dimensions[1];
+
+  int size = tables->Width * tables->Height;
+  tables->Index.resize(size);
+  tables->Fx.resize(size);
+  tables->Fy.resize(size);
+  tables->Weight.resize(size);
+
+  const float* warp = static_cast<const float*>(warpMap->GetScalarPointer());
+  const unsigned char* mask = blendMask ?
+    static_cast<const unsigned char*>(blendMask->GetScalarPointer()) : NULL;
+
+  double maxX = tables->InputWidth - 1;
+  double maxY = tables->InputHeight - 1;
+
+  for (int i = 0; i < size; i++)
+    {
+    double x = warp[2 * i] * maxX;
+    double y = warp[2 * i + 1] * maxY;
+
+    // Half a pixel past the outer pixel centers is still in the image
+    int inside = x >= -0.5 && x <= maxX + 0.5 && y >= -0.5 && y <= maxY + 0.5;
+
+    x = x < 0 ? 0 : (x > maxX ? maxX : x);
+    y = y < 0 ? 0 : (y > maxY ? maxY : y);
+
+    // Keep the texel to the right and above inside the image
+    int x0 = static_cast<int>(x);
+    int y0 = static_cast<int>(y);
+    x0 = x0 > tables->InputWidth - 2 ? tables->InputWidth - 2 : x0;
+    y0 = y0 > tables->InputHeight - 2 ? tables->InputHeight - 2 : y0;
+
+    tables->Index[i] = y0 * tables->InputWidth + x0;
+    tables->Fx[i] = static_cast<int>((x - x0) * 256.0 + 0.5);
+    tables->Fy[i] = static_cast<int>((y - y0) * 256.0 + 0.5);
+
+    int weight = 256;
+    if (mask)
+      {
+      weight = mask[i] + (mask[i] >> 7);
+      }
+    tables->Weight[i] = inside ? weight : 0;
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelWarpBlend::ThreadedRequestData(vtkInformation*,
+                                                   vtkInformationVector**,
+                                                   vtkInformationVector*,
+                                                   vtkImageData*** inData,
+                                                   vtkImageData** outData,
+                                                   int extent[6], int)
+{
+  vtkMultiChannelWarpBlendInternals* tables = this->Internals;
+
+  vtkImageData* input = inData[0][0];
+  vtkImageData* output = outData[0];
+
+  const unsigned char* source = static_cast<const unsigned char*>(input->GetScalarPointer());
+  int components = input->GetNumberOfScalarComponents();
+  int count = extent[1] - extent[0] + 1;
+
+  for (int y = extent[2]; y <= extent[3]; y++)
+    {
+    unsigned char* row = static_cast<unsigned char*>(output->GetScalarPointer(extent[0], y, extent[4]));
+    int offset = (y - tables->WholeExtent[2]) * tables->Width + extent[0] - tables->WholeExtent[0];
+
+    int done = 0;
+    if (this->UseSIMD && components == 4)
+      {
+#if defined(VTK_MULTICHANNEL_WARPBLEND_AVX2)
+      done = vtkMultiChannelWarpBlendRowAVX2(tables, source, offset, count, row);
+#elif defined(VTK_MULTICHANNEL_WARPBLEND_SSE2)
+      done = vtkMultiChannelWarpBlendRowSSE2(tables, source, offset, count, row);
+#endif
+      }
+    vtkMultiChannelWarpBlendRow(tables, source, components, offset, done, count, row);
+
+    // Gamma, leaving alpha alone
+    if (!tables->LutIsIdentity)
+      {
+      int colors = components == 2 || components == 4 ? components - 1 : components;
+      for (int i = 0; i < count; i++)
+        {
+        unsigned char* pixel = row + i * components;
+        for (int c = 0; c < colors; c++)
+          {
+          pixel[c] = tables->Lut[pixel[c]];
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMultiChannelWarpBlend::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Gamma: " << this->Gamma << "\n";
+  os << indent << "Use SIMD: " << this->UseSIMD << "\n";
+  os << indent << "Execute Time: " << this->ExecuteTime << "\n";
+  os << indent << "Pixels Per Second: " << this->PixelsPerSecond << "\n";
+}
@@ -0,0 +1,108 @@
+/*=========================================================================
+
+  Name:        vtkMultiChannelWarpBlend.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkMultiChannelWarpBlend
+// .SECTION Description
+// vtkMultiChannelWarpBlend warps and edge blends a channel image on the
+// CPU, for projectors driven by nodes without a GPU.  Input 0 is the
+// channel image, of unsigned char with 1 to 4 components.  The warp
+// map, connected with SetWarpMapConnection(), is a 2-component float
+// image the size of the output.  Each of its pixels gives the point in
+// the channel image to sample, with (0,0) the center of the lower left
+// pixel and (1,1) the center of the upper right.  Points outside the
+// image are black.  The optional blend mask, connected with
+// SetBlendMaskConnection(), is a 1-component unsigned char image the
+// size of the output that the sampled colors are scaled by.  Last, the
+// colors are passed through a lookup table for the given Gamma.
+//
+// The warp map and blend mask are converted to fixed point once, and
+// again only when they change.  Sampling is bilinear in fixed point,
+// using SSE2 for 4-component images, or AVX2 if the library is built
+// with vtkMultiChannel_ENABLE_AVX2.  Rows are split across threads.
+//
+// The time taken by the last execution and the resulting throughput are
+// kept for benchmarking.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowManager
+
+#ifndef __vtkMultiChannelWarpBlend_h
+#define __vtkMultiChannelWarpBlend_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkThreadedImageAlgorithm.h"
+
+class vtkMultiChannelWarpBlendInternals;
+
+class VTK_MULTICHANNEL_EXPORT vtkMultiChannelWarpBlend : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkMultiChannelWarpBlend *New();
+  vtkTypeRevisionMacro(vtkMultiChannelWarpBlend,vtkThreadedImageAlgorithm);
+  void PrintSelf(ostream&, vtkIndent);
+
+  // Description:
+  // Warp map and optional blend mask
+  void SetWarpMapConnection(vtkAlgorithmOutput*);
+  void SetBlendMaskConnection(vtkAlgorithmOutput*);
+
+  // Description:
+  // Exponent applied to the output colors
+  vtkSetClampMacro(Gamma,double,0.01,100.0);
+  vtkGetMacro(Gamma,double);
+
+  // Description:
+  // Use SIMD instructions when possible.  On by default.
+  vtkGetMacro(UseSIMD,int);
+  vtkSetMacro(UseSIMD,int);
+  vtkBooleanMacro(UseSIMD,int);
+
+  // Description:
+  // Seconds taken by the last execution, and output pixels per second
+  vtkGetMacro(ExecuteTime,double);
+  vtkGetMacro(PixelsPerSecond,double);
+
+protected:
+  vtkMultiChannelWarpBlend();
+  ~vtkMultiChannelWarpBlend();
+
+  double Gamma;
+  int UseSIMD;
+
+  double ExecuteTime;
+  double PixelsPerSecond;
+
+  vtkMultiChannelWarpBlendInternals* Internals;
+
+  virtual int FillInputPortInformation(int, vtkInformation*);
+  virtual int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+  virtual int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
+  virtual void ThreadedRequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*,
+                                   vtkImageData***, vtkImageData**, int extent[6], int threadId);
+
+  // Description:
+  // Convert the warp map and blend mask to fixed point for the given
+  // input size if they changed
+  int UpdateTables(vtkImageData* input, vtkImageData* warpMap, vtkImageData* blendMask);
+
+private:
+  vtkMultiChannelWarpBlend(const vtkMultiChannelWarpBlend&);  // Not implemented.
+  void operator=(const vtkMultiChannelWarpBlend&);  // Not implemented.
+};
+
+#endif
@@ -18,10 +18,12 @@
 
 #include "vtkgluPickMatrix.h"
 #include "vtkMatrix4x4.h"
+#include "vtkMultiChannelGLStateCache.h"
 #include "vtkObjectFactory.h"
 #include "vtkOpenGLRenderer.h"
 #include "vtkOpenGLRenderWindow.h"
 #include "vtkOpenGL.h"
+#include "vtkWin32OpenGLMultiChannelRenderWindow.h"
 
 #ifndef VTK_IMPLEMENT_MESA_CXX
 vtkCxxRevisionMacro(vtkOpenGLMultiChannelCamera, "$Revision: 1.0 $");
@@ -40,18 +42,39 @@ vtkOpenGLMultiChannelCamera::~vtkOpenGLMultiChannelCamera()
 {
 }
 
+//----------------------------------------------------------------------------
+// Set buffers through the window's state cache when it has one
+static void vtkOpenGLMultiChannelCameraSetBuffers(vtkMultiChannelGLStateCache* cache,
+                                                  unsigned int buffer)
+{
+  if (cache)
+    {
+    cache->DrawBuffer(buffer);
+    cache->ReadBuffer(buffer);
+    }
+  else
+    {
+    glDrawBuffer(static_cast<GLenum>(buffer));
+    glReadBuffer(static_cast<GLenum>(buffer));
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkOpenGLMultiChannelCamera::Render(vtkRenderer *ren)
 {
-  if (!this->UseAspectRatio)
+  vtkWin32OpenGLMultiChannelRenderWindow* multiChannelWindow = 
+    vtkWin32OpenGLMultiChannelRenderWindow::SafeDownCast(ren->GetRenderWindow());
+  vtkMultiChannelGLStateCache* cache = multiChannelWindow ? multiChannelWindow->GetGLStateCache() : NULL;
+
+  if (!this->UseAspectRatio && !cache)
     {
     // Render as usual
     vtkOpenGLCamera::Render(ren);
     return;
     }
 
-  // Render with the camera's aspect ratio, 
-  // borrowing heavily from vtkOpenGLCamera::Render()
+  // Render with the camera's aspect ratio if set, and the window's state
+  // cache if it has one, borrowing heavily from vtkOpenGLCamera::Render()
   int lowerLeft[2];
   int usize, vsize;
   vtkMatrix4x4 *matrix = vtkMatrix4x4::New();
@@ -72,26 +95,22 @@ void vtkOpenGLMultiChannelCamera::Render(vtkRenderer *ren)
           {
           if(ren->GetRenderWindow()->GetDoubleBuffer())
             {
-            glDrawBuffer(static_cast<GLenum>(win->GetBackLeftBuffer()));
-            glReadBuffer(static_cast<GLenum>(win->GetBackLeftBuffer()));
+            vtkOpenGLMultiChannelCameraSetBuffers(cache, win->GetBackLeftBuffer());
             }
           else
             {
-            glDrawBuffer(static_cast<GLenum>(win->GetFrontLeftBuffer()));
-            glReadBuffer(static_cast<GLenum>(win->GetFrontLeftBuffer()));
+            vtkOpenGLMultiChannelCameraSetBuffers(cache, win->GetFrontLeftBuffer());
             }
           }
         else
           {
            if(ren->GetRenderWindow()->GetDoubleBuffer())
             {
-            glDrawBuffer(static_cast<GLenum>(win->GetBackRightBuffer()));
-            glReadBuffer(static_cast<GLenum>(win->GetBackRightBuffer()));
+            vtkOpenGLMultiChannelCameraSetBuffers(cache, win->GetBackRightBuffer());
             }
           else
             {
-            glDrawBuffer(static_cast<GLenum>(win->GetFrontRightBuffer()));
-            glReadBuffer(static_cast<GLenum>(win->GetFrontRightBuffer()));
+            vtkOpenGLMultiChannelCameraSetBuffers(cache, win->GetFrontRightBuffer());
             }
           }
         break;
@@ -109,34 +128,51 @@ void vtkOpenGLMultiChannelCamera::Render(vtkRenderer *ren)
     {
     if (ren->GetRenderWindow()->GetDoubleBuffer())
       {
-      glDrawBuffer(static_cast<GLenum>(win->GetBackBuffer()));
-      
       // Reading back buffer means back left. see OpenGL spec.
       // because one can write to two buffers at a time but can only read from
       // one buffer at a time.
-      glReadBuffer(static_cast<GLenum>(win->GetBackBuffer()));
+      vtkOpenGLMultiChannelCameraSetBuffers(cache, win->GetBackBuffer());
       }
     else
       {
-      glDrawBuffer(static_cast<GLenum>(win->GetFrontBuffer()));
-      
       // Reading front buffer means front left. see OpenGL spec.
       // because one can write to two buffers at a time but can only read from
       // one buffer at a time.
-      glReadBuffer(static_cast<GLenum>(win->GetFrontBuffer()));
+      vtkOpenGLMultiChannelCameraSetBuffers(cache, win->GetFrontBuffer());
       }
     }
   
-  glViewport(lowerLeft[0], lowerLeft[1], usize, vsize);
-  glEnable(GL_SCISSOR_TEST);
-  glScissor(lowerLeft[0], lowerLeft[1], usize, vsize);
+  if (cache)
+    {
+    cache->Viewport(lowerLeft[0], lowerLeft[1], usize, vsize);
+    cache->Enable(GL_SCISSOR_TEST);
+    cache->Scissor(lowerLeft[0], lowerLeft[1], usize, vsize);
+    }
+  else
+    {
+    glViewport(lowerLeft[0], lowerLeft[1], usize, vsize);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(lowerLeft[0], lowerLeft[1], usize, vsize);
+    }
   
   glMatrixMode(GL_PROJECTION);
   if(usize && vsize)
     {
-    // Use the user-supplied aspect ratio
+    double aspectRatio = this->AspectRatio;
+    if (!this->UseAspectRatio)
+      {
+      // The renderer's aspect ratio, corrected for its pixel aspect
+      double aspect[2];
+      ren->ComputeAspect();
+      ren->GetAspect(aspect);
+      double aspect2[2];
+      ren->vtkViewport::ComputeAspect();
+      ren->vtkViewport::GetAspect(aspect2);
+      aspectRatio = aspect[0] * aspect2[1] / (aspect[1] * aspect2[0]) * usize / vsize;
+      }
+
     matrix->DeepCopy(this->GetProjectionTransformMatrix(
-                     this->AspectRatio, -1, 1));
+                     aspectRatio, -1, 1));
     matrix->Transpose();
     }
 
@@ -16,7 +16,10 @@
 // .NAME vtkOpenGLMultiChannelCamera
 // .SECTION Description
 // vtkOpenGLMultiChannelCamera adds support for an aspect ratio that
-// does not match the aspect ratio of the renderer being used.
+// does not match the aspect ratio of the renderer being used.  In a
+// vtkWin32OpenGLMultiChannelRenderWindow, the buffers, viewport and
+// scissor box are set through the window's vtkMultiChannelGLStateCache,
+// so that channels with the same settings do not set them again.
 
 // .SECTION see also
 // vtkRenderWindowChannel vtkMultiChannelRenderWindowManger 
@@ -48,7 +51,8 @@ public:
   vtkBooleanMacro(UseAspectRatio,int);
 
   // Description:
-  // Renders with the supplied aspect ratio if requested
+  // Renders with the supplied aspect ratio if requested, and through the
+  // window's state cache if it has one
   void Render(vtkRenderer*);
 
 protected:
@@ -0,0 +1,577 @@
+/*=========================================================================
+
+  Name:        vtkOpenGLMultiChannelRenderer.cxx
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+
+#include "vtkOpenGLMultiChannelRenderer.h"
+
+#include "vtkCameraPass.h"
+#include "vtkCommand.h"
+#include "vtkCuller.h"
+#include "vtkCullerCollection.h"
+#include "vtkLight.h"
+#include "vtkLightCollection.h"
+#include "vtkMultiChannelGeometryCache.h"
+#include "vtkMultiChannelOcclusionCuller.h"
+#include "vtkMultiChannelTracer.h"
+#include "vtkObjectFactory.h"
+#include "vtkOpenGL.h"
+#include "vtkOpenGLRenderWindow.h"
+#include "vtkPropCollection.h"
+#include "vtkRenderPassCollection.h"
+#include "vtkRenderState.h"
+#include "vtkSequencePass.h"
+#include "vtkShadowMapBakerPass.h"
+#include "vtkTimerLog.h"
+
+#include <vector>
+
+vtkCxxRevisionMacro(vtkOpenGLMultiChannelRenderer, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkOpenGLMultiChannelRenderer);
+
+vtkCxxSetObjectMacro(vtkOpenGLMultiChannelRenderer, Tracer, vtkMultiChannelTracer);
+
+//----------------------------------------------------------------------------
+class vtkOpenGLMultiChannelRendererInternals
+{
+public:
+  // A sequence with shared passes taken out, and all of its passes
+  struct Sequence
+  {
+    vtkRenderPassCollection* Passes;
+    std::vector<vtkRenderPass*> Items;
+  };
+
+  std::vector<Sequence> Sequences;
+
+  // Shared passes found in the renderer's pass
+  std::vector<vtkRenderPass*> DetectedPasses;
+};
+
+//----------------------------------------------------------------------------
+vtkOpenGLMultiChannelRenderer::vtkOpenGLMultiChannelRenderer()
+{
+  this->InFrame = 0;
+  this->ClearOncePerFrame = 1;
+  this->FrameCleared = 0;
+
+  this->FrameStartTime = 0;
+
+  this->FrameProps = NULL;
+  this->FramePropCount = 0;
+
+  this->GeometryCache = vtkMultiChannelGeometryCache::New();
+
+  this->Tracer = NULL;
+
+  this->SharedPasses = vtkRenderPassCollection::New();
+  this->DetectSharedPasses = 1;
+  this->NumberOfSharedPassesRun = 0;
+  this->SharedPassTime = 0;
+
+  this->OcclusionCuller = NULL;
+
+  this->Internals = new vtkOpenGLMultiChannelRendererInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkOpenGLMultiChannelRenderer::~vtkOpenGLMultiChannelRenderer()
+{
+  if (this->InFrame)
+    {
+    this->EndFrame();
+    }
+
+  this->GeometryCache->Delete();
+
+  this->SetTracer(NULL);
+
+  this->SharedPasses->Delete();
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::BeginFrame()
+{
+  if (this->InFrame || !this->Draw || !this->RenderWindow)
+    {
+    return;
+    }
+
+  this->FrameStartTime = vtkTimerLog::GetUniversalTime();
+  this->InvokeEvent(vtkCommand::StartEvent, NULL);
+
+  // Make sure there is a camera and a light, so that channels don't
+  // create them
+  this->GetActiveCamera();
+
+  int lightsOn = 0;
+  vtkCollectionSimpleIterator lit;
+  vtkLight* light;
+  for (this->Lights->InitTraversal(lit); (light = this->Lights->GetNextItem(lit)); )
+    {
+    lightsOn += light->GetSwitch();
+    }
+  if (!lightsOn && this->AutomaticLightCreation)
+    {
+    this->CreateLight();
+    }
+
+  // Build the visible prop list once
+  int numProps = this->Props->GetNumberOfItems();
+  this->FrameProps = new vtkProp*[numProps > 0 ? numProps : 1];
+  this->PropArray = new vtkProp*[numProps > 0 ? numProps : 1];
+  this->FramePropCount = 0;
+  this->PropArrayCount = 0;
+
+  vtkCollectionSimpleIterator pit;
+  vtkProp* prop;
+  for (this->Props->InitTraversal(pit); (prop = this->Props->GetNextProp(pit)); )
+    {
+    if (prop->GetVisibility())
+      {
+      this->FrameProps[this->FramePropCount++] = prop;
+      }
+    }
+
+  // Bring the pipelines of visible props up to date here, so that the
+  // channels reuse the same geometry
+  if (this->Tracer)
+    {
+    this->Tracer->Begin("Pipeline Update");
+    }
+  this->GeometryCache->BeginFrame(this->FrameProps, this->FramePropCount);
+  if (this->Tracer)
+    {
+    this->Tracer->End("Pipeline Update");
+    }
+
+  // View-independent passes see every visible prop, and run once
+  if (this->DetectSharedPasses && this->Pass)
+    {
+    this->FindSharedPasses(this->Pass);
+    }
+  this->RenderSharedPasses(this->FrameProps, this->FramePropCount);
+
+  // Test the frame's props against the depth of every channel at once
+  this->OcclusionCuller = NULL;
+  vtkCollectionSimpleIterator cit;
+  vtkCuller* culler;
+  for (this->Cullers->InitTraversal(cit); (culler = this->Cullers->GetNextCuller(cit)); )
+    {
+    if (vtkMultiChannelOcclusionCuller::SafeDownCast(culler))
+      {
+      this->OcclusionCuller = vtkMultiChannelOcclusionCuller::SafeDownCast(culler);
+      break;
+      }
+    }
+  if (this->OcclusionCuller)
+    {
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Occlusion Test");
+      }
+    this->OcclusionCuller->BeginFrame(this->FrameProps, this->FramePropCount);
+    if (this->Tracer)
+      {
+      this->Tracer->End("Occlusion Test");
+      }
+    }
+
+  this->FrameCleared = 0;
+  if (this->ClearOncePerFrame)
+    {
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Clear");
+      }
+    this->ClearFrame();
+    if (this->Tracer)
+      {
+      this->Tracer->End("Clear");
+      }
+    }
+
+  this->InFrame = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::AddSharedPass(vtkRenderPass* pass)
+{
+  if (pass && !this->SharedPasses->IsItemPresent(pass))
+    {
+    this->SharedPasses->AddItem(pass);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::RemoveSharedPass(vtkRenderPass* pass)
+{
+  if (pass && this->SharedPasses->IsItemPresent(pass))
+    {
+    this->SharedPasses->RemoveItem(pass);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::RemoveAllSharedPasses()
+{
+  if (this->SharedPasses->GetNumberOfItems() > 0)
+    {
+    this->SharedPasses->RemoveAllItems();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::FindSharedPasses(vtkRenderPass* pass)
+{
+  vtkCameraPass* cameraPass = vtkCameraPass::SafeDownCast(pass);
+  if (cameraPass)
+    {
+    if (cameraPass->GetDelegatePass())
+      {
+      this->FindSharedPasses(cameraPass->GetDelegatePass());
+      }
+    return;
+    }
+
+  vtkSequencePass* sequencePass = vtkSequencePass::SafeDownCast(pass);
+  if (!sequencePass || !sequencePass->GetPasses())
+    {
+    return;
+    }
+
+  vtkOpenGLMultiChannelRendererInternals* internals = this->Internals;
+
+  vtkOpenGLMultiChannelRendererInternals::Sequence sequence;
+  sequence.Passes = sequencePass->GetPasses();
+
+  int found = 0;
+  vtkCollectionSimpleIterator it;
+  vtkRenderPass* item;
+  for (sequence.Passes->InitTraversal(it); (item = sequence.Passes->GetNextRenderPass(it)); )
+    {
+    sequence.Items.push_back(item);
+    vtkShadowMapBakerPass* baker = vtkShadowMapBakerPass::SafeDownCast(item);
+    if (baker && !this->HasCameraShadowLight(baker))
+      {
+      internals->DetectedPasses.push_back(item);
+      found = 1;
+      }
+    else
+      {
+      this->FindSharedPasses(item);
+      }
+    }
+
+  if (!found)
+    {
+    return;
+    }
+
+  // Keep every pass alive while the sequence holds only some of them
+  sequence.Passes->Register(this);
+  sequence.Passes->RemoveAllItems();
+  for (unsigned int i = 0; i < sequence.Items.size(); i++)
+    {
+    sequence.Items[i]->Register(this);
+    if (!vtkShadowMapBakerPass::SafeDownCast(sequence.Items[i]))
+      {
+      sequence.Passes->AddItem(sequence.Items[i]);
+      }
+    }
+
+  internals->Sequences.push_back(sequence);
+}
+
+//----------------------------------------------------------------------------
+int vtkOpenGLMultiChannelRenderer::HasCameraShadowLight(vtkShadowMapBakerPass* baker)
+{
+  vtkCollectionSimpleIterator it;
+  vtkLight* light;
+  for (this->Lights->InitTraversal(it); (light = this->Lights->GetNextItem(it)); )
+    {
+    if (light->GetSwitch() && light->LightTypeIsCameraLight() &&
+        baker->LightCreatesShadow(light))
+      {
+      return 1;
+      }
+    }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::RestoreSharedPasses()
+{
+  vtkOpenGLMultiChannelRendererInternals* internals = this->Internals;
+
+  for (unsigned int i = 0; i < internals->Sequences.size(); i++)
+    {
+    vtkOpenGLMultiChannelRendererInternals::Sequence& sequence = internals->Sequences[i];
+
+    sequence.Passes->RemoveAllItems();
+    for (unsigned int j = 0; j < sequence.Items.size(); j++)
+      {
+      sequence.Passes->AddItem(sequence.Items[j]);
+      sequence.Items[j]->UnRegister(this);
+      }
+    sequence.Passes->UnRegister(this);
+    }
+
+  internals->Sequences.clear();
+  internals->DetectedPasses.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::RenderSharedPasses(vtkProp** props, int numProps)
+{
+  vtkOpenGLMultiChannelRendererInternals* internals = this->Internals;
+
+  this->NumberOfSharedPassesRun = 0;
+  this->SharedPassTime = 0;
+
+  if (this->SharedPasses->GetNumberOfItems() == 0 && internals->DetectedPasses.empty())
+    {
+    return;
+    }
+
+  if (this->Tracer)
+    {
+    this->Tracer->Begin("Shared Passes");
+    }
+  double startTime = vtkTimerLog::GetUniversalTime();
+
+  vtkRenderState state(this);
+  state.SetPropArrayAndCount(props, numProps);
+  state.SetFrameBuffer(NULL);
+
+  vtkCollectionSimpleIterator it;
+  vtkRenderPass* pass;
+  for (this->SharedPasses->InitTraversal(it); (pass = this->SharedPasses->GetNextRenderPass(it)); )
+    {
+    pass->Render(&state);
+    this->NumberOfSharedPassesRun++;
+    }
+  for (unsigned int i = 0; i < internals->DetectedPasses.size(); i++)
+    {
+    internals->DetectedPasses[i]->Render(&state);
+    this->NumberOfSharedPassesRun++;
+    }
+
+  this->SharedPassTime = vtkTimerLog::GetUniversalTime() - startTime;
+  if (this->Tracer)
+    {
+    this->Tracer->End("Shared Passes");
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::ClearFrame()
+{
+  // Only a full-window background renderer can clear the whole window
+  if (this->Layer != 0 || this->GradientBackground || this->IsPicking ||
+      !this->Erase || !this->RenderWindow->GetErase() ||
+      this->RenderWindow->GetStereoRender())
+    {
+    return;
+    }
+
+  double* vp = this->Viewport;
+  if (vp[0] != 0.0 || vp[1] != 0.0 || vp[2] != 1.0 || vp[3] != 1.0)
+    {
+    return;
+    }
+
+  vtkOpenGLRenderWindow* win = vtkOpenGLRenderWindow::SafeDownCast(this->RenderWindow);
+  if (!win)
+    {
+    return;
+    }
+
+  int* size = win->GetSize();
+  win->MakeCurrent();
+  if (win->GetDoubleBuffer())
+    {
+    glDrawBuffer(static_cast<GLenum>(win->GetBackBuffer()));
+    }
+  else
+    {
+    glDrawBuffer(static_cast<GLenum>(win->GetFrontBuffer()));
+    }
+  glViewport(0, 0, size[0], size[1]);
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(0, 0, size[0], size[1]);
+
+  this->Superclass::Clear();
+  this->FrameCleared = 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::Render()
+{
+  if (!this->InFrame)
+    {
+    // Added passes are not part of the renderer's pass, so run them
+    // with the visible props first
+    if (this->Draw && this->SharedPasses->GetNumberOfItems() > 0)
+      {
+      int numProps = this->Props->GetNumberOfItems();
+      vtkProp** props = new vtkProp*[numProps > 0 ? numProps : 1];
+      int count = 0;
+
+      vtkCollectionSimpleIterator pit;
+      vtkProp* prop;
+      for (this->Props->InitTraversal(pit); (prop = this->Props->GetNextProp(pit)); )
+        {
+        if (prop->GetVisibility())
+          {
+          props[count++] = prop;
+          }
+        }
+
+      this->RenderSharedPasses(props, count);
+
+      delete [] props;
+      }
+
+    this->Superclass::Render();
+    return;
+    }
+
+  // Culling and level-of-detail depend on the channel's view, so restore
+  // the frame's prop list and allocate time again
+  for (int i = 0; i < this->FramePropCount; i++)
+    {
+    this->PropArray[i] = this->FrameProps[i];
+    }
+  this->PropArrayCount = this->FramePropCount;
+
+  if (this->Tracer)
+    {
+    this->Tracer->Begin("Cull");
+    }
+  if (this->PropArrayCount > 0)
+    {
+    this->AllocateTime();
+    }
+  if (this->Tracer)
+    {
+    this->Tracer->End("Cull");
+    this->Tracer->Begin("Draw");
+    }
+
+  // Camera, light geometry, and draw
+  this->DeviceRender();
+  this->GeometryCache->EndChannel(this->PropArray, this->PropArrayCount,
+                                  this->RenderWindow);
+
+  if (this->Tracer)
+    {
+    this->Tracer->End("Draw");
+    }
+
+  if (this->OcclusionCuller)
+    {
+    if (this->Tracer)
+      {
+      this->Tracer->Begin("Read Depth");
+      }
+    this->OcclusionCuller->EndChannel(this);
+    if (this->Tracer)
+      {
+      this->Tracer->End("Read Depth");
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::Clear()
+{
+  if (this->InFrame && this->FrameCleared)
+    {
+    return;
+    }
+
+  this->Superclass::Clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::EndFrame()
+{
+  if (!this->InFrame)
+    {
+    return;
+    }
+
+  delete [] this->PropArray;
+  this->PropArray = NULL;
+  this->PropArrayCount = 0;
+
+  delete [] this->FrameProps;
+  this->FrameProps = NULL;
+  this->FramePropCount = 0;
+
+  this->GeometryCache->EndFrame();
+
+  this->RestoreSharedPasses();
+
+  if (this->OcclusionCuller)
+    {
+    this->OcclusionCuller->EndFrame();
+    this->OcclusionCuller = NULL;
+    }
+
+  this->InFrame = 0;
+  this->FrameCleared = 0;
+
+  this->LastRenderTimeInSeconds = vtkTimerLog::GetUniversalTime() - this->FrameStartTime;
+  this->RenderTime.Modified();
+
+  this->InvokeEvent(vtkCommand::EndEvent, NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::ReleaseGraphicsResources(vtkWindow* w)
+{
+  this->Superclass::ReleaseGraphicsResources(w);
+
+  vtkCollectionSimpleIterator it;
+  vtkRenderPass* pass;
+  for (this->SharedPasses->InitTraversal(it); (pass = this->SharedPasses->GetNextRenderPass(it)); )
+    {
+    pass->ReleaseGraphicsResources(w);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkOpenGLMultiChannelRenderer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Clear Once Per Frame: " << this->ClearOncePerFrame << "\n";
+  os << indent << "In Frame: " << this->InFrame << "\n";
+  os << indent << "Tracer: " << this->Tracer << "\n";
+  os << indent << "Detect Shared Passes: " << this->DetectSharedPasses << "\n";
+  os << indent << "Number Of Shared Passes Run: " << this->NumberOfSharedPassesRun << "\n";
+  os << indent << "Shared Pass Time: " << this->SharedPassTime << "\n";
+  os << indent << "Shared Passes:\n";
+  this->SharedPasses->PrintSelf(os,indent.GetNextIndent());
+  os << indent << "Geometry Cache:\n";
+  this->GeometryCache->PrintSelf(os,indent.GetNextIndent());
+}
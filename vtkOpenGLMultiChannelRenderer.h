@@ -0,0 +1,181 @@
+/*=========================================================================
+
+  Name:        vtkOpenGLMultiChannelRenderer.h
+
+  Author:      David Borland, The Renaissance Computing Institute (RENCI)
+
+  Copyright:   The Renaissance Computing Institute (RENCI)
+
+  License:     Licensed under the RENCI Open Source Software License v. 1.0.
+
+               See included License.txt or
+               http://www.renci.org/resources/open-source-software-license
+               for details.
+
+=========================================================================*/
+// .NAME vtkOpenGLMultiChannelRenderer
+// .SECTION Description
+// vtkOpenGLMultiChannelRenderer is a subclass of vtkOpenGLRenderer that
+// splits rendering into a per-frame phase and a per-channel phase.
+// vtkMultiChannelRenderWindowHelper calls BeginFrame() once before the
+// channels are rendered, which builds the visible prop list, brings
+// the pipelines of visible props up to date through its
+// vtkMultiChannelGeometryCache, sets up lights, starts the frame
+// timing, runs the shared passes, and optionally clears the whole
+// window.  Each call to Render() between BeginFrame() and EndFrame()
+// then only culls against the channel's view and draws.  Outside of a
+// frame, Render() behaves as usual.
+//
+// Shared passes are view-independent render passes, such as shadow map
+// bakers, whose outputs every channel can use as they are.  They are
+// run once per frame with all visible props, instead of once for each
+// channel with the props the channel can see.  Passes can be added
+// explicitly.  If DetectSharedPasses is on, vtkShadowMapBakerPasses in
+// the sequence and camera passes of the renderer's pass are also run
+// as shared passes, and left out of its sequences until EndFrame().  A
+// baker is not shared while one of the renderer's camera lights casts
+// shadows, as the light moves with each channel's camera.
+//
+// A vtkMultiChannelOcclusionCuller added with AddCuller() is given the
+// frame's props in BeginFrame(), and reads back the depth of each
+// channel once it is drawn.
+
+// .SECTION see also
+// vtkMultiChannelRenderWindowHelper vtkRenderWindowChannel
+// vtkOpenGLMultiChannelCamera vtkMultiChannelGeometryCache
+
+#ifndef __vtkOpenGLMultiChannelRenderer_h
+#define __vtkOpenGLMultiChannelRenderer_h
+
+#include "vtkMultiChannelConfigure.h"
+
+#include "vtkOpenGLRenderer.h"
+
+class vtkMultiChannelGeometryCache;
+class vtkMultiChannelOcclusionCuller;
+class vtkMultiChannelTracer;
+class vtkOpenGLMultiChannelRendererInternals;
+class vtkRenderPass;
+class vtkRenderPassCollection;
+class vtkShadowMapBakerPass;
+
+class VTK_MULTICHANNEL_EXPORT vtkOpenGLMultiChannelRenderer : public vtkOpenGLRenderer
+{
+public:
+  static vtkOpenGLMultiChannelRenderer *New();
+  vtkTypeRevisionMacro(vtkOpenGLMultiChannelRenderer,vtkOpenGLRenderer);
+  virtual void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Perform the view-independent part of rendering for a frame
+  void BeginFrame();
+
+  // Description:
+  // Finish the frame started by BeginFrame()
+  void EndFrame();
+
+  // Description:
+  // Inside a frame, cull and draw for the current channel only.
+  // Otherwise render as usual.
+  void Render();
+
+  // Description:
+  // Skipped inside a frame if the window was already cleared
+  void Clear();
+
+  // Description:
+  // Clear the whole window once in BeginFrame() rather than once per
+  // channel.  Only used for a layer 0 renderer without a gradient
+  // background on a window without stereo.
+  vtkGetMacro(ClearOncePerFrame,int);
+  vtkSetMacro(ClearOncePerFrame,int);
+  vtkBooleanMacro(ClearOncePerFrame,int);
+
+  // Description:
+  // Add and remove view-independent passes to run once per frame
+  void AddSharedPass(vtkRenderPass*);
+  void RemoveSharedPass(vtkRenderPass*);
+  void RemoveAllSharedPasses();
+  vtkGetObjectMacro(SharedPasses,vtkRenderPassCollection);
+
+  // Description:
+  // Also run shadow map bakers found in the renderer's pass as shared
+  // passes
+  vtkGetMacro(DetectSharedPasses,int);
+  vtkSetMacro(DetectSharedPasses,int);
+  vtkBooleanMacro(DetectSharedPasses,int);
+
+  // Description:
+  // Number of shared passes run in the last frame, and the time taken
+  vtkGetMacro(NumberOfSharedPassesRun,int);
+  vtkGetMacro(SharedPassTime,double);
+
+  // Description:
+  // Also releases the shared passes' resources
+  void ReleaseGraphicsResources(vtkWindow*);
+
+  // Description:
+  // Returns 1 between BeginFrame() and EndFrame()
+  vtkGetMacro(InFrame,int);
+
+  // Description:
+  // Keeps geometry built once per frame and counts invalidations
+  vtkGetObjectMacro(GeometryCache,vtkMultiChannelGeometryCache);
+
+  // Description:
+  // Optional tracer for the frame and channel phases.  Set by
+  // vtkMultiChannelRenderWindowHelper.
+  void SetTracer(vtkMultiChannelTracer*);
+  vtkGetObjectMacro(Tracer,vtkMultiChannelTracer);
+
+protected:
+  vtkOpenGLMultiChannelRenderer();
+  ~vtkOpenGLMultiChannelRenderer();
+
+  int InFrame;
+  int ClearOncePerFrame;
+  int FrameCleared;
+
+  double FrameStartTime;
+
+  // Visible props for the frame.  PropArray is refilled from this for
+  // each channel, as culling reorders and shortens it.
+  vtkProp** FrameProps;
+  int FramePropCount;
+
+  vtkMultiChannelGeometryCache* GeometryCache;
+
+  vtkMultiChannelTracer* Tracer;
+
+  vtkRenderPassCollection* SharedPasses;
+  int DetectSharedPasses;
+  int NumberOfSharedPassesRun;
+  double SharedPassTime;
+
+  // Occlusion culler found among the cullers for the current frame
+  vtkMultiChannelOcclusionCuller* OcclusionCuller;
+
+  vtkOpenGLMultiChannelRendererInternals* Internals;
+
+  void ClearFrame();
+
+  // Description:
+  // Find the shared passes in the renderer's pass, and take them out of
+  // its sequences until RestoreSharedPasses()
+  void FindSharedPasses(vtkRenderPass*);
+  void RestoreSharedPasses();
+
+  // Description:
+  // Whether a switched-on camera light casts shadows in the given baker
+  int HasCameraShadowLight(vtkShadowMapBakerPass*);
+
+  // Description:
+  // Run the shared passes for the given props
+  void RenderSharedPasses(vtkProp** props, int numProps);
+
+private:
+  vtkOpenGLMultiChannelRenderer(const vtkOpenGLMultiChannelRenderer&);  // Not implemented.
+  void operator=(const vtkOpenGLMultiChannelRenderer&);  // Not implemented.
+};
+
+#endif
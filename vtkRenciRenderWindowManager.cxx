@@ -17,6 +17,8 @@
 #include "vtkRenciRenderWindowManager.h"
 
 #include "vtkMath.h"
+#include "vtkMultiChannelOfflineRenderer.h"
+#include "vtkMultiChannelRenderWindowHelper.h"
 #include "vtkObjectFactory.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderWindowChannel.h"
@@ -90,18 +92,8 @@ vtkRenderWindow *vtkRenciRenderWindowManager::GetRenciRenderWindow(int argc, cha
 //----------------------------------------------------------------------------
 vtkRenderWindow *vtkRenciRenderWindowManager::GetDomeRenderWindow(double domePitch) 
 {
-  domePitch = domePitch < 10.0 ? 10.0 : domePitch;
-  domePitch = domePitch > 170.0 ? 170.0 : domePitch;
-  domePitch = 90.0 - domePitch;
-
-  // Clear all channels
-  this->ClearChannels();
-
   // Set up dome channels
-  this->AddDomeChannel(0.0, 0.0, 0.5, 0.5, domePitch,   45.0);
-  this->AddDomeChannel(0.5, 0.0, 1.0, 0.5, domePitch,  -45.0);
-  this->AddDomeChannel(0.0, 0.5, 0.5, 1.0, domePitch,  135.0);
-  this->AddDomeChannel(0.5, 0.5, 1.0, 1.0, domePitch, -135.0);
+  this->SetDomeChannels(domePitch);
 
   // Get a window
   vtkRenderWindow* window = this->GetRenderWindow();
@@ -112,8 +104,83 @@ vtkRenderWindow *vtkRenciRenderWindowManager::GetDomeRenderWindow(double domePit
   return window;
 }
 
+//----------------------------------------------------------------------------
+bool vtkRenciRenderWindowManager::UpdateDomeRenderWindow(vtkRenderWindow* window, 
+                                                         double domePitch) 
+{
+  // Set up dome channels
+  this->SetDomeChannels(domePitch);
+
+  // Replace the window's channels
+  if (!this->SwapChannels(window))
+    {
+    return false;
+    }
+
+  // Set up window for Dome
+  this->PositionWindow(window, 1400 * 2, 1050 * 2);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkRenciRenderWindowManager::RenderDomeMaster(vtkMultiChannelOfflineRenderer* offline, 
+                                                  double domePitch) 
+{
+  // Set up dome channels
+  this->SetDomeChannels(domePitch);
+
+  // Default to the size of the dome window
+  int* size = offline->GetSize();
+  if (size[0] <= 0 || size[1] <= 0)
+    {
+    offline->SetSize(1400 * 2, 1050 * 2);
+    }
+
+  offline->SetChannels(this->Helper->GetChannels());
+  int result = offline->Render();
+  offline->SetChannels(NULL);
+
+  this->ClearChannels();
+
+  return result;
+}
+
 //----------------------------------------------------------------------------
 vtkRenderWindow *vtkRenciRenderWindowManager::GetTeleImmersionHDRenderWindow() 
+{
+  // Set up channels
+  this->SetTeleImmersionHDChannels();
+
+  // Get a window
+  vtkRenderWindow* window = this->GetRenderWindow();
+
+  // Set up window for TeleImmersion
+  this->PositionWindow(window, 1920 * 3, 1080);
+
+  return window;
+}
+
+//----------------------------------------------------------------------------
+bool vtkRenciRenderWindowManager::UpdateTeleImmersionHDRenderWindow(vtkRenderWindow* window) 
+{
+  // Set up channels
+  this->SetTeleImmersionHDChannels();
+
+  // Replace the window's channels
+  if (!this->SwapChannels(window))
+    {
+    return false;
+    }
+
+  // Set up window for TeleImmersion
+  this->PositionWindow(window, 1920 * 3, 1080);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciRenderWindowManager::SetTeleImmersionHDChannels() 
 {
   // Clear all channels
   this->ClearChannels();
@@ -133,18 +200,43 @@ vtkRenderWindow *vtkRenciRenderWindowManager::GetTeleImmersionHDRenderWindow()
   channel2->SetStereoTypeToRight();
   this->AddChannel(channel2);
   channel2->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkRenderWindow *vtkRenciRenderWindowManager::GetTeleImmersion4KRenderWindow() 
+{
+  // Set up channels
+  this->SetTeleImmersion4KChannels();
 
   // Get a window
   vtkRenderWindow* window = this->GetRenderWindow();
 
   // Set up window for TeleImmersion
-  this->PositionWindow(window, 1920 * 3, 1080);
+  this->PositionWindow(window, 1920 * 4, 1080 * 2);
 
   return window;
 }
 
 //----------------------------------------------------------------------------
-vtkRenderWindow *vtkRenciRenderWindowManager::GetTeleImmersion4KRenderWindow() 
+bool vtkRenciRenderWindowManager::UpdateTeleImmersion4KRenderWindow(vtkRenderWindow* window) 
+{
+  // Set up channels
+  this->SetTeleImmersion4KChannels();
+
+  // Replace the window's channels
+  if (!this->SwapChannels(window))
+    {
+    return false;
+    }
+
+  // Set up window for TeleImmersion
+  this->PositionWindow(window, 1920 * 4, 1080 * 2);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciRenderWindowManager::SetTeleImmersion4KChannels() 
 {
   // Clear all channels
   this->ClearChannels();
@@ -161,18 +253,43 @@ vtkRenderWindow *vtkRenciRenderWindowManager::GetTeleImmersion4KRenderWindow()
   channel2->SetStereoTypeToRight();
   this->AddChannel(channel2);
   channel2->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkRenderWindow *vtkRenciRenderWindowManager::GetUncHmdRenderWindow() 
+{
+  // Set up channels
+  this->SetUncHmdChannels();
 
   // Get a window
   vtkRenderWindow* window = this->GetRenderWindow();
 
-  // Set up window for TeleImmersion
-  this->PositionWindow(window, 1920 * 4, 1080 * 2);
+  // Set up window for the HMD
+  this->PositionWindow(window, 1280 * 2, 1024);
 
   return window;
 }
 
 //----------------------------------------------------------------------------
-vtkRenderWindow *vtkRenciRenderWindowManager::GetUncHmdRenderWindow() 
+bool vtkRenciRenderWindowManager::UpdateUncHmdRenderWindow(vtkRenderWindow* window) 
+{
+  // Set up channels
+  this->SetUncHmdChannels();
+
+  // Replace the window's channels
+  if (!this->SwapChannels(window))
+    {
+    return false;
+    }
+
+  // Set up window for the HMD
+  this->PositionWindow(window, 1280 * 2, 1024);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenciRenderWindowManager::SetUncHmdChannels() 
 {
   // Clear all channels
   this->ClearChannels();
@@ -189,14 +306,23 @@ vtkRenderWindow *vtkRenciRenderWindowManager::GetUncHmdRenderWindow()
   channel2->SetStereoTypeToRight();
   this->AddChannel(channel2);
   channel2->Delete();
+}
 
-  // Get a window
-  vtkRenderWindow* window = this->GetRenderWindow();
+//----------------------------------------------------------------------------
+void vtkRenciRenderWindowManager::SetDomeChannels(double domePitch)
+{  
+  domePitch = domePitch < 10.0 ? 10.0 : domePitch;
+  domePitch = domePitch > 170.0 ? 170.0 : domePitch;
+  domePitch = 90.0 - domePitch;
 
-  // Set up window for the HMD
-  this->PositionWindow(window, 1280 * 2, 1024);
+  // Clear all channels
+  this->ClearChannels();
 
-  return window;
+  // Set up dome channels
+  this->AddDomeChannel(0.0, 0.0, 0.5, 0.5, domePitch,   45.0);
+  this->AddDomeChannel(0.5, 0.0, 1.0, 0.5, domePitch,  -45.0);
+  this->AddDomeChannel(0.0, 0.5, 0.5, 1.0, domePitch,  135.0);
+  this->AddDomeChannel(0.5, 0.5, 1.0, 1.0, domePitch, -135.0);
 }
 
 //----------------------------------------------------------------------------
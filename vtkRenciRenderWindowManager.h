@@ -32,6 +32,8 @@
 
 #include "vtkMultiChannelRenderWindowManager.h"
 
+class vtkMultiChannelOfflineRenderer;
+
 class VTK_MULTICHANNEL_EXPORT vtkRenciRenderWindowManager : public vtkMultiChannelRenderWindowManager
 {
 public:
@@ -52,6 +54,13 @@ public:
   // Window for the 4-channel immersive dome
   vtkRenderWindow *GetDomeRenderWindow(double domePitch = 90.0);
 
+  // Description:
+  // Render the 4-channel dome image offline with the given offline
+  // renderer, which must have its renderer and file name set.  If its
+  // size is not set, the size of the dome window is used.  Returns 1 on
+  // success.
+  int RenderDomeMaster(vtkMultiChannelOfflineRenderer*, double domePitch = 90.0);
+
   // Description:
   // Window for 2-channel HD stereo mode in the TeleImmersion room
   vtkRenderWindow *GetTeleImmersionHDRenderWindow();
@@ -61,13 +70,30 @@ public:
   vtkRenderWindow *GetTeleImmersion4KRenderWindow();
 
   // Description:
-  // Window for 2-channel head-mounted display at UNC Computer Science
+  // Window for 2-channel head-mounted display at UNC Computer Science.
+  // Set a vtkMultiChannelReprojector on its helper to keep the display
+  // following the head when a frame is late.
   vtkRenderWindow *GetUncHmdRenderWindow();
 
+  // Description:
+  // Switch a window returned by one of the methods above to a preset, or
+  // change the dome pitch, starting with the next frame.  The window and
+  // its context are kept, so nothing is uploaded again.  Returns false
+  // if the window is not a multi-channel window.
+  bool UpdateDomeRenderWindow(vtkRenderWindow*, double domePitch = 90.0);
+  bool UpdateTeleImmersionHDRenderWindow(vtkRenderWindow*);
+  bool UpdateTeleImmersion4KRenderWindow(vtkRenderWindow*);
+  bool UpdateUncHmdRenderWindow(vtkRenderWindow*);
+
 protected:
   vtkRenciRenderWindowManager();
   ~vtkRenciRenderWindowManager();
 
+  void SetDomeChannels(double domePitch);
+  void SetTeleImmersionHDChannels();
+  void SetTeleImmersion4KChannels();
+  void SetUncHmdChannels();
+
   void AddDomeChannel(double x1, double y1, double x2, double y2, 
                       double domePitch, double yaw);
 
@@ -16,8 +16,10 @@
 
 #include "vtkRenderWindowChannel.h"
 
+#include "vtkCamera.h"
 #include "vtkDoubleArray.h"
 #include "vtkIntArray.h"
+#include "vtkMath.h"
 #include "vtkOpenGLMultiChannelCamera.h"
 #include "vtkMatrix4x4.h"
 #include "vtkObjectFactory.h"
@@ -44,6 +46,26 @@ vtkRenderWindowChannel::vtkRenderWindowChannel()
 
   this->AspectRatio = 1;
   this->UseAspectRatio = false;
+
+  this->TileRegion[0] = this->TileRegion[1] = 0;
+  this->TileRegion[2] = this->TileRegion[3] = 1;
+  this->TileViewport[0] = this->TileViewport[1] = 0;
+  this->TileViewport[2] = this->TileViewport[3] = 1;
+  this->TileAspectRatio = 1;
+  this->UseTile = false;
+
+  this->Jitter[0] = this->Jitter[1] = 0.0;
+
+  this->SavedViewport[0] = this->SavedViewport[1] = 0;
+  this->SavedViewport[2] = this->SavedViewport[3] = 1;
+  this->SavedFocalPoint[0] = this->SavedFocalPoint[1] = this->SavedFocalPoint[2] = 0;
+  this->SavedViewUp[0] = this->SavedViewUp[2] = 0;
+  this->SavedViewUp[1] = 1;
+  this->SavedUseHorizontalViewAngle = 0;
+  this->SavedViewAngle = 30;
+  this->SavedUseAspectRatio = 0;
+  this->SavedAspectRatio = 1;
+  this->SavedWindowCenter[0] = this->SavedWindowCenter[1] = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -53,6 +75,20 @@ vtkRenderWindowChannel::~vtkRenderWindowChannel()
   this->RotationTypes->Delete();
 }
 
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::GetPixelRegion(const int windowSize[2], int region[4])
+{
+  int x1 = static_cast<int>(this->Viewport[0] * windowSize[0] + 0.5);
+  int y1 = static_cast<int>(this->Viewport[1] * windowSize[1] + 0.5);
+  int x2 = static_cast<int>(this->Viewport[2] * windowSize[0] + 0.5);
+  int y2 = static_cast<int>(this->Viewport[3] * windowSize[1] + 0.5);
+
+  region[0] = x1;
+  region[1] = y1;
+  region[2] = x2 - x1;
+  region[3] = y2 - y1;
+}
+
 //----------------------------------------------------------------------------
 void vtkRenderWindowChannel::SetStereoTypeToNone() 
 {
@@ -99,6 +135,13 @@ void vtkRenderWindowChannel::OrthogonalizeViewUp()
   this->RotationTypes->InsertNextValue(VTK_MULTICHANNEL_ORTHOGONALIZE_VIEW_UP);
 }
 
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::ClearRotations()
+{
+  this->Rotations->Reset();
+  this->RotationTypes->Reset();
+}
+
 //----------------------------------------------------------------------------
 void vtkRenderWindowChannel::SetViewAngle(double fov)
 {
@@ -114,19 +157,115 @@ void vtkRenderWindowChannel::SetAspectRatio(double ratio)
 }
 
 //----------------------------------------------------------------------------
-void vtkRenderWindowChannel::Render(vtkRenderer* renderer)
+void vtkRenderWindowChannel::SetTile(const double region[4], const double viewport[4], double aspect)
 {
-  double x = this->Viewport[0];
-  double y = this->Viewport[1];
-  double w = this->Viewport[2] - this->Viewport[0];
-  double h = this->Viewport[3] - this->Viewport[1];
+  for (int i = 0; i < 4; i++)
+    {
+    this->TileRegion[i] = region[i];
+    this->TileViewport[i] = viewport[i];
+    }
+  this->TileAspectRatio = aspect;
+  this->UseTile = true;
+}
 
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::ClearTile()
+{
+  this->UseTile = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::SetJitter(double x, double y)
+{
+  this->Jitter[0] = x;
+  this->Jitter[1] = y;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::Render(vtkRenderer* renderer)
+{
 #if defined(VTK_USE_MANGLED_MESA)
   vtkErrorMacro(<< "Multi-channel not implemented for this rendering library yet.");
   return;
 #else
-  vtkOpenGLMultiChannelCamera *camera = vtkOpenGLMultiChannelCamera::SafeDownCast(renderer->GetActiveCamera());
+  this->ApplyView(renderer);
+
+  // Render
+  renderer->ResetCameraClippingRange();
+  renderer->Render();
+
+  this->RestoreView(renderer);
+
+  renderer->ResetCameraClippingRange();
 #endif
+}
+
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::GetFrustumPlanes(vtkRenderer* renderer, double planes[24])
+{
+  this->ApplyView(renderer);
+
+  renderer->GetActiveCamera()->GetFrustumPlanes(this->GetViewAspect(renderer), planes);
+
+  this->RestoreView(renderer);
+}
+
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::GetViewMatrices(vtkRenderer* renderer, 
+                                             vtkMatrix4x4* view, 
+                                             vtkMatrix4x4* projection)
+{
+  this->ApplyView(renderer);
+
+  vtkCamera *camera = renderer->GetActiveCamera();
+  view->DeepCopy(camera->GetViewTransformMatrix());
+  projection->DeepCopy(camera->GetProjectionTransformMatrix(this->GetViewAspect(renderer), -1, 1));
+
+  this->RestoreView(renderer);
+}
+
+//----------------------------------------------------------------------------
+double vtkRenderWindowChannel::GetViewAspect(vtkRenderer* renderer)
+{
+  vtkOpenGLMultiChannelCamera *camera = vtkOpenGLMultiChannelCamera::SafeDownCast(renderer->GetActiveCamera());
+
+  if (camera && camera->GetUseAspectRatio())
+    {
+    return camera->GetAspectRatio();
+    }
+
+  int width, height, x, y;
+  renderer->GetTiledSizeAndOrigin(&width, &height, &x, &y);
+  if (width > 0 && height > 0)
+    {
+    return static_cast<double>(width) / height;
+    }
+
+  return 1.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::ApplyView(vtkRenderer* renderer)
+{
+  // A tile is drawn into its own part of the window
+  const double* viewport = this->UseTile ? this->TileViewport : this->Viewport;
+
+  double x = viewport[0];
+  double y = viewport[1];
+  double w = viewport[2] - viewport[0];
+  double h = viewport[3] - viewport[1];
+
+  // Set the viewport
+  double* vp = this->SavedViewport;
+  renderer->GetViewport(vp);
+  renderer->SetViewport(vp[0] * w + x, vp[1] * h + y, vp[2] * w + x, vp[3] * h + y);
+
+  // Only the viewport is set for other cameras
+  vtkOpenGLMultiChannelCamera *camera = vtkOpenGLMultiChannelCamera::SafeDownCast(renderer->GetActiveCamera());
+  if (!camera)
+    {
+    return;
+    }
 
   // Set up stereo
   if (this->StereoType == VTK_MULTICHANNEL_STEREO_RIGHT)
@@ -138,17 +277,9 @@ void vtkRenderWindowChannel::Render(vtkRenderer* renderer)
     camera->SetLeftEye(1);
     }
 
-  // Set the viewport
-  double vp[4];
-  renderer->GetViewport(vp);
-  renderer->SetViewport(vp[0] * w + x, vp[1] * h + y, vp[2] * w + x, vp[3] * h + y);
-
   // Save the current camera settings
-  double focalPoint[3];
-  camera->GetFocalPoint(focalPoint);
-
-  double viewUp[3];
-  camera->GetViewUp(viewUp);
+  camera->GetFocalPoint(this->SavedFocalPoint);
+  camera->GetViewUp(this->SavedViewUp);
 
   // Rotate
   for (int i = 0; i < this->Rotations->GetNumberOfTuples(); i++)
@@ -174,8 +305,8 @@ void vtkRenderWindowChannel::Render(vtkRenderer* renderer)
     }
 
   // Field of view
-  int useHorizontalViewAngle = camera->GetUseHorizontalViewAngle();
-  double viewAngle = camera->GetViewAngle();
+  this->SavedUseHorizontalViewAngle = camera->GetUseHorizontalViewAngle();
+  this->SavedViewAngle = camera->GetViewAngle();
   if (this->UseViewAngle)
     {
     camera->UseHorizontalViewAngleOff();
@@ -183,26 +314,70 @@ void vtkRenderWindowChannel::Render(vtkRenderer* renderer)
     }
 
   // Aspect ratio
+  this->SavedUseAspectRatio = camera->GetUseAspectRatio();
+  this->SavedAspectRatio = camera->GetAspectRatio();
   if (this->UseAspectRatio)
     {
     camera->UseAspectRatioOn();
     camera->SetAspectRatio(this->AspectRatio);
     }
 
-  // Render
-  renderer->ResetCameraClippingRange();
-  renderer->Render();
+  // Narrow the view to the tile and center it on the tile
+  double* windowCenter = this->SavedWindowCenter;
+  camera->GetWindowCenter(windowCenter);
+  if (this->UseTile)
+    {
+    double fx = this->TileRegion[2] - this->TileRegion[0];
+    double fy = this->TileRegion[3] - this->TileRegion[1];
 
-  // Restore settings
-  renderer->SetViewport(vp);
+    double f = camera->GetUseHorizontalViewAngle() ? fx : fy;
+    double halfAngle = vtkMath::RadiansFromDegrees(camera->GetViewAngle()) / 2.0;
+    camera->SetViewAngle(2.0 * vtkMath::DegreesFromRadians(atan(tan(halfAngle) * f)));
 
-  camera->SetFocalPoint(focalPoint);
-  camera->SetViewUp(viewUp);
+    double aspect = camera->GetUseAspectRatio() ? camera->GetAspectRatio() : this->TileAspectRatio;
+    camera->UseAspectRatioOn();
+    camera->SetAspectRatio(aspect * fx / fy);
 
-  camera->SetUseHorizontalViewAngle(useHorizontalViewAngle);
-  camera->SetViewAngle(viewAngle);
+    camera->SetWindowCenter(
+      (windowCenter[0] + this->TileRegion[0] + this->TileRegion[2] - 1.0) / fx,
+      (windowCenter[1] + this->TileRegion[1] + this->TileRegion[3] - 1.0) / fy);
+    }
 
-  renderer->ResetCameraClippingRange();
+  // Window center is in normalized viewport coordinates, 2 across
+  if (this->Jitter[0] != 0.0 || this->Jitter[1] != 0.0)
+    {
+    int* size = renderer->GetSize();
+    if (size[0] > 0 && size[1] > 0)
+      {
+      double center[2];
+      camera->GetWindowCenter(center);
+      camera->SetWindowCenter(center[0] - 2.0 * this->Jitter[0] / size[0],
+                              center[1] - 2.0 * this->Jitter[1] / size[1]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkRenderWindowChannel::RestoreView(vtkRenderer* renderer)
+{
+  renderer->SetViewport(this->SavedViewport);
+
+  vtkOpenGLMultiChannelCamera *camera = vtkOpenGLMultiChannelCamera::SafeDownCast(renderer->GetActiveCamera());
+  if (!camera)
+    {
+    return;
+    }
+
+  camera->SetFocalPoint(this->SavedFocalPoint);
+  camera->SetViewUp(this->SavedViewUp);
+
+  camera->SetUseHorizontalViewAngle(this->SavedUseHorizontalViewAngle);
+  camera->SetViewAngle(this->SavedViewAngle);
+
+  camera->SetUseAspectRatio(this->SavedUseAspectRatio);
+  camera->SetAspectRatio(this->SavedAspectRatio);
+
+  camera->SetWindowCenter(this->SavedWindowCenter[0], this->SavedWindowCenter[1]);
 }
 
 //----------------------------------------------------------------------------
@@ -241,4 +416,6 @@ void vtkRenderWindowChannel::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "View Angle: " << this->ViewAngle << "\n";
   os << indent << "Use View Angle: " << this->UseViewAngle << "\n";
+  os << indent << "Use Tile: " << this->UseTile << "\n";
+  os << indent << "Jitter: (" << this->Jitter[0] << ", " << this->Jitter[1] << ")\n";
 }
\ No newline at end of file
@@ -31,6 +31,7 @@
 
 class vtkDoubleArray;
 class vtkIntArray;
+class vtkMatrix4x4;
 class vtkRenderer;
 
 // Stereo types
@@ -56,6 +57,12 @@ public:
   // Coordinates are expressed as (xmin,ymin,xmax,ymax), where each
   // coordinate is 0 <= coordinate <= 1.0.
   vtkSetVector4Macro(Viewport,double); 
+  vtkGetVector4Macro(Viewport,double);
+
+  // Description:
+  // Get the pixels covered by the viewport in a window of the given
+  // size, as (x,y,width,height)
+  void GetPixelRegion(const int windowSize[2], int region[4]);
 
   // Description:
   // Set the stereo type for this channel
@@ -71,6 +78,7 @@ public:
   void Pitch(double);
   void Roll(double);
   void OrthogonalizeViewUp();
+  void ClearRotations();
 
   // Description:
   // Set the vertical field of view for this channel
@@ -80,10 +88,35 @@ public:
   // Set the aspect ratio for this channel
   void SetAspectRatio(double);
 
+  // Description:
+  // Render only the part of this channel's view given by region, in 
+  // normalized channel coordinates (xmin,ymin,xmax,ymax), into the given
+  // window viewport rather than the channel's viewport.  aspect is the
+  // aspect ratio of the whole channel, used if no aspect ratio is set.
+  // Used for tiled offline rendering.
+  void SetTile(const double region[4], const double viewport[4], double aspect);
+  void ClearTile();
+
+  // Description:
+  // Shift this channel's view by the given fraction of a pixel, for
+  // jittered accumulation.  Does not modify the channel.
+  void SetJitter(double x, double y);
+  vtkGetVector2Macro(Jitter,double);
+
   // Description:
   // Render this channel using the given renderer
   void Render(vtkRenderer*);
 
+  // Description:
+  // Get the planes of this channel's view frustum with the given
+  // renderer's camera, as for vtkCamera::GetFrustumPlanes()
+  void GetFrustumPlanes(vtkRenderer*, double planes[24]);
+
+  // Description:
+  // Get this channel's view and projection transforms with the given
+  // renderer's camera
+  void GetViewMatrices(vtkRenderer*, vtkMatrix4x4* view, vtkMatrix4x4* projection);
+
 protected:
   vtkRenderWindowChannel();
   ~vtkRenderWindowChannel();
@@ -101,6 +134,34 @@ protected:
   double AspectRatio;
   bool UseAspectRatio;
 
+  double TileRegion[4];
+  double TileViewport[4];
+  double TileAspectRatio;
+  bool UseTile;
+
+  double Jitter[2];
+
+  // Renderer and camera settings saved by ApplyView()
+  double SavedViewport[4];
+  double SavedFocalPoint[3];
+  double SavedViewUp[3];
+  int SavedUseHorizontalViewAngle;
+  double SavedViewAngle;
+  int SavedUseAspectRatio;
+  double SavedAspectRatio;
+  double SavedWindowCenter[2];
+
+  // Description:
+  // Set the renderer's viewport and camera up for this channel, and
+  // put them back.  Only the viewport is set if the camera is not a
+  // vtkOpenGLMultiChannelCamera.
+  void ApplyView(vtkRenderer*);
+  void RestoreView(vtkRenderer*);
+
+  // Description:
+  // Aspect ratio of the view set up by ApplyView()
+  double GetViewAspect(vtkRenderer*);
+
   // Description:
   // For use in PrintSelf()
   const char *GetStereoTypeAsString();
@@ -17,19 +17,38 @@
 #include "vtkWin32OpenGLMultiChannelRenderWindow.h"
 
 #include "vtkCamera.h"
+#include "vtkMultiChannelFramePacer.h"
 #include "vtkMultiChannelRenderWindowHelper.h"
+#include "vtkMultiChannelReprojector.h"
+#include "vtkMultiChannelTracer.h"
 #include "vtkObjectFactory.h"
+#include "vtkOpenGL.h"
 #include "vtkRendererCollection.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkCxxRevisionMacro(vtkWin32OpenGLMultiChannelRenderWindow, "$Revision: 1.0 $");
 vtkStandardNewMacro(vtkWin32OpenGLMultiChannelRenderWindow);
 
 vtkCxxSetObjectMacro(vtkWin32OpenGLMultiChannelRenderWindow, Helper, vtkMultiChannelRenderWindowHelper);
 
+//----------------------------------------------------------------------------
+class vtkWin32OpenGLMultiChannelRenderWindowInternals
+{
+public:
+  // Not referenced, as they reference this window.  Each removes itself
+  // when it is deleted or leaves the family.
+  std::vector<vtkWin32OpenGLMultiChannelRenderWindow*> SharedWindows;
+};
+
 //----------------------------------------------------------------------------
 vtkWin32OpenGLMultiChannelRenderWindow::vtkWin32OpenGLMultiChannelRenderWindow() 
 {
   this->Helper = NULL;
+  this->SharedContextWindow = NULL;
+
+  this->Internals = new vtkWin32OpenGLMultiChannelRenderWindowInternals;
 }
 
 //----------------------------------------------------------------------------
@@ -39,11 +58,214 @@ vtkWin32OpenGLMultiChannelRenderWindow::~vtkWin32OpenGLMultiChannelRenderWindow(
     {
     this->Helper->UnRegister(this);
     }
+  this->SetSharedContextWindow(NULL);
+
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkWin32OpenGLMultiChannelRenderWindow::SetSharedContextWindow(vtkWin32OpenGLMultiChannelRenderWindow* window)
+{
+  if (window == this)
+    {
+    window = NULL;
+    }
+  if (this->SharedContextWindow == window)
+    {
+    return;
+    }
+
+  if (this->SharedContextWindow)
+    {
+    std::vector<vtkWin32OpenGLMultiChannelRenderWindow*>& windows = 
+      this->SharedContextWindow->Internals->SharedWindows;
+    windows.erase(std::remove(windows.begin(), windows.end(), this), windows.end());
+    this->SharedContextWindow->UnRegister(this);
+    }
+
+  this->SharedContextWindow = window;
+
+  if (this->SharedContextWindow)
+    {
+    this->SharedContextWindow->Register(this);
+    this->SharedContextWindow->Internals->SharedWindows.push_back(this);
+    }
+
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkWin32OpenGLMultiChannelRenderWindow::AddRenderer(vtkRenderer* renderer)
+{
+  if (this->SharedContextWindow)
+    {
+    this->SharedContextWindow->AddRenderer(renderer);
+    return;
+    }
+
+  this->Superclass::AddRenderer(renderer);
+}
+
+//----------------------------------------------------------------------------
+void vtkWin32OpenGLMultiChannelRenderWindow::RemoveRenderer(vtkRenderer* renderer)
+{
+  if (this->SharedContextWindow)
+    {
+    this->SharedContextWindow->RemoveRenderer(renderer);
+    return;
+    }
+
+  this->Superclass::RemoveRenderer(renderer);
+}
+
+//----------------------------------------------------------------------------
+vtkMultiChannelGLStateCache* vtkWin32OpenGLMultiChannelRenderWindow::GetGLStateCache()
+{
+  return this->Helper ? this->Helper->GetGLStateCache() : NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkWin32OpenGLMultiChannelRenderWindow::Render()
+{
+  // The family is drawn by the window it shares
+  if (this->SharedContextWindow)
+    {
+    this->SharedContextWindow->Render();
+    return;
+    }
+
+  if (this->Helper && this->Helper->DeferRender())
+    {
+    return;
+    }
+
+  this->Superclass::Render();
+
+  for (unsigned int i = 0; i < this->Internals->SharedWindows.size(); i++)
+    {
+    this->RenderSharedWindow(this->Internals->SharedWindows[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkWin32OpenGLMultiChannelRenderWindow::RenderSharedWindow(vtkWin32OpenGLMultiChannelRenderWindow* window)
+{
+  if (!window->Helper || !this->ContextId)
+    {
+    return;
+    }
+
+  if (!window->ContextId)
+    {
+    window->Initialize();
+    }
+
+  // The context can only draw onto surfaces of its own pixel format
+  if (!window->DeviceContext ||
+      GetPixelFormat(window->DeviceContext) != GetPixelFormat(this->DeviceContext))
+    {
+    vtkErrorMacro(<< "Window " << window << " has a different pixel format.  Not drawing it.");
+    return;
+    }
+
+  // Stand in for the window, so that the renderers, and the mappers and
+  // textures they draw, only ever see this one
+  HWND windowId = this->WindowId;
+  HDC deviceContext = this->DeviceContext;
+  int size[2] = { this->Size[0], this->Size[1] };
+  int stereoRender = this->StereoRender;
+  vtkMultiChannelRenderWindowHelper* helper = this->Helper;
+
+  int* windowSize = window->GetSize();
+  this->Size[0] = windowSize[0];
+  this->Size[1] = windowSize[1];
+  this->WindowId = window->WindowId;
+  this->DeviceContext = window->DeviceContext;
+  this->StereoRender = window->StereoRender;
+  this->Helper = window->Helper;
+
+  if (wglMakeCurrent(this->DeviceContext, this->ContextId))
+    {
+    this->Superclass::Render();
+    }
+  else
+    {
+    vtkErrorMacro(<< "Could not draw window " << window << " with the shared context.");
+    }
+
+  // Swapped channels may have changed the stereo setting
+  window->StereoRender = this->StereoRender;
+
+  this->WindowId = windowId;
+  this->DeviceContext = deviceContext;
+  this->Size[0] = size[0];
+  this->Size[1] = size[1];
+  this->StereoRender = stereoRender;
+  this->Helper = helper;
+
+  wglMakeCurrent(this->DeviceContext, this->ContextId);
+}
+
+//----------------------------------------------------------------------------
+void vtkWin32OpenGLMultiChannelRenderWindow::Frame()
+{
+  vtkMultiChannelTracer* tracer = this->Helper ? this->Helper->GetTracer() : NULL;
+  vtkMultiChannelFramePacer* pacer = this->Helper ? this->Helper->GetFramePacer() : NULL;
+  vtkMultiChannelReprojector* reprojector = this->Helper ? this->Helper->GetReprojector() : NULL;
+
+  bool pacing = pacer && pacer->GetEnabled();
+  bool reprojecting = reprojector && reprojector->GetRunning();
+
+  // When pacing, time the frame as drawn, not as submitted
+  if (pacer)
+    {
+    if (pacing)
+      {
+      glFinish();
+      }
+    pacer->EndRender();
+    }
+
+  if (reprojecting)
+    {
+    reprojector->FrameReady();
+    }
+
+  if (tracer)
+    {
+    tracer->Begin("Swap");
+    }
+
+  this->Superclass::Frame();
+
+  if (tracer)
+    {
+    tracer->End("Swap");
+    }
+
+  // Time the swap as shown, not as queued
+  if (pacing || reprojecting)
+    {
+    glFinish();
+    }
+
+  if (pacer)
+    {
+    pacer->FrameSwapped();
+    }
+
+  if (reprojecting)
+    {
+    reprojector->FrameSwapped();
+    }
 }
 
 //----------------------------------------------------------------------------
 void vtkWin32OpenGLMultiChannelRenderWindow::DoStereoRender()
 {
+  // Channels swapped in since the last frame
+  this->Helper->ApplyPendingChannels(this);
+
   if (this->Helper->GetChannels()->GetNumberOfItems() == 0) 
     {
     // Default rendering
@@ -56,6 +278,28 @@ void vtkWin32OpenGLMultiChannelRenderWindow::DoStereoRender()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkWin32OpenGLMultiChannelRenderWindow::WindowInitialize()
+{
+  this->Superclass::WindowInitialize();
+
+  if (!this->SharedContextWindow || this->SharedContextWindow == this || 
+      !this->ContextId)
+    {
+    return;
+    }
+
+  // The new context has no objects yet, so it can still join the group
+  if (!this->SharedContextWindow->ContextId)
+    {
+    vtkWarningMacro(<<"Shared context window is not initialized, not sharing context.");
+    }
+  else if (!wglShareLists(this->SharedContextWindow->ContextId, this->ContextId))
+    {
+    vtkWarningMacro(<<"wglShareLists failed, not sharing context.");
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkWin32OpenGLMultiChannelRenderWindow::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -66,4 +310,7 @@ void vtkWin32OpenGLMultiChannelRenderWindow::PrintSelf(ostream& os, vtkIndent in
     os << indent << "Helper:\n"; 
     this->Helper->PrintSelf(os,indent.GetNextIndent());
     } 
+
+  os << indent << "SharedContextWindow: " << this->SharedContextWindow << "\n";
+  os << indent << "Number Of Shared Windows: " << this->Internals->SharedWindows.size() << "\n";
 }
\ No newline at end of file
@@ -17,7 +17,23 @@
 // .SECTION Description
 // vtkWin32OpenGLMultiChannelRenderWindow is a subclass of 
 // vtkWin32OpenGLRenderWindow that adds multi-channel rendering
-// support via a vtkMultiChannelRenderWindowHelper
+// support via a vtkMultiChannelRenderWindowHelper.
+//
+// Windows can form a family around a shared context window, for
+// installations that drive projectors from separate windows.  A window
+// with a shared context window set holds no renderers of its own:
+// renderers added to it are added to the shared context window.
+// Rendering any window of the family renders the shared context
+// window, which then draws each other window of the family through that
+// window's own channels, with its own context, renderers, and surface.
+// VTK's mappers and textures release and rebuild their objects whenever
+// they are drawn in another window.  All of the family's drawing is
+// done by one window, so the scene is uploaded once for the family.
+//
+// The windows of a family must have the same pixel format, so the same
+// stereo capability.  Render scheduling, render threads, and the
+// interactor are those of the shared context window.  Its start and end
+// events are invoked once for each window drawn.
 
 // .SECTION see also
 // vtkMultiChannelRenderWindowManager vtkMultiChannelRenderWindowHelper
@@ -29,7 +45,9 @@
 
 #include "vtkWin32OpenGLRenderWindow.h"
 
+class vtkMultiChannelGLStateCache;
 class vtkMultiChannelRenderWindowHelper;
+class vtkWin32OpenGLMultiChannelRenderWindowInternals;
 
 class VTK_MULTICHANNEL_EXPORT vtkWin32OpenGLMultiChannelRenderWindow : public vtkWin32OpenGLRenderWindow
 {
@@ -41,17 +59,60 @@ public:
   // Description:
   // Holds channel information and sets up rendering for each channel
   void SetHelper(vtkMultiChannelRenderWindowHelper*);
+  vtkGetObjectMacro(Helper,vtkMultiChannelRenderWindowHelper);
+
+  // Description:
+  // Window whose context and renderers draw this window.  Must be set
+  // before renderers are added.  The context of this window, used only
+  // outside the family's rendering, joins the share group of that
+  // window's context if that one is initialized first.
+  void SetSharedContextWindow(vtkWin32OpenGLMultiChannelRenderWindow*);
+  vtkGetObjectMacro(SharedContextWindow,vtkWin32OpenGLMultiChannelRenderWindow);
+
+  // Description:
+  // Cache of the OpenGL state set by the channels in this window's
+  // context, held by the helper.  NULL without a helper.
+  vtkMultiChannelGLStateCache* GetGLStateCache();
+
+  // Description:
+  // Hands the render to the helper's render thread when one is running.
+  // Renders the shared context window, and the rest of its family, when
+  // one is set.
+  void Render();
+
+  // Description:
+  // Add renderers to the shared context window when one is set
+  void AddRenderer(vtkRenderer*);
+  void RemoveRenderer(vtkRenderer*);
+
+  // Description:
+  // Swap buffers, and report the swap to the helper's tracer, frame
+  // pacer and reprojector
+  void Frame();
 
 protected:
   vtkWin32OpenGLMultiChannelRenderWindow();
   ~vtkWin32OpenGLMultiChannelRenderWindow();
 
   vtkMultiChannelRenderWindowHelper* Helper;
+  vtkWin32OpenGLMultiChannelRenderWindow* SharedContextWindow;
+
+  // Windows that have this window as their shared context window
+  vtkWin32OpenGLMultiChannelRenderWindowInternals* Internals;
 
   // Description:
   // Override the default behavior for multi-channel rendering
   void DoStereoRender();
 
+  // Description:
+  // Share objects with the shared context window's context
+  void WindowInitialize();
+
+  // Description:
+  // Draw a window of the family with this window's context and
+  // renderers, through that window's channels and onto its surface
+  void RenderSharedWindow(vtkWin32OpenGLMultiChannelRenderWindow*);
+
 private:
   vtkWin32OpenGLMultiChannelRenderWindow(const vtkWin32OpenGLMultiChannelRenderWindow&);  // Not implemented.
   void operator=(const vtkWin32OpenGLMultiChannelRenderWindow&);  // Not implemented.